@@ -0,0 +1,104 @@
+#include "ConcurrentSegmentTree.h"
+#include "Stats.h"
+
+/*
+    param[in]: endpoints - sorted interval endpoints, as for SegmentTree
+    param[in]: shardCount - number of independently locked subtrees, rounded up to a power of two
+*/
+ConcurrentSegmentTree::ConcurrentSegmentTree(const vector<uint32_t> &endpoints, uint32_t shardCount) {
+    uint32_t depth = static_cast<uint32_t>(ceil(log2(std::max(shardCount, 1u))));
+    // atomics are not movable, so the node array is sized once here
+    top = vector<TopNode>(static_cast<size_t>(1) << (depth + 1));
+    BuildTop(endpoints, 0, 0, endpoints.size() - 1, depth);
+    shardLocks = vector<std::mutex>(shards.size());
+}
+
+void ConcurrentSegmentTree::BuildTop(const vector<uint32_t> &endpoints, size_t loc, size_t start, size_t end,
+    uint32_t depth) {
+    top[loc].left = endpoints[start];
+    top[loc].right = endpoints[end];
+
+    if (depth > 0 && end > start + 1) {
+        size_t mid = static_cast<size_t>(ceil((end - start) / 2.));
+        BuildTop(endpoints, lchild(loc), start, start + mid, depth - 1);
+        BuildTop(endpoints, rchild(loc), start + mid, end, depth - 1);
+    }
+    else {
+        top[loc].shard = shards.size();
+        shards.push_back(SegmentTree(endpoints.data() + start, endpoints.data() + end + 1));
+    }
+}
+
+uint32_t ConcurrentSegmentTree::Insert(uint32_t x, uint32_t y) {
+    Update(0, x, y, 1);
+    return Measure();
+}
+
+uint32_t ConcurrentSegmentTree::Delete(uint32_t x, uint32_t y) {
+    Update(0, x, y, -1);
+    return Measure();
+}
+
+uint32_t ConcurrentSegmentTree::Measure() {
+    return static_cast<uint32_t>(top[0].state.load());
+}
+
+void ConcurrentSegmentTree::Update(size_t loc, uint32_t x, uint32_t y, int32_t c) {
+    STATS_COUNT("updateNodes", 1);
+    TopNode &node = top[loc];
+
+    if (node.shard != NO_SHARD) {
+        std::lock_guard<std::mutex> lock(shardLocks[node.shard]);
+        uint32_t measure = (c > 0) ? shards[node.shard].Insert(x, y) : shards[node.shard].Delete(x, y);
+        // publish while holding the shard lock so publications happen in update order
+        uint64_t version = (node.state.load() >> 32) + 1;
+        node.state.store((version << 32) | measure);
+        return;
+    }
+
+    if (x == node.left && y == node.right) {
+        node.count += c;
+    }
+    else {
+        uint32_t m = top[lchild(loc)].right;
+        if (x < m && m < y) {
+            Update(lchild(loc), x, m, c);
+            Update(rchild(loc), m, y, c);
+        }
+        else if (y <= m) {
+            Update(lchild(loc), x, y, c);
+        }
+        else if (m <= x) {
+            Update(rchild(loc), x, y, c);
+        }
+    }
+
+    Refresh(loc);
+}
+
+/*
+    Recompute the measure of an internal node from its count and children.
+
+    If our compare-and-swap fails twice, the writer that beat us on the second attempt read
+    the children after our first attempt began, hence after our own update below this node,
+    so the stored measure already reflects it and we can stop.
+*/
+void ConcurrentSegmentTree::Refresh(size_t loc) {
+    TopNode &node = top[loc];
+    for (int attempt = 0; attempt < 2; attempt++) {
+        uint64_t old = node.state.load();
+        uint32_t measure;
+        if (node.count.load() > 0) {
+            measure = node.right - node.left;
+        }
+        else {
+            measure = static_cast<uint32_t>(top[lchild(loc)].state.load()) +
+                static_cast<uint32_t>(top[rchild(loc)].state.load());
+        }
+
+        uint64_t version = (old >> 32) + 1;
+        if (node.state.compare_exchange_strong(old, (version << 32) | measure)) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "SegmentTree.h"
+
+using std::vector;
+
+/*
+    SegmentTree safe for concurrent Insert/Delete from many threads.
+
+    The top levels of the tree are shared and updated without locks: counts are atomic
+    and each node's measure is recomputed with a versioned compare-and-swap. Below a fixed
+    depth the tree is split into independent SegmentTree shards, each behind its own mutex,
+    so writers touching different coordinate ranges do not contend.
+*/
+class ConcurrentSegmentTree {
+
+    class TopNode {
+    public:
+        uint32_t left, right;
+        size_t shard;       // index into shards, or NO_SHARD for internal nodes
+        std::atomic<uint32_t> count;
+        // measure in the low 32 bits, version in the high 32 bits
+        std::atomic<uint64_t> state;
+        TopNode() : left(0), right(0), shard(NO_SHARD), count(0), state(0) {};
+    };
+
+public:
+    static const size_t NO_SHARD = SIZE_MAX;
+
+    uint32_t Insert(uint32_t, uint32_t);
+    uint32_t Delete(uint32_t, uint32_t);
+    uint32_t Measure();
+    ConcurrentSegmentTree(const vector<uint32_t> &, uint32_t);
+private:
+    void Update(size_t, uint32_t, uint32_t, int32_t);
+    void Refresh(size_t);
+    void BuildTop(const vector<uint32_t> &, size_t, size_t, size_t, uint32_t);
+
+    vector<TopNode> top;
+    vector<SegmentTree> shards;
+    vector<std::mutex> shardLocks;
+};
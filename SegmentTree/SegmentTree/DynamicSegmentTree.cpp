@@ -0,0 +1,175 @@
+#include "DynamicSegmentTree.h"
+#include "Stats.h"
+
+// Coordinates are uint32_t, so the root spans [0, 2^32)
+#define UNIVERSE (static_cast<uint64_t>(1) << 32)
+
+/*
+    param[in]: capacity - number of nodes to reserve in the arena up front. Each update
+    allocates at most 2 log U new nodes.
+*/
+DynamicSegmentTree::DynamicSegmentTree(size_t capacity) {
+    arena.reserve(std::max(capacity, static_cast<size_t>(1)));
+    arena.push_back(DynamicSegmentTreeNode());
+}
+
+uint32_t DynamicSegmentTree::Insert(uint32_t x, uint32_t y) {
+    if (x < y) {
+        Update(0, 0, UNIVERSE, x, y, 1);
+    }
+    return arena[0].measure;
+}
+
+uint32_t DynamicSegmentTree::Delete(uint32_t x, uint32_t y) {
+    if (x < y) {
+        Update(0, 0, UNIVERSE, x, y, -1);
+    }
+    return arena[0].measure;
+}
+
+// Returns the left or right child of loc, allocating it if needed
+uint32_t DynamicSegmentTree::Child(uint32_t loc, bool right) {
+    uint32_t child = right ? arena[loc].rightChild : arena[loc].leftChild;
+    if (child == NONE) {
+        child = static_cast<uint32_t>(arena.size());
+        // push_back may reallocate, so index the arena again afterwards
+        arena.push_back(DynamicSegmentTreeNode());
+        if (right) {
+            arena[loc].rightChild = child;
+        }
+        else {
+            arena[loc].leftChild = child;
+        }
+    }
+    return child;
+}
+
+void DynamicSegmentTree::Update(uint32_t loc, uint64_t lo, uint64_t hi, uint32_t x, uint32_t y, int32_t c) {
+    STATS_COUNT("updateNodes", 1);
+    if (x <= lo && hi <= y) {
+        arena[loc].count += c;
+    }
+    else {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (x < mid) {
+            Update(Child(loc, false), lo, mid, x, y, c);
+        }
+        if (mid < y) {
+            Update(Child(loc, true), mid, hi, x, y, c);
+        }
+    }
+
+    DynamicSegmentTreeNode &node = arena[loc];
+    uint32_t lmeasure = 0, rmeasure = 0, lmax = 0, rmax = 0;
+    if (node.leftChild != NONE) {
+        lmeasure = arena[node.leftChild].measure;
+        lmax = arena[node.leftChild].maxCount;
+    }
+    if (node.rightChild != NONE) {
+        rmeasure = arena[node.rightChild].measure;
+        rmax = arena[node.rightChild].maxCount;
+    }
+
+    node.measure = (node.count > 0) ? static_cast<uint32_t>(hi - lo) : lmeasure + rmeasure;
+    node.maxCount = node.count + std::max(lmax, rmax);
+}
+
+uint32_t DynamicSegmentTree::CoveredLength(uint32_t a, uint32_t b) {
+    return (a < b) ? CoveredLength(0, 0, UNIVERSE, a, b) : 0;
+}
+
+uint32_t DynamicSegmentTree::CoveredLength(uint32_t loc, uint64_t lo, uint64_t hi, uint32_t a, uint32_t b) {
+    uint64_t l = std::max(static_cast<uint64_t>(a), lo);
+    uint64_t r = std::min(static_cast<uint64_t>(b), hi);
+    if (l >= r) {
+        return 0;
+    }
+    if (arena[loc].count > 0) {
+        return static_cast<uint32_t>(r - l);
+    }
+    if (l == lo && r == hi) {
+        return arena[loc].measure;
+    }
+
+    uint64_t mid = lo + (hi - lo) / 2;
+    uint32_t length = 0;
+    if (arena[loc].leftChild != NONE) {
+        length += CoveredLength(arena[loc].leftChild, lo, mid, a, b);
+    }
+    if (arena[loc].rightChild != NONE) {
+        length += CoveredLength(arena[loc].rightChild, mid, hi, a, b);
+    }
+    return length;
+}
+
+uint32_t DynamicSegmentTree::MaxCoverage(uint32_t a, uint32_t b) {
+    return (a < b) ? MaxCoverage(0, 0, UNIVERSE, a, b) : 0;
+}
+
+uint32_t DynamicSegmentTree::MaxCoverage(uint32_t loc, uint64_t lo, uint64_t hi, uint32_t a, uint32_t b) {
+    if (b <= lo || hi <= a) {
+        return 0;
+    }
+    if (a <= lo && hi <= b) {
+        return arena[loc].maxCount;
+    }
+
+    uint64_t mid = lo + (hi - lo) / 2;
+    uint32_t lmax = 0, rmax = 0;
+    if (arena[loc].leftChild != NONE) {
+        lmax = MaxCoverage(arena[loc].leftChild, lo, mid, a, b);
+    }
+    if (arena[loc].rightChild != NONE) {
+        rmax = MaxCoverage(arena[loc].rightChild, mid, hi, a, b);
+    }
+    return arena[loc].count + std::max(lmax, rmax);
+}
+
+// Append [l, r] to gaps, merging with the previous gap if they touch
+static void AddGap(vector<pair<uint32_t, uint32_t>> &gaps, uint64_t l, uint64_t r) {
+    if (l >= r) {
+        return;
+    }
+    if (!gaps.empty() && gaps.back().second == l) {
+        gaps.back().second = static_cast<uint32_t>(r);
+    }
+    else {
+        gaps.push_back(pair<uint32_t, uint32_t>(static_cast<uint32_t>(l), static_cast<uint32_t>(r)));
+    }
+}
+
+vector<pair<uint32_t, uint32_t>> DynamicSegmentTree::UncoveredGaps(uint32_t a, uint32_t b) {
+    vector<pair<uint32_t, uint32_t>> gaps;
+    if (a < b) {
+        UncoveredGaps(0, 0, UNIVERSE, a, b, gaps);
+    }
+    return gaps;
+}
+
+void DynamicSegmentTree::UncoveredGaps(uint32_t loc, uint64_t lo, uint64_t hi, uint32_t a, uint32_t b,
+    vector<pair<uint32_t, uint32_t>> &gaps) {
+    uint64_t l = std::max(static_cast<uint64_t>(a), lo);
+    uint64_t r = std::min(static_cast<uint64_t>(b), hi);
+    if (l >= r || arena[loc].count > 0 || arena[loc].measure == hi - lo) {
+        return;
+    }
+    if (arena[loc].measure == 0) {
+        AddGap(gaps, l, r);
+        return;
+    }
+
+    // a child that was never allocated is entirely uncovered
+    uint64_t mid = lo + (hi - lo) / 2;
+    if (arena[loc].leftChild != NONE) {
+        UncoveredGaps(arena[loc].leftChild, lo, mid, a, b, gaps);
+    }
+    else {
+        AddGap(gaps, l, std::min(r, mid));
+    }
+    if (arena[loc].rightChild != NONE) {
+        UncoveredGaps(arena[loc].rightChild, mid, hi, a, b, gaps);
+    }
+    else {
+        AddGap(gaps, std::max(l, mid), r);
+    }
+}
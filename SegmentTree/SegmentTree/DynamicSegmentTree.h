@@ -0,0 +1,43 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using std::pair;
+using std::vector;
+
+/*
+    Sparse segment tree over the whole coordinate range [0, 2^32).
+
+    Unlike SegmentTree, the endpoint set does not have to be known up front: nodes are
+    created from an arena the first time an update reaches them, so an interval with
+    never-before-seen endpoints is inserted in O(log U) without a rebuild. Insert, Delete
+    and the range queries have the same semantics as in SegmentTree.
+*/
+class DynamicSegmentTree {
+
+    class DynamicSegmentTreeNode {
+    public:
+        // children are arena indices, NONE if not yet allocated
+        uint32_t leftChild, rightChild, measure, count, maxCount;
+        DynamicSegmentTreeNode() : leftChild(NONE), rightChild(NONE), measure(0), count(0), maxCount(0) {};
+    };
+
+public:
+    static const uint32_t NONE = 0;
+
+    vector<DynamicSegmentTreeNode> arena;
+    uint32_t Insert(uint32_t, uint32_t);
+    uint32_t Delete(uint32_t, uint32_t);
+    uint32_t CoveredLength(uint32_t, uint32_t);
+    uint32_t MaxCoverage(uint32_t, uint32_t);
+    vector<pair<uint32_t, uint32_t>> UncoveredGaps(uint32_t, uint32_t);
+    DynamicSegmentTree(size_t = 0);
+private:
+    void Update(uint32_t, uint64_t, uint64_t, uint32_t, uint32_t, int32_t);
+    uint32_t Child(uint32_t, bool);
+    uint32_t CoveredLength(uint32_t, uint64_t, uint64_t, uint32_t, uint32_t);
+    uint32_t MaxCoverage(uint32_t, uint64_t, uint64_t, uint32_t, uint32_t);
+    void UncoveredGaps(uint32_t, uint64_t, uint64_t, uint32_t, uint32_t, vector<pair<uint32_t, uint32_t>> &);
+};
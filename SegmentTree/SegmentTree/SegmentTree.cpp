@@ -1,24 +1,38 @@
 #include "SegmentTree.h"
+#include "Stats.h"
 
 
-SegmentTree::SegmentTree(vector<uint32_t> endpoints) {
-    tree.resize(1 << static_cast<uint32_t>(ceil(log2(endpoints.size())) + 1));
-    BuildTree(endpoints, 0, 0, endpoints.size() - 1);
+SegmentTree::SegmentTree(const vector<uint32_t> &endpoints, uint32_t threads) :
+    SegmentTree(endpoints.data(), endpoints.data() + endpoints.size(), threads) {}
+
+/*
+    Builds the tree over the sorted endpoints in [first, last) in O(n).
+
+    param[in]: threads - number of threads used to build disjoint subtrees in parallel
+*/
+SegmentTree::SegmentTree(const uint32_t *first, const uint32_t *last, uint32_t threads) {
+    STATS_PHASE("build");
+    size_t size = last - first;
+    tree.resize(static_cast<size_t>(1) << (static_cast<uint32_t>(ceil(log2(size))) + 1));
+    BuildTree(first, 0, 0, size - 1, std::max(threads, 1u));
 }
 
-void SegmentTree::BuildTree(vector<uint32_t> endpoints, size_t loc, size_t start, size_t end) {
-    uint32_t mid = static_cast<uint32_t>(ceil((end - start)/ 2.));
+void SegmentTree::BuildTree(const uint32_t *endpoints, size_t loc, size_t start, size_t end, uint32_t threads) {
+    size_t mid = (end - start + 1) / 2;
     tree[loc].left = endpoints[start];
     tree[loc].right = endpoints[end];
-    
-    //for (int i = 0; i < d; i++) {
-    //    std::cout << " ";
-    //}
-    //std::cout << loc << "," << start << "," << end << std::endl;
 
     if (end > start + 1) {
-        BuildTree(endpoints, lchild(loc), start, start + mid);
-        BuildTree(endpoints, rchild(loc), start + mid, end);
+        // subtrees occupy disjoint slots of tree, so they can be filled concurrently
+        if (threads > 1 && end - start > PARALLEL_BUILD_CUTOFF) {
+            std::thread left(&SegmentTree::BuildTree, this, endpoints, lchild(loc), start, start + mid, threads / 2);
+            BuildTree(endpoints, rchild(loc), start + mid, end, threads - threads / 2);
+            left.join();
+        }
+        else {
+            BuildTree(endpoints, lchild(loc), start, start + mid, 1);
+            BuildTree(endpoints, rchild(loc), start + mid, end, 1);
+        }
     }
     else {
         tree[loc].isLeaf = true;
@@ -36,6 +50,7 @@ uint32_t SegmentTree::Delete(uint32_t x, uint32_t y) {
 }
 
 void SegmentTree::Update(size_t loc, uint32_t x, uint32_t y, int32_t c) {
+    STATS_COUNT("updateNodes", 1);
     if (x == tree[loc].left && y == tree[loc].right) {
         tree[loc].count += c;
     }
@@ -64,36 +79,101 @@ void SegmentTree::Update(size_t loc, uint32_t x, uint32_t y, int32_t c) {
     else {
         tree[loc].measure = tree[loc].right - tree[loc].left;
     }
+
+    tree[loc].maxCount = tree[loc].count;
+    if (!tree[loc].isLeaf) {
+        tree[loc].maxCount += std::max(tree[lchild(loc)].maxCount, tree[rchild(loc)].maxCount);
+    }
 }
 
+/*
+    Returns the length of [a, b] covered by at least one interval.
+    a and b need not be endpoints of the tree.
+*/
+uint32_t SegmentTree::CoveredLength(uint32_t a, uint32_t b) {
+    return (a < b) ? CoveredLength(0, a, b) : 0;
+}
 
-int main() {
-    uint32_t m, n;
-    char op;
-    std::cin >> m;
-    std::cin >> n;
+uint32_t SegmentTree::CoveredLength(size_t loc, uint32_t a, uint32_t b) {
+    uint32_t l = std::max(a, tree[loc].left);
+    uint32_t r = std::min(b, tree[loc].right);
+    if (l >= r) {
+        return 0;
+    }
+    // an interval stored here covers all of [l, r]
+    if (tree[loc].count > 0) {
+        return r - l;
+    }
+    if (l == tree[loc].left && r == tree[loc].right) {
+        return tree[loc].measure;
+    }
+    if (tree[loc].isLeaf) {
+        return 0;
+    }
+    return CoveredLength(lchild(loc), a, b) + CoveredLength(rchild(loc), a, b);
+}
 
-    std::vector<uint32_t> ends;
+/*
+    Returns the maximum number of intervals overlapping at any point of (a, b),
+    i.e. the maximum overlap depth over the elementary intervals meeting (a, b).
+*/
+uint32_t SegmentTree::MaxCoverage(uint32_t a, uint32_t b) {
+    return (a < b) ? MaxCoverage(0, a, b) : 0;
+}
 
-    uint32_t t;
-    for (uint32_t i = 0; i < m; i++) {
-        std::cin >> t;
-        ends.push_back(t);
+uint32_t SegmentTree::MaxCoverage(size_t loc, uint32_t a, uint32_t b) {
+    if (b <= tree[loc].left || tree[loc].right <= a) {
+        return 0;
+    }
+    if ((a <= tree[loc].left && tree[loc].right <= b) || tree[loc].isLeaf) {
+        return tree[loc].maxCount;
     }
+    return tree[loc].count + std::max(MaxCoverage(lchild(loc), a, b), MaxCoverage(rchild(loc), a, b));
+}
 
-    SegmentTree *T = new SegmentTree(ends);
+// Append [l, r] to gaps, merging with the previous gap if they touch
+static void AddGap(vector<pair<uint32_t, uint32_t>> &gaps, uint32_t l, uint32_t r) {
+    if (!gaps.empty() && gaps.back().second == l) {
+        gaps.back().second = r;
+    }
+    else {
+        gaps.push_back(pair<uint32_t, uint32_t>(l, r));
+    }
+}
 
-    uint32_t l, r;
-    for (uint32_t i = 0; i < n; i++) {
-        std::cin >> op;
-        std::cin >> l;
-        std::cin >> r;
+/*
+    Returns the maximal sub-intervals of [a, b] not covered by any interval, in increasing order.
+    Runs in O((k + 1) log n) where k is the number of gaps reported.
+*/
+vector<pair<uint32_t, uint32_t>> SegmentTree::UncoveredGaps(uint32_t a, uint32_t b) {
+    vector<pair<uint32_t, uint32_t>> gaps;
+    if (a >= b) {
+        return gaps;
+    }
 
-        if (op == 'I') {
-            std::cout << T->Insert(l, r) << std::endl;
-        }
-        else {
-            std::cout << T->Delete(l, r) << std::endl;
-        }
+    // nothing can be inserted outside the endpoint range
+    if (a < tree[0].left) {
+        AddGap(gaps, a, std::min(b, tree[0].left));
+    }
+    UncoveredGaps(0, a, b, gaps);
+    if (tree[0].right < b) {
+        AddGap(gaps, std::max(a, tree[0].right), b);
     }
-}
\ No newline at end of file
+    return gaps;
+}
+
+void SegmentTree::UncoveredGaps(size_t loc, uint32_t a, uint32_t b, vector<pair<uint32_t, uint32_t>> &gaps) {
+    uint32_t l = std::max(a, tree[loc].left);
+    uint32_t r = std::min(b, tree[loc].right);
+    if (l >= r || tree[loc].count > 0 || tree[loc].measure == tree[loc].right - tree[loc].left) {
+        return;
+    }
+    if (tree[loc].measure == 0 || tree[loc].isLeaf) {
+        AddGap(gaps, l, r);
+    }
+    else {
+        UncoveredGaps(lchild(loc), a, b, gaps);
+        UncoveredGaps(rchild(loc), a, b, gaps);
+    }
+}
+
@@ -1,7 +1,10 @@
 #pragma once
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <math.h>
+#include <thread>
+#include <utility>
 #include <vector>
 
 // Heap indexing
@@ -9,24 +12,37 @@
 #define lchild(k) ((k << 1) + 1)
 #define rchild(k) ((k << 1) + 2)
 
+// Subtrees smaller than this are always built on the calling thread
+#define PARALLEL_BUILD_CUTOFF 65536
+
+using std::pair;
 using std::vector;
 
 class SegmentTree {
 
     class SegmentTreeNode {
     public:
-        uint32_t left, right, measure, count;
+        // maxCount - maximum number of intervals covering any point of [left, right], where
+        // intervals stored at ancestors are not included (lazy add, no push down)
+        uint32_t left, right, measure, count, maxCount;
         bool isLeaf;
-        SegmentTreeNode() : left(0), right(0), measure(0), count(0), isLeaf(false) {};
+        SegmentTreeNode() : left(0), right(0), measure(0), count(0), maxCount(0), isLeaf(false) {};
     };
 
 public:
     vector<SegmentTreeNode> tree;
     uint32_t Insert(uint32_t, uint32_t);
     uint32_t Delete(uint32_t, uint32_t);
-    SegmentTree(vector<uint32_t>);
+    uint32_t CoveredLength(uint32_t, uint32_t);
+    uint32_t MaxCoverage(uint32_t, uint32_t);
+    vector<pair<uint32_t, uint32_t>> UncoveredGaps(uint32_t, uint32_t);
+    SegmentTree(const vector<uint32_t> &, uint32_t = 1);
+    SegmentTree(const uint32_t *, const uint32_t *, uint32_t = 1);
 private:
     void Update(size_t, uint32_t, uint32_t, int32_t);
-    void BuildTree(vector<uint32_t>, size_t, size_t, size_t);
+    uint32_t CoveredLength(size_t, uint32_t, uint32_t);
+    uint32_t MaxCoverage(size_t, uint32_t, uint32_t);
+    void UncoveredGaps(size_t, uint32_t, uint32_t, vector<pair<uint32_t, uint32_t>> &);
+    void BuildTree(const uint32_t *, size_t, size_t, size_t, uint32_t);
 };
 
@@ -0,0 +1,66 @@
+#include <string.h>
+#include "DynamicSegmentTree.h"
+#include "SegmentTree.h"
+#include "Stats.h"
+
+// Apply n operations read from stdin to T, printing one result per line
+template <typename Tree>
+void RunOperations(Tree *T, uint32_t n) {
+    STATS_PHASE("operations");
+    char op;
+    uint32_t l, r;
+    for (uint32_t i = 0; i < n; i++) {
+        std::cin >> op;
+        std::cin >> l;
+        std::cin >> r;
+
+        if (op == 'I') {
+            std::cout << T->Insert(l, r) << std::endl;
+        }
+        else if (op == 'C') {
+            std::cout << T->CoveredLength(l, r) << std::endl;
+        }
+        else if (op == 'M') {
+            std::cout << T->MaxCoverage(l, r) << std::endl;
+        }
+        else if (op == 'G') {
+            vector<pair<uint32_t, uint32_t>> gaps = T->UncoveredGaps(l, r);
+            for (vector<pair<uint32_t, uint32_t>>::iterator it = gaps.begin(); it != gaps.end(); it++) {
+                std::cout << it->first << "," << it->second << " ";
+            }
+            std::cout << std::endl;
+        }
+        else {
+            std::cout << T->Delete(l, r) << std::endl;
+        }
+    }
+}
+
+/*
+    Pass -d to use DynamicSegmentTree, which accepts interval endpoints outside the
+    endpoint list given in the input.
+*/
+int main(int argc, char *argv[]) {
+    STATS_BEGIN();
+    uint32_t m, n;
+    std::cin >> m;
+    std::cin >> n;
+
+    std::vector<uint32_t> ends;
+
+    uint32_t t;
+    for (uint32_t i = 0; i < m; i++) {
+        std::cin >> t;
+        ends.push_back(t);
+    }
+
+    if (argc > 1 && !strcmp(argv[1], "-d")) {
+        DynamicSegmentTree T;
+        RunOperations(&T, n);
+    }
+    else {
+        SegmentTree T(ends);
+        RunOperations(&T, n);
+    }
+    STATS_END("segmenttree", 0, 1);
+}
@@ -22,6 +22,6 @@ for file in inputs:
       match = True
       for (a,b) in zip(lines, lines2):
         if (a != b):
-          match = false
+          match = False
           break
   print("Correct" if match else "Incorrect")
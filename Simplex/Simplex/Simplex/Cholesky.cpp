@@ -0,0 +1,286 @@
+/**
+    Implementation of the sparse Cholesky factorisation of normal equations
+**/
+
+#include <iterator>
+#include <set>
+#include <thread>
+#include "Cholesky.h"
+
+/*
+    Finds the factorisation order of the rows of A and the pattern of L.
+
+    param[in]: M - the constraint matrix A, m x n in CSC form
+    param[in]: threads - threads for Factor
+*/
+void Cholesky::Analyse(const SparseMatrix &M, uint32_t threads) {
+    rows = M.rows;
+
+    // the graph of A A^T: rows sharing a column are adjacent
+    vector<vector<uint32_t>> adjacent(rows);
+    for (uint32_t k = 0; k < M.cols; k++) {
+        for (uint32_t p = M.start[k]; p < M.start[k + 1]; p++) {
+            for (uint32_t q = M.start[k]; q < M.start[k + 1]; q++) {
+                if (p != q) {
+                    adjacent[M.index[p]].push_back(M.index[q]);
+                }
+            }
+        }
+    }
+    std::set<pair<size_t, uint32_t>> degrees;
+    for (uint32_t i = 0; i < rows; i++) {
+        std::sort(adjacent[i].begin(), adjacent[i].end());
+        adjacent[i].erase(std::unique(adjacent[i].begin(), adjacent[i].end()), adjacent[i].end());
+        degrees.insert(std::make_pair(adjacent[i].size(), i));
+    }
+
+    // minimum degree: eliminating a row makes its remaining neighbours a clique, and those
+    // neighbours are the pattern of its column of L
+    vector<vector<uint32_t>> pattern(rows);
+    vector<uint32_t> eliminated(rows);
+    for (uint32_t step = 0; step < rows; step++) {
+        uint32_t v = degrees.begin()->second;
+        degrees.erase(degrees.begin());
+        eliminated[v] = step;
+        pattern[v].swap(adjacent[v]);
+        for (vector<uint32_t>::iterator u = pattern[v].begin(); u != pattern[v].end(); u++) {
+            degrees.erase(std::make_pair(adjacent[*u].size(), *u));
+            vector<uint32_t> merged;
+            std::set_union(adjacent[*u].begin(), adjacent[*u].end(), pattern[v].begin(), pattern[v].end(),
+                std::back_inserter(merged));
+            merged.erase(std::remove_if(merged.begin(), merged.end(), [u, v](uint32_t w) { return w == *u || w == v; }),
+                merged.end());
+            adjacent[*u].swap(merged);
+            degrees.insert(std::make_pair(adjacent[*u].size(), *u));
+        }
+    }
+
+    // elimination tree: the parent of a row is its first eliminated neighbour; renumbering
+    // it in postorder keeps the fill-in and makes every subtree a range of columns
+    vector<vector<uint32_t>> children(rows);
+    vector<uint32_t> roots, byStep(rows);
+    for (uint32_t v = 0; v < rows; v++) {
+        byStep[eliminated[v]] = v;
+    }
+    for (uint32_t step = 0; step < rows; step++) {
+        uint32_t v = byStep[step], parent = NOT_IN_TREE;
+        for (vector<uint32_t>::iterator u = pattern[v].begin(); u != pattern[v].end(); u++) {
+            if (parent == NOT_IN_TREE || eliminated[*u] < eliminated[parent]) {
+                parent = *u;
+            }
+        }
+        if (parent == NOT_IN_TREE) {
+            roots.push_back(v);
+        }
+        else {
+            children[parent].push_back(v);
+        }
+    }
+    order.assign(rows, 0);
+    original.clear();
+    vector<pair<uint32_t, uint32_t>> stack;
+    for (vector<uint32_t>::iterator root = roots.begin(); root != roots.end(); root++) {
+        stack.push_back(std::make_pair(*root, 0));
+        while (!stack.empty()) {
+            uint32_t v = stack.back().first, next = stack.back().second++;
+            if (next < children[v].size()) {
+                stack.push_back(std::make_pair(children[v][next], 0));
+            }
+            else {
+                order[v] = static_cast<uint32_t>(original.size());
+                original.push_back(v);
+                stack.pop_back();
+            }
+        }
+    }
+
+    // pattern of L by column, and by row for the left-looking updates
+    start.assign(1, 0);
+    index.clear();
+    rowEntries.assign(rows, vector<pair<uint32_t, uint32_t>>());
+    for (uint32_t j = 0; j < rows; j++) {
+        const vector<uint32_t> &column = pattern[original[j]];
+        index.push_back(j);
+        for (vector<uint32_t>::const_iterator u = column.begin(); u != column.end(); u++) {
+            index.push_back(order[*u]);
+        }
+        std::sort(index.begin() + start[j] + 1, index.end());
+        for (uint32_t p = start[j] + 1; p < index.size(); p++) {
+            rowEntries[index[p]].push_back(std::make_pair(j, p));
+        }
+        start.push_back(static_cast<uint32_t>(index.size()));
+    }
+    value.assign(index.size(), 0.);
+
+    vector<Triple> entries;
+    for (uint32_t k = 0; k < M.cols; k++) {
+        for (uint32_t p = M.start[k]; p < M.start[k + 1]; p++) {
+            Triple t = { order[M.index[p]], k, M.value[p] };
+            entries.push_back(t);
+        }
+    }
+    A = CompressColumns(rows, M.cols, entries);
+    rowwise = Transpose(A);
+
+    // split the largest subtree into its children, leaving its root on top, until there are
+    // enough subtrees to balance, then hand them to threads largest first
+    subtrees.clear();
+    top.clear();
+    if (threads <= 1) {
+        for (uint32_t j = 0; j < rows; j++) {
+            top.push_back(j);
+        }
+        return;
+    }
+    vector<uint32_t> size(rows, 1), parent(rows, NOT_IN_TREE);
+    vector<double> work(rows, 0.);
+    for (uint32_t j = 0; j < rows; j++) {
+        double count = start[j + 1] - start[j];
+        work[j] += count * count;
+        if (start[j + 1] - start[j] > 1) {
+            parent[j] = index[start[j] + 1];
+            size[parent[j]] += size[j];
+            work[parent[j]] += work[j];
+        }
+    }
+    vector<vector<uint32_t>> below(rows);
+    vector<uint32_t> pieces;
+    for (uint32_t j = 0; j < rows; j++) {
+        if (parent[j] == NOT_IN_TREE) {
+            pieces.push_back(j);
+        }
+        else {
+            below[parent[j]].push_back(j);
+        }
+    }
+    while (pieces.size() < CHOLESKY_SUBTREES_PER_THREAD * threads) {
+        vector<uint32_t>::iterator largest = std::max_element(pieces.begin(), pieces.end(),
+            [&work](uint32_t a, uint32_t b) { return work[a] < work[b]; });
+        if (largest == pieces.end() || size[*largest] < CHOLESKY_MIN_SUBTREE) {
+            break;
+        }
+        uint32_t root = *largest;
+        pieces.erase(largest);
+        top.push_back(root);
+        pieces.insert(pieces.end(), below[root].begin(), below[root].end());
+    }
+    std::sort(top.begin(), top.end());
+    std::sort(pieces.begin(), pieces.end(), [&work](uint32_t a, uint32_t b) { return work[a] > work[b]; });
+    subtrees.assign(threads, vector<pair<uint32_t, uint32_t>>());
+    vector<double> load(threads, 0.);
+    for (vector<uint32_t>::iterator root = pieces.begin(); root != pieces.end(); root++) {
+        uint32_t t = static_cast<uint32_t>(std::min_element(load.begin(), load.end()) - load.begin());
+        subtrees[t].push_back(std::make_pair(*root + 1 - size[*root], *root));
+        load[t] += work[*root];
+    }
+}
+
+/*
+    Computes column j of L from column j of A D A^T and the columns of L to its left.
+
+    param[in]: work - zero vector of size rows, left zero on return
+*/
+void Cholesky::FactorColumn(uint32_t j, const vector<double> &d, vector<double> &work) {
+    for (uint32_t p = rowwise.start[j]; p < rowwise.start[j + 1]; p++) {
+        uint32_t k = rowwise.index[p];
+        double f = rowwise.value[p] * d[k];
+        for (uint32_t q = A.start[k]; q < A.start[k + 1]; q++) {
+            if (A.index[q] >= j) {
+                work[A.index[q]] += f * A.value[q];
+            }
+        }
+    }
+    double diagonal = work[j];
+
+    for (vector<pair<uint32_t, uint32_t>>::const_iterator it = rowEntries[j].begin(); it != rowEntries[j].end(); it++) {
+        double l = value[it->second];
+        if (l != 0.) {
+            for (uint32_t q = it->second; q < start[it->first + 1]; q++) {
+                work[index[q]] -= value[q] * l;
+            }
+        }
+    }
+
+    double pivot = work[j];
+    if (!(pivot > CHOLESKY_PIVOT_TOLERANCE * diagonal)) {
+        dependent[j] = 1;
+        value[start[j]] = 1.;
+        for (uint32_t q = start[j] + 1; q < start[j + 1]; q++) {
+            value[q] = 0.;
+        }
+    }
+    else {
+        double root = sqrt(pivot);
+        value[start[j]] = root;
+        for (uint32_t q = start[j] + 1; q < start[j + 1]; q++) {
+            value[q] = work[index[q]] / root;
+        }
+    }
+    for (uint32_t q = start[j]; q < start[j + 1]; q++) {
+        work[index[q]] = 0.;
+    }
+}
+
+/*
+    Factorises A D A^T, on the threads given to Analyse.
+
+    param[in]: d - the diagonal D, one positive entry per column of A
+*/
+void Cholesky::Factor(const vector<double> &d) {
+    dependent.assign(rows, 0);
+    vector<std::thread> workers;
+    for (vector<vector<pair<uint32_t, uint32_t>>>::iterator it = subtrees.begin(); it != subtrees.end(); it++) {
+        const vector<pair<uint32_t, uint32_t>> &ranges = *it;
+        if (ranges.empty()) {
+            continue;
+        }
+        workers.push_back(std::thread([this, &ranges, &d]() {
+            vector<double> work(rows, 0.);
+            for (vector<pair<uint32_t, uint32_t>>::const_iterator range = ranges.begin(); range != ranges.end(); range++) {
+                for (uint32_t j = range->first; j <= range->second; j++) {
+                    FactorColumn(j, d, work);
+                }
+            }
+        }));
+    }
+    for (vector<std::thread>::iterator it = workers.begin(); it != workers.end(); it++) {
+        it->join();
+    }
+
+    vector<double> work(rows, 0.);
+    for (vector<uint32_t>::iterator j = top.begin(); j != top.end(); j++) {
+        FactorColumn(*j, d, work);
+    }
+}
+
+// Solves A D A^T x = r in place, with x_i = 0 for the dependent rows i
+void Cholesky::Solve(vector<double> &r) const {
+    vector<double> z(rows);
+    for (uint32_t i = 0; i < rows; i++) {
+        z[order[i]] = r[i];
+    }
+    for (uint32_t j = 0; j < rows; j++) {
+        if (dependent[j]) {
+            z[j] = 0.;
+            continue;
+        }
+        z[j] /= value[start[j]];
+        for (uint32_t q = start[j] + 1; q < start[j + 1]; q++) {
+            z[index[q]] -= value[q] * z[j];
+        }
+    }
+    for (uint32_t j = rows; j-- > 0;) {
+        if (dependent[j]) {
+            z[j] = 0.;
+            continue;
+        }
+        double sum = z[j];
+        for (uint32_t q = start[j] + 1; q < start[j + 1]; q++) {
+            sum -= value[q] * z[index[q]];
+        }
+        z[j] = sum / value[start[j]];
+    }
+    for (uint32_t i = 0; i < rows; i++) {
+        r[i] = z[order[i]];
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <math.h>
+#include <utility>
+#include <vector>
+#include "SparseMatrix.h"
+
+using std::pair;
+using std::vector;
+
+// No parent in the elimination tree
+#define NOT_IN_TREE UINT32_MAX
+// Pivots below this fraction of their diagonal entry of A D A^T mark a dependent row
+#define CHOLESKY_PIVOT_TOLERANCE 1e-13
+// Columns of L in the subtrees given to one thread, at the least, before splitting stops
+#define CHOLESKY_MIN_SUBTREE 64
+// The elimination tree is split into about this many subtrees per thread
+#define CHOLESKY_SUBTREES_PER_THREAD 4
+
+/*
+    Sparse Cholesky factorisation P A D A^T P^T = L L^T of the normal equations of an
+    interior point method, for a fixed A and a positive diagonal D that changes with every
+    factorisation.
+
+    Analyse orders the rows of A by minimum degree, which keeps the fill-in of L small, and
+    finds the pattern of L and its elimination tree once. Factor then computes L column by
+    column (left-looking), forming each column of A D A^T on the fly. Columns in disjoint
+    subtrees of the elimination tree never read each other, so the tree is cut into subtrees
+    that threads factor side by side, and the columns above them are finished afterwards.
+
+    Rows of A that are (numerically) dependent on earlier ones give a zero pivot. Their
+    column of L is dropped and Solve sets their component to 0, which solves the consistent
+    systems of an interior point method with redundant constraints.
+*/
+class Cholesky {
+public:
+    Cholesky() : rows(0) {}
+    void Analyse(const SparseMatrix &, uint32_t = 1);
+    void Factor(const vector<double> &);
+    void Solve(vector<double> &) const;
+    uint32_t Dependent() const { return static_cast<uint32_t>(std::count(dependent.begin(), dependent.end(), 1)); }
+    size_t NonZeros() const { return index.size(); }
+
+private:
+    void FactorColumn(uint32_t, const vector<double> &, vector<double> &);
+
+    uint32_t rows;
+    // A with its rows in factorisation order, by column and by row
+    SparseMatrix A, rowwise;
+    // position of each row of A in the factorisation order, and the row at each position
+    vector<uint32_t> order, original;
+    // L by column, with the diagonal entry first in each column
+    vector<uint32_t> start, index;
+    vector<double> value;
+    // for each row j of L, the columns k < j with L_jk != 0 and where L_jk is stored
+    vector<vector<pair<uint32_t, uint32_t>>> rowEntries;
+    // whether each row of L was dropped; a byte each, as threads set them concurrently
+    vector<uint8_t> dependent;
+    // the subtrees [first, last] given to each thread, and the columns above them
+    vector<vector<pair<uint32_t, uint32_t>>> subtrees;
+    vector<uint32_t> top;
+};
@@ -0,0 +1,142 @@
+/**
+    Implementation of the contiguous dense tableau and its pivot kernels
+**/
+
+#include <algorithm>
+#include <thread>
+#include "DenseTableau.h"
+#include "Stats.h"
+
+// The vectorised kernels need GCC/Clang target attributes and x86 intrinsics
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define X86_KERNELS
+#include <immintrin.h>
+#endif
+
+// y -= a x over len doubles
+static void EliminateScalar(double *y, const double *x, double a, size_t len) {
+    for (size_t k = 0; k < len; k++) {
+        y[k] -= a * x[k];
+    }
+}
+
+#ifdef X86_KERNELS
+// len is a multiple of TABLEAU_ALIGNMENT and x, y are 64 byte aligned, so there is no remainder
+__attribute__((target("avx2,fma")))
+static void EliminateAVX2(double *y, const double *x, double a, size_t len) {
+    __m256d va = _mm256_set1_pd(a);
+    for (size_t k = 0; k < len; k += 4) {
+        _mm256_store_pd(y + k, _mm256_fnmadd_pd(va, _mm256_load_pd(x + k), _mm256_load_pd(y + k)));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void EliminateAVX512(double *y, const double *x, double a, size_t len) {
+    __m512d va = _mm512_set1_pd(a);
+    for (size_t k = 0; k < len; k += 8) {
+        _mm512_store_pd(y + k, _mm512_fnmadd_pd(va, _mm512_load_pd(x + k), _mm512_load_pd(y + k)));
+    }
+}
+#endif
+
+bool KernelSupported(PivotKernel kernel) {
+    switch (kernel) {
+    case KERNEL_SCALAR:
+        return true;
+#ifdef X86_KERNELS
+    case KERNEL_AVX2:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case KERNEL_AVX512:
+        return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+        return false;
+    }
+}
+
+// Widest kernel the CPU running this supports
+PivotKernel BestKernel() {
+    if (KernelSupported(KERNEL_AVX512)) {
+        return KERNEL_AVX512;
+    }
+    if (KernelSupported(KERNEL_AVX2)) {
+        return KERNEL_AVX2;
+    }
+    return KERNEL_SCALAR;
+}
+
+/*
+    param[in]: m - number of constraints
+    param[in]: n - number of variables; column n holds the right hand side
+*/
+DenseTableau::DenseTableau(uint32_t m, uint32_t n) :
+    rows(m),
+    cols(n),
+    stride((n + 1 + TABLEAU_ALIGNMENT - 1) / TABLEAU_ALIGNMENT * TABLEAU_ALIGNMENT),
+    kernel(BestKernel())
+{
+    // over-allocate by one row of padding and start data at the first 64 byte boundary
+    storage.assign((rows + 1) * stride + TABLEAU_ALIGNMENT, 0.);
+    uintptr_t address = reinterpret_cast<uintptr_t>(storage.data());
+    size_t bytes = TABLEAU_ALIGNMENT * sizeof(double);
+    data = storage.data() + (bytes - address % bytes) % bytes / sizeof(double);
+}
+
+/*
+    Pivots on entry (s, t): divides row s by it and eliminates column t from every other
+    row, including the objective row.
+
+    param[in]: threads - split the rows across this many threads if the tableau has at least
+    PARALLEL_PIVOT_MIN_ENTRIES entries
+*/
+void DenseTableau::Pivot(uint32_t s, uint32_t t, uint32_t threads) {
+    STATS_COUNT("pivots", 1);
+    double *pivotRow = Row(s);
+    double a_st = pivotRow[t];
+    for (size_t k = 0; k < stride; k++) {
+        pivotRow[k] /= a_st;
+    }
+    pivotRow[t] = 1.;
+
+    uint32_t total = rows + 1;
+    threads = std::min(threads, total);
+    if (threads <= 1 || total * stride < PARALLEL_PIVOT_MIN_ENTRIES) {
+        EliminateRows(0, total, s, t);
+        return;
+    }
+
+    uint32_t chunk = (total + threads - 1) / threads;
+    vector<std::thread> workers;
+    for (uint32_t first = chunk; first < total; first += chunk) {
+        workers.push_back(std::thread(&DenseTableau::EliminateRows, this, first, std::min(first + chunk, total), s, t));
+    }
+    EliminateRows(0, chunk, s, t);
+    for (vector<std::thread>::iterator it = workers.begin(); it != workers.end(); it++) {
+        it->join();
+    }
+}
+
+// Rank-1 update of rows [first, last) other than the pivot row s
+void DenseTableau::EliminateRows(uint32_t first, uint32_t last, uint32_t s, uint32_t t) {
+    const double *pivotRow = Row(s);
+    for (uint32_t i = first; i < last; i++) {
+        double *row = Row(i);
+        double a = row[t];
+        if (i == s || a == 0.) {
+            continue;
+        }
+        switch (kernel) {
+#ifdef X86_KERNELS
+        case KERNEL_AVX512:
+            EliminateAVX512(row, pivotRow, a, stride);
+            break;
+        case KERNEL_AVX2:
+            EliminateAVX2(row, pivotRow, a, stride);
+            break;
+#endif
+        default:
+            EliminateScalar(row, pivotRow, a, stride);
+        }
+        row[t] = 0.;
+    }
+}
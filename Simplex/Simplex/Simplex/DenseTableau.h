@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+// Rows are padded to a multiple of this many doubles (one 64 byte cache line / AVX-512 register)
+#define TABLEAU_ALIGNMENT 8
+// Pivots on tableaus with fewer entries than this are not split across threads
+#define PARALLEL_PIVOT_MIN_ENTRIES (1 << 18)
+
+enum PivotKernel { KERNEL_SCALAR, KERNEL_AVX2, KERNEL_AVX512 };
+
+bool KernelSupported(PivotKernel);
+PivotKernel BestKernel();
+
+/*
+    Dense simplex tableau stored as one contiguous, 64 byte aligned, row-major buffer.
+
+    Row i < rows holds constraint i with its right hand side in column cols; row rows is the
+    objective row. Each row is padded with zeros to a multiple of TABLEAU_ALIGNMENT doubles,
+    so a pivot is a rank-1 update of whole aligned rows that the vectorised kernels process
+    without remainder loops.
+*/
+class DenseTableau {
+public:
+    DenseTableau(uint32_t, uint32_t);
+    double *Row(uint32_t i) { return data + i * stride; }
+    double &At(uint32_t i, uint32_t j) { return data[i * stride + j]; }
+    void Pivot(uint32_t, uint32_t, uint32_t = 1);
+
+    uint32_t rows, cols;
+    size_t stride;
+    PivotKernel kernel;
+
+private:
+    void EliminateRows(uint32_t, uint32_t, uint32_t, uint32_t);
+
+    vector<double> storage;
+    double *data;
+};
@@ -0,0 +1,245 @@
+/**
+    Primal-dual interior point method for linear programs
+**/
+
+#include <algorithm>
+#include "InteriorPoint.h"
+#include "Stats.h"
+
+// Ax
+static vector<double> Multiply(const SparseMatrix &A, const vector<double> &x) {
+    vector<double> r(A.rows, 0.);
+    for (uint32_t j = 0; j < A.cols; j++) {
+        for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+            r[A.index[k]] += A.value[k] * x[j];
+        }
+    }
+    return r;
+}
+
+// A^Ty
+static vector<double> MultiplyTransposed(const SparseMatrix &A, const vector<double> &y) {
+    vector<double> r(A.cols, 0.);
+    for (uint32_t j = 0; j < A.cols; j++) {
+        for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+            r[j] += A.value[k] * y[A.index[k]];
+        }
+    }
+    return r;
+}
+
+static double MaxNorm(const vector<double> &v) {
+    double norm = 0.;
+    for (vector<double>::const_iterator it = v.begin(); it != v.end(); it++) {
+        norm = std::max(norm, fabs(*it));
+    }
+    return norm;
+}
+
+static double Dot(const vector<double> &u, const vector<double> &v) {
+    double sum = 0.;
+    for (size_t i = 0; i < u.size(); i++) {
+        sum += u[i] * v[i];
+    }
+    return sum;
+}
+
+// Largest step up to limit along dv that keeps v >= 0
+static double StepToBoundary(const vector<double> &v, const vector<double> &dv, double limit) {
+    double step = limit;
+    for (size_t j = 0; j < v.size(); j++) {
+        if (dv[j] < 0.) {
+            step = std::min(step, -v[j] / dv[j]);
+        }
+    }
+    return step;
+}
+
+/*
+    Solves the Newton system of the barrier
+        A dx = rb, A^Tdy + dz = rc, Z dx + X dz = rxz
+    through the normal equations A D A^T dy = rb + A (D rc - Z^{-1} rxz) with D = X Z^{-1},
+    whose Cholesky factorisation the caller has computed.
+*/
+static void NewtonStep(const SparseMatrix &A, const Cholesky &normal, const vector<double> &x,
+    const vector<double> &z, const vector<double> &rb, const vector<double> &rc, const vector<double> &rxz,
+    vector<double> &dx, vector<double> &dy, vector<double> &dz) {
+    uint32_t n = A.cols;
+    vector<double> t(n);
+    for (uint32_t j = 0; j < n; j++) {
+        t[j] = (x[j] * rc[j] - rxz[j]) / z[j];
+    }
+    vector<double> r = Multiply(A, t);
+    for (uint32_t i = 0; i < A.rows; i++) {
+        r[i] += rb[i];
+    }
+    dy = r;
+    normal.Solve(dy);
+
+    // near the optimum A D A^T is badly conditioned; refine dy against its residual
+    for (uint32_t pass = 0; pass < BARRIER_REFINEMENT_PASSES; pass++) {
+        vector<double> s = MultiplyTransposed(A, dy);
+        for (uint32_t j = 0; j < n; j++) {
+            s[j] *= x[j] / z[j];
+        }
+        vector<double> correction = Multiply(A, s);
+        for (uint32_t i = 0; i < A.rows; i++) {
+            correction[i] = r[i] - correction[i];
+        }
+        normal.Solve(correction);
+        for (uint32_t i = 0; i < A.rows; i++) {
+            dy[i] += correction[i];
+        }
+    }
+    dz = MultiplyTransposed(A, dy);
+    dx.resize(n);
+    for (uint32_t j = 0; j < n; j++) {
+        dz[j] = rc[j] - dz[j];
+        dx[j] = (rxz[j] - x[j] * dz[j]) / z[j];
+    }
+}
+
+/*
+    Mehrotra's predictor-corrector interior point method for max c^Tx subject to Ax = b,
+    x >= 0 and its dual min b^Ty subject to A^Ty - z = c, z >= 0.
+
+    Each iteration factorises A D A^T once (see Cholesky) and solves with it twice: for the
+    affine scaling direction, which predicts how far the duality gap can fall and so how much
+    centring sigma = (mu_aff / mu)^3 to ask for, and for the corrected direction, which also
+    accounts for the second order term dX dZ of the predictor. The primal and dual take
+    separate steps of BARRIER_STEP_FRACTION of the way to the boundary.
+
+    The starting point is Mehrotra's: the least squares solutions of Ax = b and A^Ty - z = c
+    shifted into the positive orthant.
+
+    param[out]: x, y, z - the iterate closest to optimal
+    param[in]: threads - threads for the factorisations
+    param[out]: iterations - the number of iterations, if not NULL
+    Returns true if the relative infeasibilities and duality gap fell below
+    BARRIER_TOLERANCE, false if the iterates diverged, which happens for infeasible and
+    unbounded LPs, or stopped improving.
+*/
+bool InteriorPoint(const SparseMatrix &A, const vector<double> &b, const vector<double> &c, vector<double> &x,
+    vector<double> &y, vector<double> &z, uint32_t threads, uint32_t *iterations) {
+    STATS_PHASE("InteriorPoint");
+    uint32_t m = A.rows, n = A.cols;
+    if (n == 0) {
+        x.clear();
+        y.assign(m, 0.);
+        z.clear();
+        return false;
+    }
+    // the method is written for min cost^Tx, with duals yMin = -y
+    vector<double> cost(n);
+    for (uint32_t j = 0; j < n; j++) {
+        cost[j] = -c[j];
+    }
+
+    Cholesky normal;
+    normal.Analyse(A, threads);
+    normal.Factor(vector<double>(n, 1.));
+    vector<double> w = b;
+    normal.Solve(w);
+    x = MultiplyTransposed(A, w);
+    y = Multiply(A, cost);
+    normal.Solve(y);
+    z = MultiplyTransposed(A, y);
+    for (uint32_t j = 0; j < n; j++) {
+        z[j] = cost[j] - z[j];
+    }
+    double shiftX = std::max(-1.5 * *std::min_element(x.begin(), x.end()), 0.);
+    double shiftZ = std::max(-1.5 * *std::min_element(z.begin(), z.end()), 0.);
+    double sumX = 0., sumZ = 0.;
+    for (uint32_t j = 0; j < n; j++) {
+        x[j] += shiftX;
+        z[j] += shiftZ;
+        sumX += x[j];
+        sumZ += z[j];
+    }
+    double xz = Dot(x, z);
+    for (uint32_t j = 0; j < n; j++) {
+        // x^Tz = 0 when c or b is 0
+        x[j] += (xz > 0.) ? 0.5 * xz / sumZ : 1.;
+        z[j] += (xz > 0.) ? 0.5 * xz / sumX : 1.;
+    }
+
+    double bNorm = 1. + MaxNorm(b), cNorm = 1. + MaxNorm(cost);
+    bool converged = false;
+    uint32_t iteration = 0, bestIteration = 0;
+    double bestError = HUGE_VAL;
+    vector<double> d(n), rxz(n), dx, dy, dz, dxAffine, dzAffine, bestX, bestY, bestZ;
+    for (; iteration < BARRIER_ITERATION_LIMIT; iteration++) {
+        STATS_COUNT("barrierIterations", 1);
+        vector<double> rb = Multiply(A, x), rc = MultiplyTransposed(A, y);
+        for (uint32_t i = 0; i < m; i++) {
+            rb[i] = b[i] - rb[i];
+        }
+        for (uint32_t j = 0; j < n; j++) {
+            rc[j] = cost[j] - rc[j] - z[j];
+        }
+        double primal = Dot(cost, x), dual = Dot(b, y);
+        double error = std::max(std::max(MaxNorm(rb) / bNorm, MaxNorm(rc) / cNorm),
+            fabs(primal - dual) / (1. + fabs(primal)));
+        if (error < bestError) {
+            bestError = error;
+            bestIteration = iteration;
+            bestX = x;
+            bestY = y;
+            bestZ = z;
+        }
+        if (error < BARRIER_TOLERANCE) {
+            converged = true;
+            break;
+        }
+        // close to the optimum, rounding in the normal equations can stall the last digits
+        // and then throw the iterates off; stop and go back to the best one
+        if ((bestError < sqrt(BARRIER_TOLERANCE) && iteration >= bestIteration + BARRIER_STALL_ITERATIONS) ||
+            !(MaxNorm(x) < BARRIER_DIVERGENCE && MaxNorm(z) < BARRIER_DIVERGENCE)) {
+            break;
+        }
+
+        for (uint32_t j = 0; j < n; j++) {
+            d[j] = x[j] / z[j];
+        }
+        normal.Factor(d);
+
+        // predictor: the affine scaling direction, towards x_j z_j = 0
+        for (uint32_t j = 0; j < n; j++) {
+            rxz[j] = -x[j] * z[j];
+        }
+        NewtonStep(A, normal, x, z, rb, rc, rxz, dxAffine, dy, dzAffine);
+        double primalStep = StepToBoundary(x, dxAffine, 1.), dualStep = StepToBoundary(z, dzAffine, 1.);
+        double mu = Dot(x, z) / n, muAffine = 0.;
+        for (uint32_t j = 0; j < n; j++) {
+            muAffine += (x[j] + primalStep * dxAffine[j]) * (z[j] + dualStep * dzAffine[j]);
+        }
+        muAffine /= n;
+        double sigma = pow(muAffine / mu, 3.);
+
+        // corrector: centre towards x_j z_j = sigma mu, and correct for dx_j dz_j
+        for (uint32_t j = 0; j < n; j++) {
+            rxz[j] = sigma * mu - x[j] * z[j] - dxAffine[j] * dzAffine[j];
+        }
+        NewtonStep(A, normal, x, z, rb, rc, rxz, dx, dy, dz);
+        primalStep = std::min(1., BARRIER_STEP_FRACTION * StepToBoundary(x, dx, HUGE_VAL));
+        dualStep = std::min(1., BARRIER_STEP_FRACTION * StepToBoundary(z, dz, HUGE_VAL));
+        for (uint32_t j = 0; j < n; j++) {
+            x[j] += primalStep * dx[j];
+            z[j] += dualStep * dz[j];
+        }
+        for (uint32_t i = 0; i < m; i++) {
+            y[i] += dualStep * dy[i];
+        }
+    }
+
+    x = bestX;
+    y = bestY;
+    z = bestZ;
+    for (uint32_t i = 0; i < m; i++) {
+        y[i] = -y[i];
+    }
+    if (iterations != NULL) {
+        *iterations = iteration;
+    }
+    return converged;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include <math.h>
+#include <vector>
+#include "Cholesky.h"
+#include "SparseMatrix.h"
+
+using std::vector;
+
+// Barrier iterations before giving up on convergence
+#define BARRIER_ITERATION_LIMIT 100
+// Relative primal and dual infeasibility and duality gap at which the barrier stops
+#define BARRIER_TOLERANCE 1e-8
+// Fraction of the step to the boundary of x >= 0, z >= 0 that each iteration takes
+#define BARRIER_STEP_FRACTION 0.9995
+// Iterations without a new best iterate, once within sqrt(BARRIER_TOLERANCE), before the barrier gives up
+#define BARRIER_STALL_ITERATIONS 5
+// Rounds of iterative refinement of each solve with the normal equations
+#define BARRIER_REFINEMENT_PASSES 2
+// Iterates growing beyond this mean that the LP is infeasible or unbounded
+#define BARRIER_DIVERGENCE 1e30
+
+bool InteriorPoint(const SparseMatrix &, const vector<double> &, const vector<double> &, vector<double> &,
+    vector<double> &, vector<double> &, uint32_t = 1, uint32_t * = NULL);
@@ -0,0 +1,826 @@
+/**
+    Two-phase LP solver on top of the revised simplex method
+**/
+
+#include <cstdlib>
+#include <iomanip>
+#include <string>
+#include "InteriorPoint.h"
+#include "LPSolver.h"
+#include "Rational.h"
+#include "Scaling.h"
+#include "Simplex.h"
+#include "Stats.h"
+
+// How an original variable is expressed through nonnegative standard form columns
+enum BoundKind { SHIFTED, MIRRORED, SPLIT };
+
+/*
+    The standard form max c^Tx subject to Ax = b, x >= 0 of a LinearProgram, with b >= 0.
+    Its columns are the structural ones, then a slack for each variable with two finite
+    bounds, then an artificial for each row.
+        first - first structural column of each variable
+        boundRow - row of the bound x' + s = u - l of each variable, or NONBASIC if it has none
+        sign - -1 for rows that were negated
+*/
+typedef struct StandardForm {
+    SparseMatrix A;
+    vector<double> b, c, sign;
+    vector<BoundKind> kind;
+    vector<uint32_t> first, boundRow;
+    uint32_t slacks, artificials;
+} StandardForm;
+
+/*
+    A variable with a finite lower bound l becomes x = l + x', one with only an upper bound u
+    becomes x = u - x', and a free variable becomes x = x+ - x-. A finite upper bound on a
+    variable with a finite lower bound adds the row x' + s = u - l. Rows are negated where
+    needed so that b >= 0.
+*/
+static void BuildStandardForm(const LinearProgram &lp, StandardForm &sf) {
+    const SparseMatrix &A = lp.A;
+    uint32_t m = A.rows, n = A.cols;
+    vector<uint32_t> boundedVariables;
+    uint32_t structural = 0;
+    sf.kind.resize(n);
+    sf.first.resize(n);
+    sf.boundRow.assign(n, NONBASIC);
+    for (uint32_t j = 0; j < n; j++) {
+        sf.first[j] = structural;
+        if (lp.lower[j] > -HUGE_VAL) {
+            sf.kind[j] = SHIFTED;
+            if (lp.upper[j] < HUGE_VAL) {
+                sf.boundRow[j] = m + static_cast<uint32_t>(boundedVariables.size());
+                boundedVariables.push_back(j);
+            }
+            structural++;
+        }
+        else if (lp.upper[j] < HUGE_VAL) {
+            sf.kind[j] = MIRRORED;
+            structural++;
+        }
+        else {
+            sf.kind[j] = SPLIT;
+            structural += 2;
+        }
+    }
+    uint32_t rows = m + static_cast<uint32_t>(boundedVariables.size());
+    sf.slacks = structural;
+    sf.artificials = structural + static_cast<uint32_t>(boundedVariables.size());
+    uint32_t cols = sf.artificials + rows;
+
+    vector<Triple> entries;
+    sf.b = lp.b;
+    sf.b.resize(rows);
+    sf.c.assign(cols, 0.);
+    for (uint32_t j = 0; j < n; j++) {
+        for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+            uint32_t i = A.index[k];
+            double a = A.value[k];
+            if (sf.kind[j] == SHIFTED) {
+                Triple t = { i, sf.first[j], a };
+                entries.push_back(t);
+                sf.b[i] -= a * lp.lower[j];
+            }
+            else if (sf.kind[j] == MIRRORED) {
+                Triple t = { i, sf.first[j], -a };
+                entries.push_back(t);
+                sf.b[i] -= a * lp.upper[j];
+            }
+            else {
+                Triple plus = { i, sf.first[j], a }, minus = { i, sf.first[j] + 1, -a };
+                entries.push_back(plus);
+                entries.push_back(minus);
+            }
+        }
+        sf.c[sf.first[j]] = (sf.kind[j] == MIRRORED) ? -lp.c[j] : lp.c[j];
+        if (sf.kind[j] == SPLIT) {
+            sf.c[sf.first[j] + 1] = -lp.c[j];
+        }
+    }
+    for (uint32_t r = 0; r < boundedVariables.size(); r++) {
+        uint32_t j = boundedVariables[r];
+        Triple x = { m + r, sf.first[j], 1. }, s = { m + r, sf.slacks + r, 1. };
+        entries.push_back(x);
+        entries.push_back(s);
+        sf.b[m + r] = lp.upper[j] - lp.lower[j];
+    }
+
+    sf.sign.assign(rows, 1.);
+    for (uint32_t i = 0; i < rows; i++) {
+        if (sf.b[i] < 0.) {
+            sf.sign[i] = -1.;
+            sf.b[i] = -sf.b[i];
+        }
+    }
+    for (vector<Triple>::iterator it = entries.begin(); it != entries.end(); it++) {
+        it->value *= sf.sign[it->row];
+    }
+    for (uint32_t i = 0; i < rows; i++) {
+        Triple t = { i, sf.artificials + i, 1. };
+        entries.push_back(t);
+    }
+    sf.A = CompressColumns(rows, cols, entries);
+}
+
+/*
+    Maps basis onto the standard form columns. Returns false if it does not give one basic
+    column per row, e.g. because rows were added without a basic variable for each.
+*/
+static bool WarmBasis(const StandardForm &sf, const LPBasis &basis, vector<uint32_t> &basic,
+    vector<uint32_t> &nonbasic) {
+    uint32_t n = static_cast<uint32_t>(sf.kind.size());
+    if (basis.columns.size() != n || basis.rows.size() != sf.A.rows - (sf.artificials - sf.slacks)) {
+        return false;
+    }
+    vector<bool> inBasis(sf.A.cols, false);
+    for (uint32_t j = 0; j < n; j++) {
+        VariableStatus status = basis.columns[j];
+        if (sf.kind[j] == SHIFTED && sf.boundRow[j] != NONBASIC) {
+            // x' + s = u - l: at the lower bound s is basic, at the upper bound x' is
+            uint32_t slack = sf.slacks + sf.boundRow[j] - static_cast<uint32_t>(basis.rows.size());
+            inBasis[sf.first[j]] = status == VAR_BASIC || status == VAR_AT_UPPER;
+            inBasis[slack] = status != VAR_AT_UPPER;
+        }
+        else {
+            inBasis[sf.first[j]] = status == VAR_BASIC;
+        }
+    }
+    for (uint32_t i = 0; i < basis.rows.size(); i++) {
+        inBasis[sf.artificials + i] = basis.rows[i] == VAR_BASIC;
+    }
+
+    for (uint32_t j = 0; j < sf.A.cols; j++) {
+        if (inBasis[j]) {
+            basic.push_back(j);
+        }
+        else {
+            nonbasic.push_back(j);
+        }
+    }
+    return basic.size() == sf.A.rows;
+}
+
+/*
+    Phase one from the current basis, which must be primal feasible: minimises the sum of
+    the artificials, then pivots those still basic out on the largest entry of their row;
+    those left are on redundant rows, whose entries are only rounding noise, and stay at 0.
+    Returns LP_OPTIMAL once the artificials are at 0, LP_INFEASIBLE if they cannot get there,
+    or LP_SINGULAR.
+*/
+static LPStatus MinimizeArtificials(const StandardForm &sf, RevisedSimplex &simplex) {
+    vector<double> phaseOne(sf.A.cols, 0.);
+    double scale = 1.;
+    for (uint32_t j = sf.artificials; j < sf.A.cols; j++) {
+        phaseOne[j] = -1.;
+        scale += sf.b[j - sf.artificials];
+    }
+    if (simplex.Maximize(phaseOne, -simplex.tolerances.primal * scale) == LP_SINGULAR) {
+        return LP_SINGULAR;
+    }
+    if (-simplex.Objective(phaseOne) > simplex.tolerances.primal * scale) {
+        return LP_INFEASIBLE;
+    }
+
+    for (uint32_t p = 0; p < sf.A.rows; p++) {
+        if (simplex.B[p] >= sf.artificials) {
+            vector<double> row = simplex.TableauRow(p);
+            uint32_t t = NONBASIC;
+            for (uint32_t j = 0; j < sf.artificials; j++) {
+                if (!simplex.IsBasic(j) && fabs(row[j]) > PIVOT_TOLERANCE && (t == NONBASIC || fabs(row[j]) > fabs(row[t]))) {
+                    t = j;
+                }
+            }
+            if (t != NONBASIC) {
+                simplex.Pivot(p, t, simplex.Column(t));
+            }
+        }
+    }
+    return LP_OPTIMAL;
+}
+
+// Phase one from the artificial basis, see MinimizeArtificials
+static LPStatus PhaseOne(const StandardForm &sf, RevisedSimplex &simplex) {
+    vector<uint32_t> basic, nonbasic;
+    for (uint32_t j = 0; j < sf.A.cols; j++) {
+        if (j >= sf.artificials) {
+            basic.push_back(j);
+        }
+        else {
+            nonbasic.push_back(j);
+        }
+    }
+    simplex.SetBasis(basic, nonbasic);
+    return MinimizeArtificials(sf, simplex);
+}
+
+// Whether every artificial in the basis is at 0, so that its values solve Ax = b
+static bool ArtificialsAtZero(const StandardForm &sf, const RevisedSimplex &simplex) {
+    for (uint32_t p = 0; p < sf.A.rows; p++) {
+        if (simplex.B[p] >= sf.artificials && simplex.x_B[p] > simplex.tolerances.primal * (1. + sf.b[simplex.B[p] - sf.artificials])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+    Re-optimises from a warm basis: with primal simplex if it is still feasible, with the dual
+    simplex method if it is still dual feasible. Returns false if it is neither, if the basis
+    turns out singular, or if either ends with a basic artificial away from 0 (the warm basis may keep artificials on redundant
+    or empty rows, whose right hand side can have changed); the caller then solves from scratch.
+*/
+static bool WarmStart(const StandardForm &sf, RevisedSimplex &simplex, const LPBasis &basis, LPStatus &status) {
+    vector<uint32_t> basic, nonbasic;
+    if (!WarmBasis(sf, basis, basic, nonbasic) || !simplex.SetBasis(basic, nonbasic)) {
+        return false;
+    }
+    simplex.enterLimit = sf.artificials;
+    if (simplex.IsPrimalFeasible()) {
+        status = simplex.Maximize(sf.c);
+    }
+    else if (simplex.IsDualFeasible(sf.c)) {
+        status = simplex.DualMaximize(sf.c);
+    }
+    else {
+        return false;
+    }
+    // an infeasibility proof of the dual simplex method holds whatever the artificials are at
+    return status == LP_INFEASIBLE || (status != LP_SINGULAR && ArtificialsAtZero(sf, simplex));
+}
+
+// Fills in x, y, the reduced costs and the basis of solution from the optimal basis of simplex
+static void ReadSolution(const LinearProgram &lp, const StandardForm &sf, RevisedSimplex &simplex, LPSolution &solution) {
+    const SparseMatrix &A = lp.A;
+    uint32_t m = A.rows, n = A.cols;
+    vector<double> value(sf.A.cols, 0.);
+    for (uint32_t p = 0; p < sf.A.rows; p++) {
+        value[simplex.B[p]] = simplex.x_B[p];
+    }
+    solution.x.resize(n);
+    solution.basis.columns.resize(n);
+    for (uint32_t j = 0; j < n; j++) {
+        uint32_t x = sf.first[j];
+        if (sf.kind[j] == SHIFTED) {
+            solution.x[j] = lp.lower[j] + value[x];
+            bool atUpper = sf.boundRow[j] != NONBASIC && !simplex.IsBasic(sf.slacks + sf.boundRow[j] - m);
+            solution.basis.columns[j] = !simplex.IsBasic(x) ? VAR_AT_LOWER : (atUpper ? VAR_AT_UPPER : VAR_BASIC);
+        }
+        else if (sf.kind[j] == MIRRORED) {
+            solution.x[j] = lp.upper[j] - value[x];
+            solution.basis.columns[j] = simplex.IsBasic(x) ? VAR_BASIC : VAR_AT_UPPER;
+        }
+        else {
+            solution.x[j] = value[x] - value[x + 1];
+            solution.basis.columns[j] = (simplex.IsBasic(x) || simplex.IsBasic(x + 1)) ? VAR_BASIC : VAR_FREE;
+        }
+        solution.objective += lp.c[j] * solution.x[j];
+    }
+    solution.basis.rows.resize(m);
+    for (uint32_t i = 0; i < m; i++) {
+        solution.basis.rows[i] = simplex.IsBasic(sf.artificials + i) ? VAR_BASIC : VAR_AT_LOWER;
+    }
+
+    // duals of the original rows, undoing the negation; reduced costs on the original columns
+    vector<double> y = simplex.Duals(sf.c);
+    solution.y.resize(m);
+    for (uint32_t i = 0; i < m; i++) {
+        solution.y[i] = sf.sign[i] * y[i];
+    }
+    solution.reducedCosts.resize(n);
+    for (uint32_t j = 0; j < n; j++) {
+        solution.reducedCosts[j] = lp.c[j];
+        for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+            solution.reducedCosts[j] -= solution.y[A.index[k]] * A.value[k];
+        }
+    }
+}
+
+// SolveLP without scaling or verification
+static LPSolution SolveTwoPhase(const LinearProgram &lp, PricingRule rule, const LPBasis *warm,
+    const Tolerances &tolerances) {
+    LPSolution solution;
+    solution.objective = 0.;
+
+    StandardForm sf;
+    BuildStandardForm(lp, sf);
+    RevisedSimplex simplex(sf.A, sf.b, tolerances);
+    simplex.pricing = rule;
+
+    if (warm == NULL || !WarmStart(sf, simplex, *warm, solution.status)) {
+        simplex.enterLimit = sf.A.cols;
+        solution.status = PhaseOne(sf, simplex);
+        if (solution.status == LP_OPTIMAL) {
+            simplex.enterLimit = sf.artificials;
+            solution.status = simplex.Maximize(sf.c);
+        }
+    }
+    solution.pivots = simplex.pivots;
+    if (solution.status != LP_OPTIMAL) {
+        return solution;
+    }
+
+    ReadSolution(lp, sf, simplex, solution);
+    return solution;
+}
+
+/*
+    Crosses over from the barrier's x, z to an optimal basis of sf. Columns enter the basis
+    in decreasing order of x_j / (x_j + z_j), which is near 1 for the variables the barrier
+    keeps away from 0 and near 0 for those it drives to 0, each replacing an artificial unless
+    it depends on the columns already in; artificials are left only on redundant rows.
+
+    The basis is then cleaned up with the simplex method: if it is not primal feasible, the
+    costs of the nonbasic variables with positive reduced costs are lowered to make it dual
+    feasible and the dual simplex method restores primal feasibility. Artificials still above
+    0 are then driven out by phase one, so that an infeasible LP is not taken for unbounded,
+    after which the primal simplex method optimises the real costs. Near a strictly
+    complementary solution each step takes few pivots, but the cleanup reaches an optimal
+    basis from any x, z.
+*/
+static LPStatus Crossover(const StandardForm &sf, RevisedSimplex &simplex, const vector<double> &x,
+    const vector<double> &z) {
+    vector<uint32_t> basic, nonbasic, candidates;
+    for (uint32_t j = 0; j < sf.A.cols; j++) {
+        if (j >= sf.artificials) {
+            basic.push_back(j);
+        }
+        else {
+            nonbasic.push_back(j);
+            candidates.push_back(j);
+        }
+    }
+    vector<double> weight(sf.artificials, 0.);
+    for (uint32_t j = 0; j < x.size(); j++) {
+        if (x[j] + z[j] > 0. && x[j] + z[j] < HUGE_VAL) {
+            weight[j] = x[j] / (x[j] + z[j]);
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+        [&weight](uint32_t a, uint32_t b) { return weight[a] > weight[b]; });
+
+    simplex.SetBasis(basic, nonbasic);
+    uint32_t artificials = sf.A.rows;
+    for (vector<uint32_t>::iterator j = candidates.begin(); j != candidates.end() && artificials > 0; j++) {
+        vector<double> alpha = simplex.Column(*j);
+        double largest = 0.;
+        for (uint32_t p = 0; p < sf.A.rows; p++) {
+            largest = std::max(largest, fabs(alpha[p]));
+        }
+        uint32_t s = NONBASIC;
+        for (uint32_t p = 0; p < sf.A.rows; p++) {
+            if (simplex.B[p] >= sf.artificials && fabs(alpha[p]) > std::max(simplex.tolerances.pivot, PIVOT_TOLERANCE * largest) &&
+                (s == NONBASIC || fabs(alpha[p]) > fabs(alpha[s]))) {
+                s = p;
+            }
+        }
+        if (s != NONBASIC) {
+            simplex.Pivot(s, *j, alpha);
+            artificials--;
+            if (simplex.pivots % REFACTOR_INTERVAL == 0) {
+                basic = simplex.B;
+                nonbasic = simplex.B_comp;
+                simplex.SetBasis(basic, nonbasic);
+            }
+        }
+    }
+    // the pivots above only chose the columns; start from the values of the basis
+    basic = simplex.B;
+    nonbasic = simplex.B_comp;
+    if (!simplex.SetBasis(basic, nonbasic)) {
+        return LP_SINGULAR;
+    }
+    simplex.pivots = 0;
+
+    simplex.enterLimit = sf.artificials;
+    LPStatus status = LP_OPTIMAL;
+    if (!simplex.IsPrimalFeasible()) {
+        vector<double> shifted = sf.c, y = simplex.Duals(sf.c);
+        for (uint32_t j = 0; j < sf.artificials; j++) {
+            if (!simplex.IsBasic(j)) {
+                shifted[j] -= std::max(sf.c[j] - simplex.ColumnDot(y, j), 0.);
+            }
+        }
+        status = simplex.DualMaximize(shifted);
+    }
+    // the artificials go to 0 before the real costs are optimised, so that an infeasible LP
+    // with an unbounded ray is found infeasible
+    if (status == LP_OPTIMAL) {
+        status = MinimizeArtificials(sf, simplex);
+    }
+    if (status == LP_OPTIMAL) {
+        status = simplex.Maximize(sf.c);
+    }
+    if (status == LP_OPTIMAL && !ArtificialsAtZero(sf, simplex)) {
+        status = LP_INFEASIBLE;
+    }
+    return status;
+}
+
+/*
+    SolveTwoPhase with the barrier instead of phase one: InteriorPoint solves the standard
+    form without its artificials, and Crossover turns its point into an optimal basis. Even
+    if the barrier fails, which it does on infeasible and unbounded LPs, the crossover
+    starts the simplex method from the basis its last iterate suggests, and finds the status.
+*/
+static LPSolution SolveBarrier(const LinearProgram &lp, PricingRule rule, const Tolerances &tolerances,
+    uint32_t threads) {
+    LPSolution solution;
+    solution.objective = 0.;
+
+    StandardForm sf;
+    BuildStandardForm(lp, sf);
+    SparseMatrix A = LeadingColumns(sf.A, sf.artificials);
+    vector<double> c(sf.c.begin(), sf.c.begin() + sf.artificials), x, y, z;
+    InteriorPoint(A, sf.b, c, x, y, z, threads, &solution.iterations);
+
+    RevisedSimplex simplex(sf.A, sf.b, tolerances);
+    simplex.pricing = rule;
+    solution.status = Crossover(sf, simplex, x, z);
+    solution.pivots = simplex.pivots;
+    if (solution.status == LP_OPTIMAL) {
+        ReadSolution(lp, sf, simplex, solution);
+    }
+    return solution;
+}
+
+/*
+    Solves lp with the two-phase revised simplex method on its standard form (see
+    BuildStandardForm), with an artificial for each row.
+
+    Phase one drives the artificials to zero. Phase two then continues from that basis, on the
+    same factorisation, with the real objective and without letting an artificial back in.
+
+    param[in]: warm - optimal basis of a previous solve of lp before a change to b, a bound,
+    or added rows (see AddRow). Re-optimising from it usually takes a handful of pivots; the
+    solve falls back to the two phases if it cannot be used.
+    param[in]: settings - tolerances, whether to scale lp first and to verify the answer, and
+    whether to solve it with the barrier (which ignores warm)
+*/
+LPSolution SolveLP(const LinearProgram &lp, PricingRule rule, const LPBasis *warm, const LPSettings &settings) {
+    STATS_PHASE("SolveLP");
+    LPSolution solution;
+    if (settings.scale) {
+        LinearProgram scaled = lp;
+        Scaling scaling = ScaleLP(scaled);
+        solution = settings.barrier ? SolveBarrier(scaled, rule, settings.tolerances, settings.threads) :
+            SolveTwoPhase(scaled, rule, warm, settings.tolerances);
+        if (solution.status == LP_OPTIMAL) {
+            UnscaleSolution(scaling, solution);
+            solution.objective = 0.;
+            for (uint32_t j = 0; j < lp.A.cols; j++) {
+                solution.objective += lp.c[j] * solution.x[j];
+            }
+        }
+    }
+    else {
+        solution = settings.barrier ? SolveBarrier(lp, rule, settings.tolerances, settings.threads) :
+            SolveTwoPhase(lp, rule, warm, settings.tolerances);
+    }
+
+    if (settings.verify && solution.status == LP_OPTIMAL) {
+        solution.checked = true;
+        solution.verified = VerifyBasis(lp, solution.basis);
+    }
+    return solution;
+}
+
+/*
+    Solves M z = r exactly for M and r with power of 2 denominators, such as those converted
+    from doubles. Each row of [M | r] is scaled to integers, then fraction-free (Bareiss)
+    elimination keeps every entry an integer minor of M, dividing each update exactly by the
+    previous pivot, so no gcds are ever taken. Each pivot is the nonzero with the smallest
+    Markowitz count (r_i - 1)(c_j - 1) over the remaining rows and columns, which keeps fill-in,
+    and with it the size of the numbers, down; exact arithmetic needs no pivoting for
+    stability. On return z = num / den with den = +-det(M). Returns false if M is singular.
+*/
+static bool SolveExact(const vector<vector<Rational>> &Mq, const vector<Rational> &rq, vector<BigInt> &num,
+    BigInt &den) {
+    size_t size = Mq.size();
+    vector<vector<BigInt>> M(size, vector<BigInt>(size));
+    vector<BigInt> r(size);
+    vector<size_t> rowCount(size, 0), colCount(size, 0), pivotRow(size), pivotCol(size);
+    vector<bool> rowUsed(size, false), colUsed(size, false);
+    for (size_t i = 0; i < size; i++) {
+        uint32_t shift = rq[i].Denominator().TrailingZeros();
+        for (size_t j = 0; j < size; j++) {
+            shift = std::max(shift, Mq[i][j].Denominator().TrailingZeros());
+        }
+        for (size_t j = 0; j < size; j++) {
+            if (!Mq[i][j].IsZero()) {
+                M[i][j] = Mq[i][j].Numerator() << (shift - Mq[i][j].Denominator().TrailingZeros());
+                rowCount[i]++;
+                colCount[j]++;
+            }
+        }
+        r[i] = rq[i].Numerator() << (shift - rq[i].Denominator().TrailingZeros());
+    }
+
+    BigInt previous(1);
+    for (size_t step = 0; step < size; step++) {
+        size_t p = size, q = size, best = 0;
+        for (size_t i = 0; i < size; i++) {
+            for (size_t j = 0; j < size && !rowUsed[i]; j++) {
+                size_t count = (rowCount[i] - 1) * (colCount[j] - 1);
+                if (!colUsed[j] && !M[i][j].IsZero() && (p == size || count < best)) {
+                    p = i;
+                    q = j;
+                    best = count;
+                }
+            }
+        }
+        if (p == size) {
+            return false;
+        }
+        rowUsed[p] = colUsed[q] = true;
+        pivotRow[step] = p;
+        pivotCol[step] = q;
+
+        const BigInt &pivot = M[p][q];
+        bool unit = previous.IsOne();
+        for (size_t i = 0; i < size; i++) {
+            if (rowUsed[i]) {
+                continue;
+            }
+            // M_ij <- (M_pq M_ij - M_iq M_pj) / previous, exactly, over the remaining columns
+            const BigInt f = M[i][q];
+            for (size_t j = 0; j < size; j++) {
+                if (colUsed[j] || (M[i][j].IsZero() && (f.IsZero() || M[p][j].IsZero()))) {
+                    continue;
+                }
+                bool wasZero = M[i][j].IsZero();
+                BigInt v = pivot * M[i][j];
+                if (!f.IsZero() && !M[p][j].IsZero()) {
+                    v = v - f * M[p][j];
+                }
+                M[i][j] = unit ? v : v / previous;
+                if (wasZero != M[i][j].IsZero()) {
+                    rowCount[i] += wasZero ? 1 : -1;
+                    colCount[j] += wasZero ? 1 : -1;
+                }
+            }
+            BigInt v = pivot * r[i];
+            if (!f.IsZero() && !r[p].IsZero()) {
+                v = v - f * r[p];
+            }
+            r[i] = unit ? v : v / previous;
+            if (!f.IsZero()) {
+                M[i][q] = BigInt();
+                rowCount[i]--;
+            }
+        }
+        previous = pivot;
+    }
+
+    // the last pivot is +-det(M), so num = den z is integral and every division below exact
+    den = previous;
+    num.assign(size, BigInt());
+    for (size_t step = size; step-- > 0;) {
+        size_t p = pivotRow[step], q = pivotCol[step];
+        BigInt sum = den * r[p];
+        for (size_t j = 0; j < size; j++) {
+            if (colUsed[j] && j != q && !M[p][j].IsZero() && !num[j].IsZero()) {
+                sum = sum - M[p][j] * num[j];
+            }
+        }
+        num[q] = sum / M[p][q];
+    }
+    return true;
+}
+
+// Sign of num / den - value
+static int CompareRatio(const BigInt &num, const BigInt &den, double value) {
+    Rational v(value);
+    return (num * v.Denominator() - v.Numerator() * den).Sign() * den.Sign();
+}
+
+/*
+    Checks in exact rational arithmetic, on the doubles of lp as given, that basis is an
+    optimal basis of lp: nonbasic variables sit at their bounds, the basis matrix (structural
+    columns and the artificials of redundant rows) is nonsingular, the basic solution respects
+    every bound and leaves the artificials at 0, and every reduced cost has the sign that
+    makes its nonbasic bound optimal. No tolerance is involved, so a basis that passes is
+    optimal for the LP exactly as stored, however the floating point solve reached it. The
+    cost grows quickly with the number of rows.
+*/
+bool VerifyBasis(const LinearProgram &lp, const LPBasis &basis) {
+    const SparseMatrix &A = lp.A;
+    uint32_t m = A.rows, n = A.cols;
+    if (basis.columns.size() != n || basis.rows.size() != m) {
+        return false;
+    }
+
+    // basic columns: j < n for variables, n + i for the artificial of row i
+    vector<uint32_t> basic;
+    vector<Rational> x(n);
+    for (uint32_t j = 0; j < n; j++) {
+        switch (basis.columns[j]) {
+        case VAR_BASIC:
+            basic.push_back(j);
+            break;
+        case VAR_AT_LOWER:
+            if (lp.lower[j] == -HUGE_VAL) {
+                return false;
+            }
+            x[j] = Rational(lp.lower[j]);
+            break;
+        case VAR_AT_UPPER:
+            if (lp.upper[j] == HUGE_VAL) {
+                return false;
+            }
+            x[j] = Rational(lp.upper[j]);
+            break;
+        default:
+            if (lp.lower[j] > 0. || lp.upper[j] < 0.) {
+                return false;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < m; i++) {
+        if (basis.rows[i] == VAR_BASIC) {
+            basic.push_back(n + i);
+        }
+    }
+    if (basic.size() != m) {
+        return false;
+    }
+
+    // x_B from A_B x_B = b - A_N x_N
+    vector<vector<Rational>> M(m, vector<Rational>(m)), MT(m, vector<Rational>(m));
+    vector<Rational> rhs(m), costs(m);
+    vector<BigInt> z, y;
+    BigInt zDen, yDen;
+    for (uint32_t i = 0; i < m; i++) {
+        rhs[i] = Rational(lp.b[i]);
+    }
+    for (uint32_t j = 0; j < n; j++) {
+        if (basis.columns[j] != VAR_BASIC && !x[j].IsZero()) {
+            for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+                rhs[A.index[k]] = rhs[A.index[k]] - Rational(A.value[k]) * x[j];
+            }
+        }
+    }
+    for (uint32_t q = 0; q < m; q++) {
+        uint32_t j = basic[q];
+        if (j >= n) {
+            M[j - n][q] = MT[q][j - n] = Rational(1.);
+            continue;
+        }
+        for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+            M[A.index[k]][q] = MT[q][A.index[k]] = Rational(A.value[k]);
+        }
+        costs[q] = Rational(lp.c[j]);
+    }
+    if (!SolveExact(M, rhs, z, zDen)) {
+        return false;
+    }
+    for (uint32_t q = 0; q < m; q++) {
+        uint32_t j = basic[q];
+        if (j >= n) {
+            if (!z[q].IsZero()) {
+                return false;
+            }
+        }
+        else if ((lp.lower[j] > -HUGE_VAL && CompareRatio(z[q], zDen, lp.lower[j]) < 0) ||
+            (lp.upper[j] < HUGE_VAL && CompareRatio(z[q], zDen, lp.upper[j]) > 0)) {
+            return false;
+        }
+    }
+
+    // y from A_B^T y = c_B, then the signs of the reduced costs c_j - y^Ta_j
+    if (!SolveExact(MT, costs, y, yDen)) {
+        return false;
+    }
+    for (uint32_t j = 0; j < n; j++) {
+        VariableStatus status = basis.columns[j];
+        if (status == VAR_BASIC || lp.lower[j] == lp.upper[j]) {
+            continue;
+        }
+        // y holds numerators over yDen, so d = |yDen| (c_j - y^Ta_j / yDen) has the sign of the reduced cost
+        Rational d = Rational(lp.c[j]) * Rational(yDen, BigInt(1));
+        for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+            if (!y[A.index[k]].IsZero()) {
+                d = d - Rational(y[A.index[k]], BigInt(1)) * Rational(A.value[k]);
+            }
+        }
+        d = (yDen.Sign() < 0) ? -d : d;
+        if ((status == VAR_AT_LOWER && d.Sign() > 0) || (status == VAR_AT_UPPER && d.Sign() < 0) ||
+            (status == VAR_FREE && !d.IsZero())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+    Adds the constraint a^Tx <= rhs to lp as the row a^Tx + s = rhs with a new variable
+    s >= 0 of cost 0, and extends basis with s basic so that it can warm start the next solve.
+
+    param[in]: a - (variable, coefficient) pairs
+*/
+void AddRow(LinearProgram &lp, const SparseVector &a, double rhs, LPBasis &basis) {
+    uint32_t rows = lp.A.rows, cols = lp.A.cols;
+    vector<Triple> entries;
+    entries.reserve(lp.A.index.size() + a.size() + 1);
+    for (uint32_t j = 0; j < cols; j++) {
+        for (uint32_t k = lp.A.start[j]; k < lp.A.start[j + 1]; k++) {
+            Triple t = { lp.A.index[k], j, lp.A.value[k] };
+            entries.push_back(t);
+        }
+    }
+    for (SparseVector::const_iterator it = a.begin(); it != a.end(); it++) {
+        Triple t = { rows, it->first, it->second };
+        entries.push_back(t);
+    }
+    Triple slack = { rows, cols, 1. };
+    entries.push_back(slack);
+    lp.A = CompressColumns(rows + 1, cols + 1, entries);
+
+    lp.b.push_back(rhs);
+    lp.c.push_back(0.);
+    lp.lower.push_back(0.);
+    lp.upper.push_back(HUGE_VAL);
+    basis.columns.push_back(VAR_BASIC);
+    basis.rows.push_back(VAR_AT_LOWER);
+}
+
+// Reads a number that may also be inf or -inf
+static double ReadBound(std::istream &in) {
+    std::string token;
+    in >> token;
+    return strtod(token.c_str(), NULL);
+}
+
+/*
+    Reads one LP: n, m and the number of nonzeros k, then k triples "i j a_ij" with 1-indexed
+    i and j, then b_1 ... b_m, c_1 ... c_n, and finally a pair "l_j u_j" of bounds for each
+    variable, where inf and -inf stand for no bound.
+*/
+void ReadLinearProgram(std::istream &in, LinearProgram &lp) {
+    uint32_t cols, rows;
+    size_t nonzeros;
+    in >> cols >> rows >> nonzeros;
+
+    vector<Triple> entries(nonzeros);
+    for (size_t k = 0; k < nonzeros; k++) {
+        in >> entries[k].row >> entries[k].col >> entries[k].value;
+        entries[k].row--;
+        entries[k].col--;
+    }
+    lp.A = CompressColumns(rows, cols, entries);
+
+    lp.b.resize(rows);
+    for (uint32_t i = 0; i < rows; i++) {
+        in >> lp.b[i];
+    }
+    lp.c.resize(cols);
+    for (uint32_t j = 0; j < cols; j++) {
+        in >> lp.c[j];
+    }
+    lp.lower.resize(cols);
+    lp.upper.resize(cols);
+    for (uint32_t j = 0; j < cols; j++) {
+        lp.lower[j] = ReadBound(in);
+        lp.upper[j] = ReadBound(in);
+    }
+}
+
+// Values this close to 0 are printed as 0
+#define PRINT_ZERO 1e-9
+
+static void WriteVector(std::ostream &out, const char *name, const vector<double> &v) {
+    out << name;
+    for (vector<double>::const_iterator it = v.begin(); it != v.end(); it++) {
+        out << " " << ((fabs(*it) < PRINT_ZERO) ? 0. : *it);
+    }
+    out << "\n";
+}
+
+/*
+    Writes OPTIMAL and the objective followed by lines "x ...", "y ..." and "d ..." with the
+    primal solution, duals and reduced costs, or just INFEASIBLE, UNBOUNDED or SINGULAR. A checked
+    solution ends with VERIFIED or NOT VERIFIED.
+*/
+void WriteSolution(std::ostream &out, const LPSolution &solution) {
+    if (solution.status == LP_INFEASIBLE) {
+        out << "INFEASIBLE\n";
+        return;
+    }
+    if (solution.status == LP_UNBOUNDED) {
+        out << "UNBOUNDED\n";
+        return;
+    }
+    if (solution.status == LP_SINGULAR) {
+        out << "SINGULAR\n";
+        return;
+    }
+    std::streamsize precision = out.precision(9);
+    out << "OPTIMAL " << ((fabs(solution.objective) < PRINT_ZERO) ? 0. : solution.objective) << "\n";
+    WriteVector(out, "x", solution.x);
+    WriteVector(out, "y", solution.y);
+    WriteVector(out, "d", solution.reducedCosts);
+    if (solution.checked) {
+        out << (solution.verified ? "VERIFIED\n" : "NOT VERIFIED\n");
+    }
+    out.precision(precision);
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <iostream>
+#include <math.h>
+#include <vector>
+#include "RevisedSimplex.h"
+#include "SparseMatrix.h"
+
+using std::vector;
+
+/*
+    max c^Tx subject to Ax = b, lower <= x <= upper.
+    Bounds may be -HUGE_VAL / HUGE_VAL for none.
+*/
+typedef struct LinearProgram {
+    SparseMatrix A;
+    vector<double> b, c;
+    vector<double> lower, upper;
+} LinearProgram;
+
+/*
+    Where a variable sits in a basis. Nonbasic variables are at a bound, or at 0 if they
+    have none (VAR_FREE).
+*/
+enum VariableStatus { VAR_BASIC, VAR_AT_LOWER, VAR_AT_UPPER, VAR_FREE };
+
+/*
+    Optimal basis of an LP, in terms of its own variables so that it stays meaningful after
+    the LP is modified.
+        columns - status of each variable
+        rows - VAR_BASIC for a redundant row that keeps its artificial basic, else VAR_AT_LOWER
+*/
+typedef struct LPBasis {
+    vector<VariableStatus> columns, rows;
+} LPBasis;
+
+/*
+    Result of SolveLP. x, y, reducedCosts and basis are only set for LP_OPTIMAL.
+        x - primal solution
+        y - dual values of the rows of Ax = b
+        reducedCosts - c_j - y^Ta_j
+        basis - optimal basis, to warm start the next solve from
+        pivots - simplex pivots; after the barrier, those of its crossover
+        iterations - barrier iterations, 0 for the simplex method
+        checked, verified - whether the basis was checked in exact arithmetic (see
+        VerifyBasis), and found primal and dual feasible
+*/
+typedef struct LPSolution {
+    LPStatus status;
+    double objective;
+    vector<double> x, y, reducedCosts;
+    LPBasis basis;
+    uint32_t pivots;
+    uint32_t iterations = 0;
+    bool checked = false, verified = false;
+} LPSolution;
+
+/*
+    Numerical settings of SolveLP.
+        tolerances - see Tolerances
+        scale - solve the LP scaled by ScaleLP, and unscale its solution
+        verify - check an optimal basis with VerifyBasis
+        barrier - solve with the interior point method and cross over to a basis (see
+        SolveBarrier) instead of running phase one
+        threads - threads for the barrier's factorisations
+*/
+typedef struct LPSettings {
+    Tolerances tolerances;
+    bool scale = false, verify = false, barrier = false;
+    uint32_t threads = 1;
+} LPSettings;
+
+LPSolution SolveLP(const LinearProgram &, PricingRule = PRICING_STEEPEST_EDGE, const LPBasis * = NULL,
+    const LPSettings & = LPSettings());
+bool VerifyBasis(const LinearProgram &, const LPBasis &);
+void AddRow(LinearProgram &, const SparseVector &, double, LPBasis &);
+void ReadLinearProgram(std::istream &, LinearProgram &);
+void WriteSolution(std::ostream &, const LPSolution &);
@@ -0,0 +1,592 @@
+/**
+    Implementation of the simplex basis factorisation
+**/
+
+#include "LUFactor.h"
+#include "Stats.h"
+
+#define NONE UINT32_MAX
+
+/*
+    The active columns (or rows) of the kernel during elimination, in doubly linked lists by
+    their number of active entries, so that the Markowitz search can start from the sparsest.
+*/
+class CountLists {
+public:
+    CountLists(size_t items, size_t counts) : head(counts + 1, NONE), next(items), prev(items), count(items) {}
+
+    void Insert(uint32_t x, uint32_t c) {
+        count[x] = c;
+        prev[x] = NONE;
+        next[x] = head[c];
+        if (head[c] != NONE) {
+            prev[head[c]] = x;
+        }
+        head[c] = x;
+    }
+
+    void Remove(uint32_t x) {
+        if (prev[x] != NONE) {
+            next[prev[x]] = next[x];
+        }
+        else {
+            head[count[x]] = next[x];
+        }
+        if (next[x] != NONE) {
+            prev[next[x]] = prev[x];
+        }
+    }
+
+    void Move(uint32_t x, uint32_t c) {
+        Remove(x);
+        Insert(x, c);
+    }
+
+    vector<uint32_t> head, next, prev, count;
+};
+
+// Removes the first x from v, not keeping the order
+static void Erase(vector<uint32_t> &v, uint32_t x) {
+    vector<uint32_t>::iterator it = std::find(v.begin(), v.end(), x);
+    *it = v.back();
+    v.pop_back();
+}
+
+/*
+    Factorises the basis whose column at position k is column basis[k] of A. Discards all
+    etas. Returns false if the basis is (numerically) singular; SingularPositions() and
+    SingularRows() then tell which columns depend on the others and which rows they leave
+    without a pivot.
+
+    param[in]: A - CSC constraint matrix; must outlive the factorisation
+    param[in]: basis - the A.rows basis columns
+*/
+bool LUFactor::Factor(const SparseMatrix &A, const vector<uint32_t> &basis) {
+    rows = A.rows;
+    matrix = &A;
+    columns = basis;
+    etas.clear();
+    singularPositions.clear();
+    singularRows.clear();
+
+    // claim a pivot row for every column with a single nonzero
+    vector<bool> claimed(rows, false);
+    singletonRow.assign(rows, NOT_SINGLETON);
+    singletonValue.assign(rows, 0.);
+    kernelPositions.clear();
+    for (uint32_t k = 0; k < rows; k++) {
+        uint32_t first = A.start[columns[k]];
+        if (A.start[columns[k] + 1] - first == 1 && !claimed[A.index[first]] &&
+            fabs(A.value[first]) > LU_PIVOT_TOLERANCE) {
+            singletonRow[k] = A.index[first];
+            singletonValue[k] = A.value[first];
+            claimed[A.index[first]] = true;
+        }
+        else {
+            kernelPositions.push_back(k);
+        }
+    }
+
+    kernelRows.clear();
+    rowToKernel.assign(rows, NOT_SINGLETON);
+    for (uint32_t i = 0; i < rows; i++) {
+        if (!claimed[i]) {
+            rowToKernel[i] = static_cast<uint32_t>(kernelRows.size());
+            kernelRows.push_back(i);
+        }
+    }
+
+    if (kernelRows.size() != kernelPositions.size()) {
+        return false;
+    }
+    return FactorKernel();
+}
+
+/*
+    Sparse LU of the kernel with Markowitz pivoting, until the rest is dense enough for
+    FactorDense. The active part of the kernel is kept by column with values and by row as a
+    pattern. Each pivot is searched for from the sparsest columns and rows up: among the
+    entries at least MARKOWITZ_THRESHOLD of their column's largest, the one of least
+    (r_i - 1)(c_j - 1), once MARKOWITZ_SEARCH columns or rows have offered one, or once no
+    entry not yet looked at can do better. Columns left empty or with only entries below
+    LU_PIVOT_TOLERANCE are singular.
+*/
+bool LUFactor::FactorKernel() {
+    STATS_PHASE("LUFactor");
+    const SparseMatrix &A = *matrix;
+    uint32_t k = static_cast<uint32_t>(kernelPositions.size());
+    vector<vector<uint32_t>> colRows(k), rowCols(k);
+    vector<vector<double>> colValues(k);
+    size_t active = 0;
+    for (uint32_t c = 0; c < k; c++) {
+        uint32_t j = columns[kernelPositions[c]];
+        for (uint32_t e = A.start[j]; e < A.start[j + 1]; e++) {
+            uint32_t r = rowToKernel[A.index[e]];
+            if (r != NOT_SINGLETON) {
+                colRows[c].push_back(r);
+                colValues[c].push_back(A.value[e]);
+                rowCols[r].push_back(c);
+                active++;
+            }
+        }
+    }
+    CountLists cols(k, k), rowLists(k, k);
+    for (uint32_t c = 0; c < k; c++) {
+        cols.Insert(c, static_cast<uint32_t>(colRows[c].size()));
+    }
+    for (uint32_t r = 0; r < k; r++) {
+        rowLists.Insert(r, static_cast<uint32_t>(rowCols[r].size()));
+    }
+
+    pivotRow.clear();
+    pivotCol.clear();
+    pivotValue.clear();
+    lStart.assign(1, 0);
+    uStart.assign(1, 0);
+    lIndex.clear();
+    lValue.clear();
+    uIndex.clear();
+    uValue.clear();
+    denseRows.clear();
+    denseCols.clear();
+    denseLU.clear();
+    perm.clear();
+
+    auto largest = [&](uint32_t c) {
+        double m = 0.;
+        for (vector<double>::iterator it = colValues[c].begin(); it != colValues[c].end(); it++) {
+            m = std::max(m, fabs(*it));
+        }
+        return m;
+    };
+    // drops column c, whose entries cannot pivot, as singular
+    auto singular = [&](uint32_t c) {
+        cols.Remove(c);
+        for (vector<uint32_t>::iterator it = colRows[c].begin(); it != colRows[c].end(); it++) {
+            Erase(rowCols[*it], c);
+            rowLists.Move(*it, static_cast<uint32_t>(rowCols[*it].size()));
+        }
+        active -= colRows[c].size();
+        colRows[c].clear();
+        colValues[c].clear();
+        singularPositions.push_back(kernelPositions[c]);
+    };
+
+    vector<uint32_t> where(k, NONE);
+    uint64_t remainingCols = k, remainingRows = k;
+    while (remainingCols > 0) {
+        while (cols.head[0] != NONE) {
+            singular(cols.head[0]);
+            remainingCols--;
+        }
+        if (remainingCols == 0) {
+            break;
+        }
+        if (active >= DENSE_KERNEL_DENSITY * remainingCols * remainingRows) {
+            FactorDense(colRows, colValues);
+            break;
+        }
+
+        // Markowitz search
+        uint32_t pr = NONE, pc = NONE, searched = 0, dropped = NONE;
+        uint64_t best = UINT64_MAX;
+        double pivot = 0.;
+        for (uint64_t count = 1; count <= k && dropped == NONE; count++) {
+            for (uint32_t c = cols.head[count]; c != NONE && searched < MARKOWITZ_SEARCH; c = cols.next[c]) {
+                double m = largest(c);
+                if (m < LU_PIVOT_TOLERANCE) {
+                    dropped = c;
+                    break;
+                }
+                for (uint32_t e = 0; e < colRows[c].size(); e++) {
+                    uint64_t cost = (rowLists.count[colRows[c][e]] - 1) * (count - 1);
+                    if (fabs(colValues[c][e]) >= MARKOWITZ_THRESHOLD * m && cost < best) {
+                        best = cost;
+                        pr = colRows[c][e];
+                        pc = c;
+                        pivot = colValues[c][e];
+                    }
+                }
+                searched++;
+            }
+            if (dropped != NONE || (pc != NONE && (searched >= MARKOWITZ_SEARCH || best <= (count - 1) * count))) {
+                break;
+            }
+            for (uint32_t r = rowLists.head[count]; r != NONE && searched < MARKOWITZ_SEARCH; r = rowLists.next[r]) {
+                bool offered = false;
+                for (vector<uint32_t>::iterator c = rowCols[r].begin(); c != rowCols[r].end(); c++) {
+                    uint32_t e = static_cast<uint32_t>(std::find(colRows[*c].begin(), colRows[*c].end(), r) - colRows[*c].begin());
+                    double m = largest(*c);
+                    if (m < LU_PIVOT_TOLERANCE || fabs(colValues[*c][e]) < MARKOWITZ_THRESHOLD * m) {
+                        continue;
+                    }
+                    offered = true;
+                    uint64_t cost = (count - 1) * (cols.count[*c] - 1);
+                    if (cost < best) {
+                        best = cost;
+                        pr = r;
+                        pc = *c;
+                        pivot = colValues[*c][e];
+                    }
+                }
+                searched += offered;
+            }
+            if (pc != NONE && (searched >= MARKOWITZ_SEARCH || best <= count * count)) {
+                break;
+            }
+        }
+        if (dropped != NONE) {
+            singular(dropped);
+            remainingCols--;
+            continue;
+        }
+
+        STATS_COUNT("markowitzPivots", 1);
+        pivotRow.push_back(pr);
+        pivotCol.push_back(pc);
+        pivotValue.push_back(pivot);
+        cols.Remove(pc);
+        rowLists.Remove(pr);
+        remainingCols--;
+        remainingRows--;
+
+        // the multipliers: the rest of the pivot column, which leaves the rows
+        size_t firstL = lIndex.size();
+        for (uint32_t e = 0; e < colRows[pc].size(); e++) {
+            uint32_t i = colRows[pc][e];
+            if (i != pr) {
+                lIndex.push_back(i);
+                lValue.push_back(colValues[pc][e] / pivot);
+                Erase(rowCols[i], pc);
+            }
+        }
+        lStart.push_back(static_cast<uint32_t>(lIndex.size()));
+        active -= colRows[pc].size();
+        colRows[pc].clear();
+        colValues[pc].clear();
+
+        // the rest of the pivot row, taken out of its columns, which then get a_ij -= l_i u_j
+        for (vector<uint32_t>::iterator c = rowCols[pr].begin(); c != rowCols[pr].end(); c++) {
+            if (*c == pc) {
+                continue;
+            }
+            vector<uint32_t> &rowsOf = colRows[*c];
+            vector<double> &valuesOf = colValues[*c];
+            size_t e = std::find(rowsOf.begin(), rowsOf.end(), pr) - rowsOf.begin();
+            double u = valuesOf[e];
+            rowsOf[e] = rowsOf.back();
+            rowsOf.pop_back();
+            valuesOf[e] = valuesOf.back();
+            valuesOf.pop_back();
+            active--;
+            uIndex.push_back(*c);
+            uValue.push_back(u);
+
+            for (uint32_t q = 0; q < rowsOf.size(); q++) {
+                where[rowsOf[q]] = q;
+            }
+            for (size_t l = firstL; l < lIndex.size(); l++) {
+                uint32_t i = lIndex[l];
+                if (where[i] != NONE) {
+                    valuesOf[where[i]] -= lValue[l] * u;
+                }
+                else {
+                    rowsOf.push_back(i);
+                    valuesOf.push_back(-lValue[l] * u);
+                    rowCols[i].push_back(*c);
+                    active++;
+                }
+            }
+            for (uint32_t q = 0; q < rowsOf.size(); q++) {
+                where[rowsOf[q]] = NONE;
+            }
+            cols.Move(*c, static_cast<uint32_t>(rowsOf.size()));
+        }
+        uStart.push_back(static_cast<uint32_t>(uIndex.size()));
+        rowCols[pr].clear();
+        for (size_t l = firstL; l < lIndex.size(); l++) {
+            rowLists.Move(lIndex[l], static_cast<uint32_t>(rowCols[lIndex[l]].size()));
+        }
+    }
+
+    // rows that no pivot took
+    if (denseCols.empty()) {
+        for (uint32_t count = 0; count <= k; count++) {
+            for (uint32_t r = rowLists.head[count]; r != NONE; r = rowLists.next[r]) {
+                singularRows.push_back(kernelRows[r]);
+            }
+        }
+    }
+    return singularPositions.empty();
+}
+
+/*
+    Dense LU with partial pivoting of the active part of the kernel left by FactorKernel,
+    PS = LU with L unit lower triangular stored below the diagonal. A column without a pivot
+    is skipped, so that a singular basis reports all of its dependent columns and the rows
+    they leave uncovered.
+*/
+void LUFactor::FactorDense(const vector<vector<uint32_t>> &colRows, const vector<vector<double>> &colValues) {
+    uint32_t k = static_cast<uint32_t>(kernelPositions.size());
+    vector<uint32_t> denseIndex(k, NONE);
+    vector<bool> pivoted(k, false);
+    for (vector<uint32_t>::iterator it = pivotRow.begin(); it != pivotRow.end(); it++) {
+        pivoted[*it] = true;
+    }
+    for (uint32_t r = 0; r < k; r++) {
+        if (!pivoted[r]) {
+            denseIndex[r] = static_cast<uint32_t>(denseRows.size());
+            denseRows.push_back(r);
+        }
+    }
+    for (uint32_t c = 0; c < k; c++) {
+        if (!colRows[c].empty()) {
+            denseCols.push_back(c);
+        }
+    }
+
+    size_t n = denseRows.size(), d = denseCols.size();
+    STATS_COUNT("denseKernel", d);
+    denseLU.assign(n * d, 0.);
+    for (size_t c = 0; c < d; c++) {
+        const vector<uint32_t> &rowsOf = colRows[denseCols[c]];
+        for (size_t e = 0; e < rowsOf.size(); e++) {
+            denseLU[denseIndex[rowsOf[e]] * d + c] = colValues[denseCols[c]][e];
+        }
+    }
+
+    perm.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        perm[i] = static_cast<uint32_t>(i);
+    }
+    size_t r = 0;
+    for (size_t j = 0; j < d; j++) {
+        size_t p = r;
+        for (size_t i = r + 1; i < n; i++) {
+            if (fabs(denseLU[i * d + j]) > fabs(denseLU[p * d + j])) {
+                p = i;
+            }
+        }
+        if (fabs(denseLU[p * d + j]) < LU_PIVOT_TOLERANCE) {
+            singularPositions.push_back(kernelPositions[denseCols[j]]);
+            continue;
+        }
+        if (p != r) {
+            std::swap_ranges(denseLU.begin() + p * d, denseLU.begin() + (p + 1) * d, denseLU.begin() + r * d);
+            std::swap(perm[p], perm[r]);
+        }
+
+        double pivot = denseLU[r * d + j];
+        for (size_t i = r + 1; i < n; i++) {
+            double l = denseLU[i * d + j] / pivot;
+            denseLU[i * d + j] = l;
+            if (l != 0.) {
+                for (size_t c = j + 1; c < d; c++) {
+                    denseLU[i * d + c] -= l * denseLU[r * d + c];
+                }
+            }
+        }
+        r++;
+    }
+    for (size_t i = r; i < n; i++) {
+        singularRows.push_back(kernelRows[denseRows[perm[i]]]);
+    }
+}
+
+/*
+    Solves Kz = a for the kernel. On entry a is indexed by kernel row, on return z holds
+    the solution indexed by kernel column; a is overwritten.
+*/
+void LUFactor::SolveKernel(vector<double> &a, vector<double> &z) {
+    size_t steps = pivotRow.size();
+    for (size_t s = 0; s < steps; s++) {
+        double v = a[pivotRow[s]];
+        if (v != 0.) {
+            for (uint32_t l = lStart[s]; l < lStart[s + 1]; l++) {
+                a[lIndex[l]] -= lValue[l] * v;
+            }
+        }
+    }
+
+    size_t d = denseCols.size();
+    if (d > 0) {
+        vector<double> t(d);
+        for (size_t i = 0; i < d; i++) {
+            t[i] = a[denseRows[perm[i]]];
+        }
+        for (size_t i = 0; i < d; i++) {
+            for (size_t j = 0; j < i; j++) {
+                t[i] -= denseLU[i * d + j] * t[j];
+            }
+        }
+        for (size_t i = d; i-- > 0;) {
+            for (size_t j = i + 1; j < d; j++) {
+                t[i] -= denseLU[i * d + j] * t[j];
+            }
+            t[i] /= denseLU[i * d + i];
+        }
+        for (size_t c = 0; c < d; c++) {
+            z[denseCols[c]] = t[c];
+        }
+    }
+
+    for (size_t s = steps; s-- > 0;) {
+        double sum = a[pivotRow[s]];
+        for (uint32_t u = uStart[s]; u < uStart[s + 1]; u++) {
+            sum -= uValue[u] * z[uIndex[u]];
+        }
+        z[pivotCol[s]] = sum / pivotValue[s];
+    }
+}
+
+/*
+    Solves K^Tv = w for the kernel. On entry w is indexed by kernel column, on return v holds
+    the solution indexed by kernel row; w is overwritten.
+*/
+void LUFactor::SolveKernelTransposed(vector<double> &w, vector<double> &v) {
+    size_t steps = pivotRow.size();
+    for (size_t s = 0; s < steps; s++) {
+        double z = w[pivotCol[s]] / pivotValue[s];
+        v[pivotRow[s]] = z;
+        if (z != 0.) {
+            for (uint32_t u = uStart[s]; u < uStart[s + 1]; u++) {
+                w[uIndex[u]] -= uValue[u] * z;
+            }
+        }
+    }
+
+    // S^T = U^T L^T P
+    size_t d = denseCols.size();
+    if (d > 0) {
+        vector<double> t(d);
+        for (size_t c = 0; c < d; c++) {
+            t[c] = w[denseCols[c]];
+        }
+        for (size_t i = 0; i < d; i++) {
+            for (size_t j = 0; j < i; j++) {
+                t[i] -= denseLU[j * d + i] * t[j];
+            }
+            t[i] /= denseLU[i * d + i];
+        }
+        for (size_t i = d; i-- > 0;) {
+            for (size_t j = i + 1; j < d; j++) {
+                t[i] -= denseLU[j * d + i] * t[j];
+            }
+        }
+        for (size_t i = 0; i < d; i++) {
+            v[denseRows[perm[i]]] = t[i];
+        }
+    }
+
+    for (size_t s = steps; s-- > 0;) {
+        double sum = v[pivotRow[s]];
+        for (uint32_t l = lStart[s]; l < lStart[s + 1]; l++) {
+            sum -= lValue[l] * v[lIndex[l]];
+        }
+        v[pivotRow[s]] = sum;
+    }
+}
+
+/*
+    Solves Bz = x. On entry x is indexed by row, on return it holds z indexed by position.
+*/
+void LUFactor::FTRAN(vector<double> &x) {
+    vector<double> z(rows, 0.);
+    size_t k = kernelPositions.size();
+
+    if (k > 0) {
+        vector<double> a(k), solution(k);
+        for (size_t i = 0; i < k; i++) {
+            a[i] = x[kernelRows[i]];
+        }
+        SolveKernel(a, solution);
+
+        // move the kernel columns' entries in singleton rows to the right hand side
+        for (size_t c = 0; c < k; c++) {
+            z[kernelPositions[c]] = solution[c];
+            if (solution[c] == 0.) {
+                continue;
+            }
+            uint32_t j = columns[kernelPositions[c]];
+            for (uint32_t e = matrix->start[j]; e < matrix->start[j + 1]; e++) {
+                if (rowToKernel[matrix->index[e]] == NOT_SINGLETON) {
+                    x[matrix->index[e]] -= matrix->value[e] * solution[c];
+                }
+            }
+        }
+    }
+
+    for (uint32_t p = 0; p < rows; p++) {
+        if (singletonRow[p] != NOT_SINGLETON) {
+            z[p] = x[singletonRow[p]] / singletonValue[p];
+        }
+    }
+
+    for (vector<Eta>::iterator eta = etas.begin(); eta != etas.end(); eta++) {
+        double zp = z[eta->position] / eta->pivot;
+        z[eta->position] = zp;
+        if (zp != 0.) {
+            for (SparseVector::iterator it = eta->column.begin(); it != eta->column.end(); it++) {
+                z[it->first] -= it->second * zp;
+            }
+        }
+    }
+
+    x.swap(z);
+}
+
+/*
+    Solves y^T B = w^T. On entry w is indexed by position, on return it holds y indexed by row.
+*/
+void LUFactor::BTRAN(vector<double> &w) {
+    for (vector<Eta>::reverse_iterator eta = etas.rbegin(); eta != etas.rend(); eta++) {
+        double sum = w[eta->position];
+        for (SparseVector::iterator it = eta->column.begin(); it != eta->column.end(); it++) {
+            sum -= w[it->first] * it->second;
+        }
+        w[eta->position] = sum / eta->pivot;
+    }
+
+    vector<double> y(rows, 0.);
+    for (uint32_t p = 0; p < rows; p++) {
+        if (singletonRow[p] != NOT_SINGLETON) {
+            y[singletonRow[p]] = w[p] / singletonValue[p];
+        }
+    }
+
+    size_t k = kernelPositions.size();
+    if (k > 0) {
+        vector<double> s(k), v(k);
+        for (size_t c = 0; c < k; c++) {
+            s[c] = w[kernelPositions[c]];
+            uint32_t j = columns[kernelPositions[c]];
+            for (uint32_t e = matrix->start[j]; e < matrix->start[j + 1]; e++) {
+                if (rowToKernel[matrix->index[e]] == NOT_SINGLETON) {
+                    s[c] -= y[matrix->index[e]] * matrix->value[e];
+                }
+            }
+        }
+        SolveKernelTransposed(s, v);
+        for (size_t i = 0; i < k; i++) {
+            y[kernelRows[i]] = v[i];
+        }
+    }
+
+    w.swap(y);
+}
+
+/*
+    Records the replacement of the column at position p by a column a with
+    alpha = B^{-1}a (indexed by position, as returned by FTRAN).
+*/
+void LUFactor::Update(uint32_t p, const vector<double> &alpha) {
+    Eta eta;
+    eta.position = p;
+    eta.pivot = alpha[p];
+    for (uint32_t i = 0; i < rows; i++) {
+        if (i != p && fabs(alpha[i]) > ETA_DROP_TOLERANCE) {
+            eta.column.push_back(pair<uint32_t, double>(i, alpha[i]));
+        }
+    }
+    etas.push_back(eta);
+}
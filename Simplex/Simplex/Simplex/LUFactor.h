@@ -0,0 +1,106 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <math.h>
+#include <utility>
+#include <vector>
+#include "SparseMatrix.h"
+
+using std::pair;
+using std::vector;
+
+// (position, value) pairs of the nonzeros of an eta column
+typedef vector<pair<uint32_t, double>> SparseVector;
+
+#define NOT_SINGLETON UINT32_MAX
+// Kernel pivots smaller than this in absolute value mean the basis is singular
+#define LU_PIVOT_TOLERANCE 1e-11
+// Eta entries smaller than this in absolute value are dropped
+#define ETA_DROP_TOLERANCE 1e-14
+// Sparse kernel pivots must be at least this fraction of the largest entry of their column
+#define MARKOWITZ_THRESHOLD 0.1
+// Columns and rows offering a pivot that the Markowitz search looks at before taking the best
+#define MARKOWITZ_SEARCH 4
+// The rest of the kernel is factorised dense once this fraction of its entries are nonzero
+#define DENSE_KERNEL_DENSITY 0.3
+
+/*
+    LU factorisation of a simplex basis B with product-form updates.
+
+    Columns of B with a single nonzero in a row not claimed by another such column
+    (slack and artificial columns, typically most of the basis) are eliminated directly.
+    After permuting those rows and columns first, B has the block form
+        [ D  E ]
+        [ 0  K ]
+    with D diagonal, and only the kernel K is factorised. That is by sparse LU with Markowitz
+    pivoting: each pivot is the entry of least (r_i - 1)(c_j - 1) among those large enough
+    for stability, so the kernel's own column and row singletons, its triangular parts, go
+    first without any fill-in. Once what is left of the kernel is DENSE_KERNEL_DENSITY full,
+    it is finished by dense LU with partial pivoting. The dense part takes memory in the
+    square of its size and time in the cube: a 100k row basis, half of it slacks and the
+    structural columns with 3 to 4 random nonzeros, leaves about 1000 dense rows and factors
+    in well under a second, but with no slacks in it the fill-in leaves about 10000 (0.8 GB,
+    minutes). Kernels that fill in like that are beyond this factorisation.
+
+    Each basis change appends an eta vector so that B_k^{-1} = E_k ... E_1 B_0^{-1}; the
+    caller refactorises once EtaCount() reaches its limit.
+
+    Vectors indexed "by position" are indexed by the basis position 0..m-1 of a column,
+    vectors indexed "by row" by the constraint row.
+*/
+class LUFactor {
+
+    class Eta {
+    public:
+        uint32_t position;
+        double pivot;
+        SparseVector column;    // alpha_i for i != position
+    };
+
+public:
+    LUFactor() : rows(0), matrix(NULL) {};
+    bool Factor(const SparseMatrix &, const vector<uint32_t> &);
+    void FTRAN(vector<double> &);
+    void BTRAN(vector<double> &);
+    void Update(uint32_t, const vector<double> &);
+    size_t EtaCount() { return etas.size(); }
+    size_t KernelSize() { return kernelPositions.size(); }
+    // size of the part of the kernel factorised dense
+    size_t DenseSize() { return denseCols.size(); }
+    // after Factor fails: the dependent basis positions, and as many rows without a pivot
+    const vector<uint32_t> &SingularPositions() { return singularPositions; }
+    const vector<uint32_t> &SingularRows() { return singularRows; }
+
+private:
+    bool FactorKernel();
+    void FactorDense(const vector<vector<uint32_t>> &, const vector<vector<double>> &);
+    void SolveKernel(vector<double> &, vector<double> &);
+    void SolveKernelTransposed(vector<double> &, vector<double> &);
+
+    uint32_t rows;
+    // the basis is columns[k] of *matrix at position k
+    const SparseMatrix *matrix;
+    vector<uint32_t> columns;
+
+    // singleton part: for each position, its pivot row and value, or NOT_SINGLETON
+    vector<uint32_t> singletonRow;
+    vector<double> singletonValue;
+
+    // kernel part: kernel index -> basis position / row, and row -> kernel index
+    vector<uint32_t> kernelPositions, kernelRows, rowToKernel;
+    // sparse LU of the kernel, one step per pivot: its kernel row and column and value, the
+    // multipliers of the rest of its column (lIndex by kernel row) and the rest of its row
+    // (uIndex by kernel column), from lStart[s] and uStart[s]
+    vector<uint32_t> pivotRow, pivotCol;
+    vector<double> pivotValue;
+    vector<uint32_t> lStart, lIndex, uStart, uIndex;
+    vector<double> lValue, uValue;
+    // dense LU of what is left of the kernel after the sparse steps, row-major, PS = LU with
+    // the row permutation perm of denseRows; denseCols are the kernel columns it solves for
+    vector<uint32_t> denseRows, denseCols, perm;
+    vector<double> denseLU;
+    vector<uint32_t> singularPositions, singularRows;
+
+    vector<Eta> etas;
+};
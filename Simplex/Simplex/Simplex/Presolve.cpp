@@ -0,0 +1,700 @@
+/**
+    Presolve and postsolve of linear programs
+**/
+
+#include <functional>
+#include <map>
+#include <queue>
+#include "Presolve.h"
+#include "Stats.h"
+
+/*
+    Finds the rows that are linear combinations of earlier rows, by sparse LU of the rows in
+    order: each row is reduced by the pivot rows before it and then becomes a pivot row itself,
+    pivoting on its largest entry, unless nothing significant is left of it. Only the rows
+    of U are kept; the multipliers of L are not needed.
+
+    Returns false if the right hand side of a dependent row does not reduce to 0 along with
+    it, i.e. the system is inconsistent.
+
+    param[in]: rows - (column, value) entries of each row
+    param[out]: dependent - dependent rows in increasing order
+*/
+bool DependentRows(const vector<SparseVector> &rows, const vector<double> &rhs, uint32_t cols,
+    vector<uint32_t> &dependent) {
+    vector<SparseVector> U;
+    vector<double> U_rhs, work(cols, 0.);
+    vector<uint32_t> pivotCol, pivotOf(cols, KEPT), pattern;
+    vector<bool> touched(cols, false);
+
+    for (uint32_t r = 0; r < rows.size(); r++) {
+        // a pivot row has zeros in the pivot columns of earlier pivot rows, so eliminating
+        // them in the order they were created never brings back a column already cleared
+        std::priority_queue<uint32_t, vector<uint32_t>, std::greater<uint32_t>> pending;
+        double scale = 0., residual = rhs[r], rhsScale = fabs(rhs[r]);
+        for (SparseVector::const_iterator it = rows[r].begin(); it != rows[r].end(); it++) {
+            if (!touched[it->first]) {
+                touched[it->first] = true;
+                pattern.push_back(it->first);
+                if (pivotOf[it->first] != KEPT) {
+                    pending.push(pivotOf[it->first]);
+                }
+            }
+            work[it->first] += it->second;
+            scale = std::max(scale, fabs(it->second));
+        }
+        while (!pending.empty()) {
+            uint32_t k = pending.top();
+            pending.pop();
+            double f = work[pivotCol[k]];
+            if (f == 0.) {
+                continue;
+            }
+            for (SparseVector::const_iterator it = U[k].begin(); it != U[k].end(); it++) {
+                if (!touched[it->first]) {
+                    touched[it->first] = true;
+                    pattern.push_back(it->first);
+                    if (pivotOf[it->first] != KEPT) {
+                        pending.push(pivotOf[it->first]);
+                    }
+                }
+                work[it->first] -= f * it->second;
+            }
+            work[pivotCol[k]] = 0.;
+            residual -= f * U_rhs[k];
+            rhsScale += fabs(f * U_rhs[k]);
+        }
+
+        uint32_t p = KEPT;
+        for (vector<uint32_t>::iterator it = pattern.begin(); it != pattern.end(); it++) {
+            if (pivotOf[*it] == KEPT && (p == KEPT || fabs(work[*it]) > fabs(work[p]))) {
+                p = *it;
+            }
+        }
+        bool consistent = true;
+        if (p == KEPT || fabs(work[p]) <= DEPENDENT_ROW_TOLERANCE * scale) {
+            dependent.push_back(r);
+            consistent = fabs(residual) <= PRESOLVE_TOLERANCE * (1. + rhsScale);
+        }
+        else {
+            SparseVector row;
+            for (vector<uint32_t>::iterator it = pattern.begin(); it != pattern.end(); it++) {
+                if (pivotOf[*it] == KEPT && fabs(work[*it]) > ETA_DROP_TOLERANCE * scale) {
+                    row.push_back(std::make_pair(*it, work[*it] / work[p]));
+                }
+            }
+            pivotOf[p] = static_cast<uint32_t>(U.size());
+            pivotCol.push_back(p);
+            U.push_back(row);
+            U_rhs.push_back(residual / work[p]);
+        }
+
+        for (vector<uint32_t>::iterator it = pattern.begin(); it != pattern.end(); it++) {
+            work[*it] = 0.;
+            touched[*it] = false;
+        }
+        pattern.clear();
+        if (!consistent) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+    Applies the presolve reductions to a copy of an LP's data, keeping the row and column
+    counts of the entries that are left, and logs each step for postsolve.
+*/
+class Presolver {
+public:
+    Presolver(const LinearProgram &, Presolved &);
+    bool Run();
+    void Reduced(const vector<uint32_t> &, const vector<uint32_t> &, LinearProgram &);
+
+private:
+    bool FixedColumns(bool &);
+    bool Rows(bool &);
+    bool ColumnSingletons(bool &);
+    void EmptyColumns(bool &);
+    bool DuplicateRows(bool &);
+    bool Dependencies();
+    void Activity(uint32_t, uint32_t, double &, double &, uint32_t &, uint32_t &);
+    void RemoveRow(uint32_t);
+    void RemoveColumn(uint32_t, double);
+    void Log(const Reduction &r) { reductions.push_back(r); }
+    uint32_t Step() { return static_cast<uint32_t>(reductions.size()) - 1; }
+
+    const LinearProgram &lp;
+    // A by column (lp.A) and by row
+    const SparseMatrix &A;
+    SparseMatrix rowwise;
+    vector<double> b, c, lower, upper;
+    vector<uint32_t> rowCount, colCount;
+    // rows that have implied a bound, which each does at most once (see ColumnSingletons)
+    vector<bool> boundRow;
+    vector<Reduction> &reductions;
+    vector<uint32_t> &rowRemoved, &colRemoved;
+};
+
+Presolver::Presolver(const LinearProgram &program, Presolved &out) :
+    lp(program),
+    A(program.A),
+    rowwise(Transpose(program.A)),
+    b(program.b),
+    c(program.c),
+    lower(program.lower),
+    upper(program.upper),
+    rowCount(program.A.rows),
+    colCount(program.A.cols),
+    boundRow(program.A.rows, false),
+    reductions(out.reductions),
+    rowRemoved(out.rowRemoved),
+    colRemoved(out.colRemoved)
+{
+    rowRemoved.assign(A.rows, KEPT);
+    colRemoved.assign(A.cols, KEPT);
+    for (uint32_t i = 0; i < A.rows; i++) {
+        rowCount[i] = rowwise.start[i + 1] - rowwise.start[i];
+    }
+    for (uint32_t j = 0; j < A.cols; j++) {
+        colCount[j] = A.start[j + 1] - A.start[j];
+    }
+}
+
+// Removes row i at the current step
+void Presolver::RemoveRow(uint32_t i) {
+    rowRemoved[i] = Step();
+    for (uint32_t k = rowwise.start[i]; k < rowwise.start[i + 1]; k++) {
+        colCount[rowwise.index[k]]--;
+    }
+}
+
+// Removes column j at the current step with x_j fixed at value, moving it into b
+void Presolver::RemoveColumn(uint32_t j, double value) {
+    colRemoved[j] = Step();
+    for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+        uint32_t i = A.index[k];
+        if (rowRemoved[i] == KEPT) {
+            b[i] -= A.value[k] * value;
+            rowCount[i]--;
+        }
+    }
+}
+
+/*
+    Smallest and largest value of the active part of row i over the bounds, leaving out
+    column skip. Infinite contributions are counted in minInf and maxInf instead.
+*/
+void Presolver::Activity(uint32_t i, uint32_t skip, double &minAct, double &maxAct, uint32_t &minInf,
+    uint32_t &maxInf) {
+    minAct = maxAct = 0.;
+    minInf = maxInf = 0;
+    for (uint32_t k = rowwise.start[i]; k < rowwise.start[i + 1]; k++) {
+        uint32_t j = rowwise.index[k];
+        double a = rowwise.value[k];
+        if (colRemoved[j] != KEPT || j == skip) {
+            continue;
+        }
+        double low = (a > 0.) ? lower[j] : upper[j], high = (a > 0.) ? upper[j] : lower[j];
+        if (fabs(low) == HUGE_VAL) {
+            minInf++;
+        }
+        else {
+            minAct += a * low;
+        }
+        if (fabs(high) == HUGE_VAL) {
+            maxInf++;
+        }
+        else {
+            maxAct += a * high;
+        }
+    }
+}
+
+// Variables with equal bounds; returns false if a variable's bounds cross
+bool Presolver::FixedColumns(bool &changed) {
+    for (uint32_t j = 0; j < A.cols; j++) {
+        if (colRemoved[j] != KEPT || lower[j] == -HUGE_VAL) {
+            continue;
+        }
+        double tol = PRESOLVE_TOLERANCE * (1. + fabs(lower[j]));
+        if (upper[j] < lower[j] - tol) {
+            return false;
+        }
+        if (upper[j] <= lower[j] + tol) {
+            Reduction r = { FIXED_COLUMN, KEPT, j, lower[j], {}, {}, {} };
+            Log(r);
+            RemoveColumn(j, lower[j]);
+            changed = true;
+        }
+    }
+    return true;
+}
+
+/*
+    Empty rows, singleton rows, which fix their variable, and rows whose activity bounds
+    show they are infeasible or forcing. Returns false if the LP is infeasible.
+*/
+bool Presolver::Rows(bool &changed) {
+    for (uint32_t i = 0; i < A.rows; i++) {
+        if (rowRemoved[i] != KEPT) {
+            continue;
+        }
+        double tol = PRESOLVE_TOLERANCE * (1. + fabs(lp.b[i]) + fabs(b[i]));
+
+        if (rowCount[i] == 0) {
+            if (fabs(b[i]) > tol) {
+                return false;
+            }
+            Reduction r = { EMPTY_ROW, i, KEPT, 0., {}, {}, {} };
+            Log(r);
+            RemoveRow(i);
+            changed = true;
+            continue;
+        }
+
+        if (rowCount[i] == 1) {
+            uint32_t k = rowwise.start[i];
+            while (colRemoved[rowwise.index[k]] != KEPT) {
+                k++;
+            }
+            uint32_t j = rowwise.index[k];
+            double value = b[i] / rowwise.value[k];
+            if (value < lower[j] - PRESOLVE_TOLERANCE * (1. + fabs(lower[j])) ||
+                value > upper[j] + PRESOLVE_TOLERANCE * (1. + fabs(upper[j]))) {
+                return false;
+            }
+            value = std::min(std::max(value, lower[j]), upper[j]);
+            Reduction r = { SINGLETON_ROW, i, j, value, {}, {}, { c[j] } };
+            Log(r);
+            RemoveRow(i);
+            RemoveColumn(j, value);
+            changed = true;
+            continue;
+        }
+
+        double minAct, maxAct;
+        uint32_t minInf, maxInf;
+        Activity(i, KEPT, minAct, maxAct, minInf, maxInf);
+        if ((minInf == 0 && minAct > b[i] + tol) || (maxInf == 0 && maxAct < b[i] - tol)) {
+            return false;
+        }
+        // forcing: b_i can only be reached with every variable at the bound that gives the
+        // smallest (or largest) activity
+        bool atMin = minInf == 0 && minAct >= b[i] - tol, atMax = !atMin && maxInf == 0 && maxAct <= b[i] + tol;
+        if (atMin || atMax) {
+            Reduction r = { FORCING_ROW, i, KEPT, atMin ? 1. : -1., {}, {}, {} };
+            for (uint32_t k = rowwise.start[i]; k < rowwise.start[i + 1]; k++) {
+                uint32_t j = rowwise.index[k];
+                if (colRemoved[j] == KEPT) {
+                    r.cols.push_back(j);
+                    r.values.push_back(((rowwise.value[k] > 0.) == atMin) ? lower[j] : upper[j]);
+                    r.costs.push_back(c[j]);
+                }
+            }
+            Log(r);
+            RemoveRow(i);
+            for (uint32_t q = 0; q < r.cols.size(); q++) {
+                RemoveColumn(r.cols[q], r.values[q]);
+            }
+            changed = true;
+        }
+    }
+    return true;
+}
+
+/*
+    A variable in a single row whose bounds the row implies anyway (including a free one) is
+    determined by the row: both are removed, and the variable is substituted out of the objective.
+
+    If the row implies only one of its bounds, and that one is tighter than the variable's
+    own, it replaces it; this can make a free variable bounded, and the row's activity bounds
+    finite. A row tightens at most one bound, so that Postsolve, which may have to move the
+    row's dual to undo the bound, never moves it twice. Returns false if an implied bound
+    crosses the other bound, which makes the LP infeasible.
+*/
+bool Presolver::ColumnSingletons(bool &changed) {
+    for (uint32_t j = 0; j < A.cols; j++) {
+        if (colRemoved[j] != KEPT || colCount[j] != 1) {
+            continue;
+        }
+        uint32_t k = A.start[j];
+        while (rowRemoved[A.index[k]] != KEPT) {
+            k++;
+        }
+        uint32_t i = A.index[k];
+        double a = A.value[k];
+
+        double minAct, maxAct;
+        uint32_t minInf, maxInf;
+        Activity(i, j, minAct, maxAct, minInf, maxInf);
+        double impliedLower, impliedUpper;
+        if (a > 0.) {
+            impliedLower = (maxInf > 0) ? -HUGE_VAL : (b[i] - maxAct) / a;
+            impliedUpper = (minInf > 0) ? HUGE_VAL : (b[i] - minAct) / a;
+        }
+        else {
+            impliedLower = (minInf > 0) ? -HUGE_VAL : (b[i] - minAct) / a;
+            impliedUpper = (maxInf > 0) ? HUGE_VAL : (b[i] - maxAct) / a;
+        }
+        if (impliedLower < lower[j] || impliedUpper > upper[j]) {
+            bool tighterLower = impliedLower > lower[j] + PRESOLVE_TOLERANCE * (1. + fabs(impliedLower)),
+                tighterUpper = impliedUpper < upper[j] - PRESOLVE_TOLERANCE * (1. + fabs(impliedUpper));
+            if (!boundRow[i] && (tighterLower || tighterUpper)) {
+                double tol = PRESOLVE_TOLERANCE * (1. + fabs(tighterLower ? upper[j] : lower[j]));
+                if ((tighterLower && impliedLower > upper[j] + tol) || (tighterUpper && impliedUpper < lower[j] - tol)) {
+                    return false;
+                }
+                Reduction r = { IMPLIED_BOUND, i, j, 0., {}, { lower[j], upper[j] }, { c[j] } };
+                Log(r);
+                if (tighterLower) {
+                    lower[j] = std::min(impliedLower, upper[j]);
+                }
+                else {
+                    upper[j] = std::max(impliedUpper, lower[j]);
+                }
+                boundRow[i] = true;
+                changed = true;
+            }
+            continue;
+        }
+
+        Reduction r = { COLUMN_SINGLETON, i, j, b[i], {}, {}, { c[j] } };
+        Log(r);
+        for (uint32_t q = rowwise.start[i]; q < rowwise.start[i + 1]; q++) {
+            if (colRemoved[rowwise.index[q]] == KEPT && rowwise.index[q] != j) {
+                c[rowwise.index[q]] -= c[j] * rowwise.value[q] / a;
+            }
+        }
+        RemoveRow(i);
+        RemoveColumn(j, 0.);
+        changed = true;
+    }
+    return true;
+}
+
+// Variables in no row go to the bound their cost prefers; those that could grow forever are left to the solver
+void Presolver::EmptyColumns(bool &changed) {
+    for (uint32_t j = 0; j < A.cols; j++) {
+        if (colRemoved[j] != KEPT || colCount[j] != 0) {
+            continue;
+        }
+        double value;
+        if (c[j] > 0.) {
+            value = upper[j];
+        }
+        else if (c[j] < 0.) {
+            value = lower[j];
+        }
+        else {
+            value = (lower[j] > -HUGE_VAL) ? lower[j] : ((upper[j] < HUGE_VAL) ? upper[j] : 0.);
+        }
+        if (fabs(value) == HUGE_VAL) {
+            continue;
+        }
+        Reduction r = { FIXED_COLUMN, KEPT, j, value, {}, {}, {} };
+        Log(r);
+        RemoveColumn(j, value);
+        changed = true;
+    }
+}
+
+/*
+    Rows that are multiples of an earlier row, found among rows with the same pattern of
+    active columns. Returns false if one's right hand side is not the same multiple.
+*/
+bool Presolver::DuplicateRows(bool &changed) {
+    std::map<vector<uint32_t>, vector<uint32_t>> byPattern;
+    for (uint32_t i = 0; i < A.rows; i++) {
+        if (rowRemoved[i] != KEPT) {
+            continue;
+        }
+        vector<uint32_t> pattern;
+        for (uint32_t k = rowwise.start[i]; k < rowwise.start[i + 1]; k++) {
+            if (colRemoved[rowwise.index[k]] == KEPT) {
+                pattern.push_back(rowwise.index[k]);
+            }
+        }
+        byPattern[pattern].push_back(i);
+    }
+
+    for (std::map<vector<uint32_t>, vector<uint32_t>>::iterator group = byPattern.begin(); group != byPattern.end();
+        group++) {
+        // rows left empty by this round are for Rows in the next one
+        if (group->first.empty()) {
+            continue;
+        }
+        vector<uint32_t> &rows = group->second;
+        for (uint32_t p = 1; p < rows.size(); p++) {
+            uint32_t k = rows[p];
+            for (uint32_t q = 0; q < p && rowRemoved[k] == KEPT; q++) {
+                uint32_t i = rows[q];
+                if (rowRemoved[i] != KEPT) {
+                    continue;
+                }
+                // both rows list the same active columns in the same order
+                vector<double> a_i, a_k;
+                for (uint32_t e = rowwise.start[i]; e < rowwise.start[i + 1]; e++) {
+                    if (colRemoved[rowwise.index[e]] == KEPT) {
+                        a_i.push_back(rowwise.value[e]);
+                    }
+                }
+                for (uint32_t e = rowwise.start[k]; e < rowwise.start[k + 1]; e++) {
+                    if (colRemoved[rowwise.index[e]] == KEPT) {
+                        a_k.push_back(rowwise.value[e]);
+                    }
+                }
+                double ratio = a_k[0] / a_i[0];
+                bool multiple = true;
+                for (uint32_t e = 1; e < a_i.size() && multiple; e++) {
+                    multiple = fabs(a_k[e] - ratio * a_i[e]) <= PRESOLVE_TOLERANCE * fabs(a_k[e]);
+                }
+                if (!multiple) {
+                    continue;
+                }
+                if (fabs(b[k] - ratio * b[i]) > PRESOLVE_TOLERANCE * (1. + fabs(b[k]))) {
+                    return false;
+                }
+                Reduction r = { DUPLICATE_ROW, k, KEPT, ratio, {}, {}, {} };
+                Log(r);
+                RemoveRow(k);
+                changed = true;
+            }
+        }
+    }
+    return true;
+}
+
+// Rows left that are combinations of others (see DependentRows)
+bool Presolver::Dependencies() {
+    vector<SparseVector> rows;
+    vector<double> rhs;
+    vector<uint32_t> active, dependent;
+    for (uint32_t i = 0; i < A.rows; i++) {
+        if (rowRemoved[i] != KEPT) {
+            continue;
+        }
+        SparseVector row;
+        for (uint32_t k = rowwise.start[i]; k < rowwise.start[i + 1]; k++) {
+            if (colRemoved[rowwise.index[k]] == KEPT) {
+                row.push_back(std::make_pair(rowwise.index[k], rowwise.value[k]));
+            }
+        }
+        rows.push_back(row);
+        rhs.push_back(b[i]);
+        active.push_back(i);
+    }
+    if (!DependentRows(rows, rhs, A.cols, dependent)) {
+        return false;
+    }
+    for (vector<uint32_t>::iterator it = dependent.begin(); it != dependent.end(); it++) {
+        Reduction r = { DEPENDENT_ROW, active[*it], KEPT, 0., {}, {}, {} };
+        Log(r);
+        RemoveRow(active[*it]);
+    }
+    return true;
+}
+
+// Applies the reductions until none applies. Returns false if the LP is infeasible.
+bool Presolver::Run() {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        if (!FixedColumns(changed) || !Rows(changed)) {
+            return false;
+        }
+        if (!ColumnSingletons(changed)) {
+            return false;
+        }
+        EmptyColumns(changed);
+        if (!DuplicateRows(changed)) {
+            return false;
+        }
+    }
+    return Dependencies();
+}
+
+// Fills in b, c and the bounds of the reduced LP, whose rows and columns are rowMap and colMap
+void Presolver::Reduced(const vector<uint32_t> &rowMap, const vector<uint32_t> &colMap, LinearProgram &reduced) {
+    reduced.b.clear();
+    for (vector<uint32_t>::const_iterator it = rowMap.begin(); it != rowMap.end(); it++) {
+        reduced.b.push_back(b[*it]);
+    }
+    reduced.c.clear();
+    reduced.lower.clear();
+    reduced.upper.clear();
+    for (vector<uint32_t>::const_iterator it = colMap.begin(); it != colMap.end(); it++) {
+        reduced.c.push_back(c[*it]);
+        reduced.lower.push_back(lower[*it]);
+        reduced.upper.push_back(upper[*it]);
+    }
+}
+
+/*
+    Shrinks lp before it is solved: removes empty rows, fixes variables with equal bounds and
+    those of singleton rows, uses the activity bounds of each row to detect infeasible and
+    forcing rows and to find column singletons whose bounds are implied, which are
+    substituted out, or to tighten their bounds, puts variables in no row at their best
+    bound, and removes duplicate rows and, by sparse LU, rows that are combinations of others.
+
+    Returns false if presolve finds lp infeasible. Otherwise out.lp is the reduced LP and
+    out holds what Postsolve needs to map its solution back.
+*/
+bool Presolve(const LinearProgram &lp, Presolved &out) {
+    STATS_PHASE("Presolve");
+    out.reductions.clear();
+    Presolver presolver(lp, out);
+    if (!presolver.Run()) {
+        return false;
+    }
+
+    // renumber what is left
+    vector<uint32_t> newRow(lp.A.rows, KEPT), newCol(lp.A.cols, KEPT);
+    out.rowMap.clear();
+    out.colMap.clear();
+    for (uint32_t i = 0; i < lp.A.rows; i++) {
+        if (out.rowRemoved[i] == KEPT) {
+            newRow[i] = static_cast<uint32_t>(out.rowMap.size());
+            out.rowMap.push_back(i);
+        }
+    }
+    for (uint32_t j = 0; j < lp.A.cols; j++) {
+        if (out.colRemoved[j] == KEPT) {
+            newCol[j] = static_cast<uint32_t>(out.colMap.size());
+            out.colMap.push_back(j);
+        }
+    }
+
+    LinearProgram &reduced = out.lp;
+    vector<Triple> entries;
+    for (uint32_t j = 0; j < lp.A.cols; j++) {
+        for (uint32_t k = lp.A.start[j]; k < lp.A.start[j + 1] && newCol[j] != KEPT; k++) {
+            if (newRow[lp.A.index[k]] != KEPT) {
+                Triple t = { newRow[lp.A.index[k]], newCol[j], lp.A.value[k] };
+                entries.push_back(t);
+            }
+        }
+    }
+    reduced.A = CompressColumns(static_cast<uint32_t>(out.rowMap.size()), static_cast<uint32_t>(out.colMap.size()),
+        entries);
+    presolver.Reduced(out.rowMap, out.colMap, reduced);
+    return true;
+}
+
+/*
+    Sum of v_i a_ij over the entries of column j of M whose row i was still present at the
+    given step, leaving out row skip, whose entry is returned in a_skip. With M = A^T this
+    sums over a row of A instead.
+*/
+static double ActiveDot(const SparseMatrix &M, const vector<uint32_t> &removed, const vector<double> &v, uint32_t j,
+    uint32_t skip, uint32_t step, double &a_skip) {
+    double sum = 0.;
+    for (uint32_t k = M.start[j]; k < M.start[j + 1]; k++) {
+        uint32_t i = M.index[k];
+        if (i == skip) {
+            a_skip = M.value[k];
+        }
+        else if (removed[i] == KEPT || removed[i] > step) {
+            sum += v[i] * M.value[k];
+        }
+    }
+    return sum;
+}
+
+/*
+    Maps the solution of the reduced LP back to lp by undoing the presolve steps in reverse
+    order. Each step restores the variables it fixed or substituted out and the duals of the
+    rows it removed, so that the reduced costs of lp have the signs its bounds need.
+    The basis is not set, so the result cannot warm start SolveLP, and checked and verified
+    are those of the reduced LP's basis.
+*/
+LPSolution Postsolve(const LinearProgram &lp, const Presolved &presolved, const LPSolution &reduced) {
+    const SparseMatrix &A = lp.A;
+    LPSolution solution;
+    solution.status = reduced.status;
+    solution.pivots = reduced.pivots;
+    solution.checked = reduced.checked;
+    solution.verified = reduced.verified;
+    solution.objective = 0.;
+    if (reduced.status != LP_OPTIMAL) {
+        return solution;
+    }
+
+    SparseMatrix rowwise = Transpose(A);
+    vector<double> &x = solution.x, &y = solution.y;
+    x.assign(A.cols, 0.);
+    y.assign(A.rows, 0.);
+    for (uint32_t k = 0; k < presolved.colMap.size(); k++) {
+        x[presolved.colMap[k]] = reduced.x[k];
+    }
+    for (uint32_t k = 0; k < presolved.rowMap.size(); k++) {
+        y[presolved.rowMap[k]] = reduced.y[k];
+    }
+
+    for (uint32_t step = static_cast<uint32_t>(presolved.reductions.size()); step-- > 0;) {
+        const Reduction &r = presolved.reductions[step];
+        double a = 0.;
+        switch (r.type) {
+        case FIXED_COLUMN:
+            x[r.col] = r.value;
+            break;
+        case SINGLETON_ROW:
+            // the dual of the row makes the reduced cost of its variable 0
+            x[r.col] = r.value;
+            y[r.row] = (r.costs[0] - ActiveDot(A, presolved.rowRemoved, y, r.col, r.row, step, a)) / a;
+            break;
+        case FORCING_ROW:
+            // the dual of the row is the extreme ratio that gives every variable a reduced cost
+            // of the sign its bound needs
+            for (uint32_t q = 0; q < r.cols.size(); q++) {
+                x[r.cols[q]] = r.values[q];
+                double ratio = (r.costs[q] - ActiveDot(A, presolved.rowRemoved, y, r.cols[q], r.row, step, a)) / a;
+                if (q == 0 || (r.value > 0. ? ratio > y[r.row] : ratio < y[r.row])) {
+                    y[r.row] = ratio;
+                }
+            }
+            break;
+        case COLUMN_SINGLETON:
+            x[r.col] = (r.value - ActiveDot(rowwise, presolved.colRemoved, x, r.row, r.col, step, a)) / a;
+            y[r.row] = r.costs[0] / a;
+            break;
+        case IMPLIED_BOUND:
+            // a variable left at the implied bound but inside its own needs a reduced cost of 0,
+            // which the dual of the row gives it; the row's other variables are then at the
+            // bounds that imply it, where the change only moves their reduced costs the way
+            // those bounds allow
+            if (x[r.col] > r.values[0] + PRESOLVE_TOLERANCE * (1. + fabs(x[r.col])) &&
+                x[r.col] < r.values[1] - PRESOLVE_TOLERANCE * (1. + fabs(x[r.col]))) {
+                double others = ActiveDot(A, presolved.rowRemoved, y, r.col, r.row, step, a);
+                y[r.row] = (r.costs[0] - others) / a;
+            }
+            break;
+        default:
+            // empty, duplicate and dependent rows keep a dual of 0
+            break;
+        }
+    }
+
+    solution.reducedCosts.resize(A.cols);
+    for (uint32_t j = 0; j < A.cols; j++) {
+        solution.reducedCosts[j] = lp.c[j];
+        for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+            solution.reducedCosts[j] -= y[A.index[k]] * A.value[k];
+        }
+        solution.objective += lp.c[j] * x[j];
+    }
+    return solution;
+}
+
+// Presolve, SolveLP on the reduced LP and Postsolve
+LPSolution SolvePresolved(const LinearProgram &lp, PricingRule rule, const LPSettings &settings) {
+    Presolved presolved;
+    if (!Presolve(lp, presolved)) {
+        LPSolution solution;
+        solution.status = LP_INFEASIBLE;
+        solution.objective = 0.;
+        solution.pivots = 0;
+        return solution;
+    }
+    return Postsolve(lp, presolved, SolveLP(presolved.lp, rule, NULL, settings));
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "LPSolver.h"
+
+using std::vector;
+
+// Relative tolerance of presolve's feasibility and equality tests
+#define PRESOLVE_TOLERANCE 1e-9
+// A row is dependent if its largest entry after elimination is below this relative to its largest entry
+#define DEPENDENT_ROW_TOLERANCE 1e-9
+// Rows and columns that presolve keeps
+#define KEPT UINT32_MAX
+
+enum ReductionType {
+    FIXED_COLUMN,       // variable fixed at value, including empty columns put at their best bound
+    EMPTY_ROW,
+    SINGLETON_ROW,      // a_ij x_j = b_i fixes x_j at value
+    FORCING_ROW,        // every variable of row at the bound that gives the smallest (value 1) or largest (value -1) activity
+    COLUMN_SINGLETON,   // x_j only in row, and (implied) free: the row defines it, with value = b_i at the time
+    DUPLICATE_ROW,      // row is a multiple of another row
+    DEPENDENT_ROW,      // row is a linear combination of other rows
+    IMPLIED_BOUND       // x_j only in row, which implies a tighter lower or upper bound; values are its bounds before
+};
+
+/*
+    One presolve step, undone by Postsolve.
+        cols, values - variables the step fixed and their values (FORCING_ROW), or the bounds
+        of col before the step (IMPLIED_BOUND)
+        costs - objective coefficients of col (SINGLETON_ROW, COLUMN_SINGLETON, IMPLIED_BOUND)
+        or of cols (FORCING_ROW) when the step was taken
+*/
+typedef struct Reduction {
+    ReductionType type;
+    uint32_t row, col;
+    double value;
+    vector<uint32_t> cols;
+    vector<double> values, costs;
+} Reduction;
+
+/*
+    Result of Presolve.
+        lp - the reduced LP
+        reductions - steps in the order they were taken
+        rowRemoved, colRemoved - index of the step that removed each row and column, or KEPT
+        rowMap, colMap - original index of each row and column of lp
+*/
+typedef struct Presolved {
+    LinearProgram lp;
+    vector<Reduction> reductions;
+    vector<uint32_t> rowRemoved, colRemoved;
+    vector<uint32_t> rowMap, colMap;
+} Presolved;
+
+bool DependentRows(const vector<SparseVector> &, const vector<double> &, uint32_t, vector<uint32_t> &);
+bool Presolve(const LinearProgram &, Presolved &);
+LPSolution Postsolve(const LinearProgram &, const Presolved &, const LPSolution &);
+LPSolution SolvePresolved(const LinearProgram &, PricingRule = PRICING_STEEPEST_EDGE, const LPSettings & = LPSettings());
@@ -0,0 +1,386 @@
+/**
+    Arbitrary precision integers and exact rationals, for checking solutions exactly
+**/
+
+#include <algorithm>
+#include <math.h>
+#include "Rational.h"
+
+BigInt::BigInt(int64_t value) : negative(value < 0) {
+    uint64_t magnitude = negative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    while (magnitude != 0) {
+        digits.push_back(static_cast<uint32_t>(magnitude));
+        magnitude >>= 32;
+    }
+}
+
+// Drops leading zero digits and the sign of 0
+void BigInt::Trim() {
+    while (!digits.empty() && digits.back() == 0) {
+        digits.pop_back();
+    }
+    if (digits.empty()) {
+        negative = false;
+    }
+}
+
+int BigInt::CompareMagnitude(const vector<uint32_t> &a, const vector<uint32_t> &b) {
+    if (a.size() != b.size()) {
+        return (a.size() < b.size()) ? -1 : 1;
+    }
+    for (size_t k = a.size(); k-- > 0;) {
+        if (a[k] != b[k]) {
+            return (a[k] < b[k]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+vector<uint32_t> BigInt::AddMagnitude(const vector<uint32_t> &a, const vector<uint32_t> &b) {
+    const vector<uint32_t> &longer = (a.size() >= b.size()) ? a : b, &shorter = (a.size() >= b.size()) ? b : a;
+    vector<uint32_t> sum(longer.size() + 1);
+    uint64_t carry = 0;
+    for (size_t k = 0; k < longer.size(); k++) {
+        carry += static_cast<uint64_t>(longer[k]) + (k < shorter.size() ? shorter[k] : 0);
+        sum[k] = static_cast<uint32_t>(carry);
+        carry >>= 32;
+    }
+    sum[longer.size()] = static_cast<uint32_t>(carry);
+    return sum;
+}
+
+// a - b for |a| >= |b|
+vector<uint32_t> BigInt::SubtractMagnitude(const vector<uint32_t> &a, const vector<uint32_t> &b) {
+    vector<uint32_t> difference(a.size());
+    int64_t borrow = 0;
+    for (size_t k = 0; k < a.size(); k++) {
+        int64_t d = static_cast<int64_t>(a[k]) - borrow - (k < b.size() ? b[k] : 0);
+        borrow = (d < 0) ? 1 : 0;
+        difference[k] = static_cast<uint32_t>(d);
+    }
+    return difference;
+}
+
+/*
+    Long division of magnitudes, u = q v + r with 0 <= r < v (Knuth, TAOCP vol. 2, 4.3.1
+    algorithm D). v must not be 0.
+*/
+void BigInt::DivideMagnitude(const vector<uint32_t> &u, const vector<uint32_t> &v, vector<uint32_t> &q,
+    vector<uint32_t> &r) {
+    const uint64_t base = static_cast<uint64_t>(1) << 32;
+    if (CompareMagnitude(u, v) < 0) {
+        q.clear();
+        r = u;
+        return;
+    }
+    size_t n = v.size(), m = u.size() - n;
+    q.assign(m + 1, 0);
+    if (n == 1) {
+        uint64_t remainder = 0;
+        for (size_t k = u.size(); k-- > 0;) {
+            uint64_t current = (remainder << 32) | u[k];
+            q[k] = static_cast<uint32_t>(current / v[0]);
+            remainder = current % v[0];
+        }
+        r.assign(1, static_cast<uint32_t>(remainder));
+        return;
+    }
+
+    // normalise so that the top digit of v has its high bit set, which makes the estimate
+    // of each quotient digit at most 2 too large
+    uint32_t shift = 0;
+    while ((v[n - 1] << shift & 0x80000000u) == 0) {
+        shift++;
+    }
+    vector<uint32_t> vn(n), un(u.size() + 1);
+    for (size_t k = n; k-- > 0;) {
+        vn[k] = (v[k] << shift) | ((shift != 0 && k > 0) ? v[k - 1] >> (32 - shift) : 0);
+    }
+    un[u.size()] = (shift != 0) ? u[u.size() - 1] >> (32 - shift) : 0;
+    for (size_t k = u.size(); k-- > 0;) {
+        un[k] = (u[k] << shift) | ((shift != 0 && k > 0) ? u[k - 1] >> (32 - shift) : 0);
+    }
+
+    for (size_t j = m + 1; j-- > 0;) {
+        uint64_t numerator = (static_cast<uint64_t>(un[j + n]) << 32) | un[j + n - 1];
+        uint64_t qhat = numerator / vn[n - 1], rhat = numerator % vn[n - 1];
+        while (qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+            qhat--;
+            rhat += vn[n - 1];
+            if (rhat >= base) {
+                break;
+            }
+        }
+
+        // un[j..j+n] -= qhat * vn
+        int64_t borrow = 0;
+        uint64_t carry = 0;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t product = qhat * vn[i] + carry;
+            carry = product >> 32;
+            int64_t d = static_cast<int64_t>(un[i + j]) - borrow - static_cast<int64_t>(product & 0xffffffffu);
+            un[i + j] = static_cast<uint32_t>(d);
+            borrow = (d < 0) ? 1 : 0;
+        }
+        int64_t d = static_cast<int64_t>(un[j + n]) - borrow - static_cast<int64_t>(carry);
+        un[j + n] = static_cast<uint32_t>(d);
+
+        // qhat was one too large: add v back
+        if (d < 0) {
+            qhat--;
+            uint64_t sum = 0;
+            for (size_t i = 0; i < n; i++) {
+                sum += static_cast<uint64_t>(un[i + j]) + vn[i];
+                un[i + j] = static_cast<uint32_t>(sum);
+                sum >>= 32;
+            }
+            un[j + n] += static_cast<uint32_t>(sum);
+        }
+        q[j] = static_cast<uint32_t>(qhat);
+    }
+
+    r.resize(n);
+    for (size_t k = 0; k < n; k++) {
+        r[k] = (un[k] >> shift) | ((shift != 0) ? un[k + 1] << (32 - shift) : 0);
+    }
+}
+
+BigInt BigInt::operator-() const {
+    BigInt result = *this;
+    result.negative = !negative && !IsZero();
+    return result;
+}
+
+BigInt BigInt::operator+(const BigInt &other) const {
+    BigInt result;
+    if (negative == other.negative) {
+        result.digits = AddMagnitude(digits, other.digits);
+        result.negative = negative;
+    }
+    else if (CompareMagnitude(digits, other.digits) >= 0) {
+        result.digits = SubtractMagnitude(digits, other.digits);
+        result.negative = negative;
+    }
+    else {
+        result.digits = SubtractMagnitude(other.digits, digits);
+        result.negative = other.negative;
+    }
+    result.Trim();
+    return result;
+}
+
+BigInt BigInt::operator-(const BigInt &other) const {
+    return *this + (-other);
+}
+
+BigInt BigInt::operator*(const BigInt &other) const {
+    BigInt result;
+    if (IsZero() || other.IsZero()) {
+        return result;
+    }
+    result.digits.assign(digits.size() + other.digits.size(), 0);
+    for (size_t i = 0; i < digits.size(); i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < other.digits.size(); j++) {
+            carry += static_cast<uint64_t>(digits[i]) * other.digits[j] + result.digits[i + j];
+            result.digits[i + j] = static_cast<uint32_t>(carry);
+            carry >>= 32;
+        }
+        result.digits[i + other.digits.size()] = static_cast<uint32_t>(carry);
+    }
+    result.negative = negative != other.negative;
+    result.Trim();
+    return result;
+}
+
+// Quotient rounded toward 0
+BigInt BigInt::operator/(const BigInt &other) const {
+    BigInt q, r;
+    DivMod(*this, other, q, r);
+    return q;
+}
+
+BigInt BigInt::operator<<(uint32_t bits) const {
+    BigInt result;
+    if (IsZero()) {
+        return result;
+    }
+    uint32_t whole = bits / 32, shift = bits % 32;
+    result.digits.assign(whole, 0);
+    uint32_t carry = 0;
+    for (size_t k = 0; k < digits.size(); k++) {
+        result.digits.push_back((digits[k] << shift) | carry);
+        carry = (shift != 0) ? digits[k] >> (32 - shift) : 0;
+    }
+    result.digits.push_back(carry);
+    result.negative = negative;
+    result.Trim();
+    return result;
+}
+
+int BigInt::Compare(const BigInt &other) const {
+    if (negative != other.negative) {
+        return negative ? -1 : 1;
+    }
+    int magnitude = CompareMagnitude(digits, other.digits);
+    return negative ? -magnitude : magnitude;
+}
+
+/*
+    a = q b + r with q rounded toward 0, so r has the sign of a. b must not be 0.
+*/
+void BigInt::DivMod(const BigInt &a, const BigInt &b, BigInt &q, BigInt &r) {
+    q = BigInt();
+    r = BigInt();
+    DivideMagnitude(a.digits, b.digits, q.digits, r.digits);
+    q.negative = a.negative != b.negative;
+    r.negative = a.negative;
+    q.Trim();
+    r.Trim();
+}
+
+// Number of trailing zero bits; 0 for 0
+uint32_t BigInt::TrailingZeros() const {
+    uint32_t zeros = 0;
+    for (size_t k = 0; k < digits.size(); k++) {
+        if (digits[k] != 0) {
+            uint32_t digit = digits[k];
+            while ((digit & 1) == 0) {
+                digit >>= 1;
+                zeros++;
+            }
+            return zeros;
+        }
+        zeros += 32;
+    }
+    return 0;
+}
+
+BigInt BigInt::operator>>(uint32_t bits) const {
+    BigInt result;
+    uint32_t whole = bits / 32, shift = bits % 32;
+    for (size_t k = whole; k < digits.size(); k++) {
+        uint32_t high = (shift != 0 && k + 1 < digits.size()) ? digits[k + 1] << (32 - shift) : 0;
+        result.digits.push_back((digits[k] >> shift) | high);
+    }
+    result.negative = negative;
+    result.Trim();
+    return result;
+}
+
+/*
+    Greatest common divisor of |a| and |b|. The powers of 2 are split off first, as the
+    denominators that come from doubles are mostly powers of 2, then Euclid's algorithm runs
+    on the rest, in machine words once both fit.
+*/
+BigInt BigInt::Gcd(BigInt a, BigInt b) {
+    a.negative = b.negative = false;
+    if (a.IsZero() || b.IsZero()) {
+        return a.IsZero() ? b : a;
+    }
+    uint32_t za = a.TrailingZeros(), zb = b.TrailingZeros();
+    a = a >> za;
+    b = b >> zb;
+    while (!b.IsZero() && (a.digits.size() > 2 || b.digits.size() > 2)) {
+        BigInt q, r;
+        DivMod(a, b, q, r);
+        a = b;
+        b = r;
+    }
+    if (!b.IsZero()) {
+        uint64_t x = 0, y = 0;
+        for (size_t k = a.digits.size(); k-- > 0;) {
+            x = (x << 32) | a.digits[k];
+        }
+        for (size_t k = b.digits.size(); k-- > 0;) {
+            y = (y << 32) | b.digits[k];
+        }
+        while (y != 0) {
+            uint64_t t = x % y;
+            x = y;
+            y = t;
+        }
+        a.digits.assign(1, static_cast<uint32_t>(x));
+        a.digits.push_back(static_cast<uint32_t>(x >> 32));
+        a.Trim();
+    }
+    return a << std::min(za, zb);
+}
+
+// The exact value of a finite double
+Rational::Rational(double value) : num(0), den(1) {
+    int exponent;
+    double mantissa = frexp(value, &exponent);
+    // value = m 2^(exponent - 53) with m an integer of at most 53 bits
+    num = BigInt(static_cast<int64_t>(ldexp(mantissa, 53)));
+    exponent -= 53;
+    if (exponent >= 0) {
+        num = num << static_cast<uint32_t>(exponent);
+    }
+    else {
+        den = BigInt(1) << static_cast<uint32_t>(-exponent);
+        Reduce();
+    }
+}
+
+Rational::Rational(const BigInt &numerator, const BigInt &denominator) : num(numerator), den(denominator) {
+    if (den.Sign() < 0) {
+        num = -num;
+        den = -den;
+    }
+    Reduce();
+}
+
+void Rational::Reduce() {
+    if (num.IsZero()) {
+        den = BigInt(1);
+        return;
+    }
+    if (den.IsOne()) {
+        return;
+    }
+    BigInt g = BigInt::Gcd(num, den);
+    if (!g.IsOne()) {
+        num = num / g;
+        den = den / g;
+    }
+}
+
+Rational Rational::operator-() const {
+    Rational result = *this;
+    result.num = -num;
+    return result;
+}
+
+Rational Rational::operator+(const Rational &other) const {
+    if (IsZero()) {
+        return other;
+    }
+    if (other.IsZero()) {
+        return *this;
+    }
+    if (den == other.den) {
+        return Rational(num + other.num, den);
+    }
+    return Rational(num * other.den + other.num * den, den * other.den);
+}
+
+Rational Rational::operator-(const Rational &other) const {
+    return *this + (-other);
+}
+
+Rational Rational::operator*(const Rational &other) const {
+    if (IsZero() || other.IsZero()) {
+        return Rational();
+    }
+    return Rational(num * other.num, den * other.den);
+}
+
+// other must not be 0
+Rational Rational::operator/(const Rational &other) const {
+    return Rational(num * other.den, den * other.num);
+}
+
+int Rational::Compare(const Rational &other) const {
+    return (num * other.den).Compare(other.num * den);
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+/*
+    Arbitrary precision integer: a sign and the magnitude as base 2^32 digits, least
+    significant first, without leading zeros (0 has no digits and is never negative).
+*/
+class BigInt {
+public:
+    BigInt(int64_t = 0);
+    bool IsZero() const { return digits.empty(); }
+    int Sign() const { return IsZero() ? 0 : (negative ? -1 : 1); }
+    bool IsOne() const { return !negative && digits.size() == 1 && digits[0] == 1; }
+    BigInt operator-() const;
+    BigInt operator+(const BigInt &) const;
+    BigInt operator-(const BigInt &) const;
+    BigInt operator*(const BigInt &) const;
+    BigInt operator/(const BigInt &) const;
+    BigInt operator<<(uint32_t) const;
+    BigInt operator>>(uint32_t) const;
+    uint32_t TrailingZeros() const;
+    bool operator==(const BigInt &other) const { return negative == other.negative && digits == other.digits; }
+    int Compare(const BigInt &) const;
+
+    static BigInt Gcd(BigInt, BigInt);
+    static void DivMod(const BigInt &, const BigInt &, BigInt &, BigInt &);
+
+private:
+    void Trim();
+    static int CompareMagnitude(const vector<uint32_t> &, const vector<uint32_t> &);
+    static vector<uint32_t> AddMagnitude(const vector<uint32_t> &, const vector<uint32_t> &);
+    static vector<uint32_t> SubtractMagnitude(const vector<uint32_t> &, const vector<uint32_t> &);
+    static void DivideMagnitude(const vector<uint32_t> &, const vector<uint32_t> &, vector<uint32_t> &,
+        vector<uint32_t> &);
+
+    bool negative;
+    vector<uint32_t> digits;
+};
+
+/*
+    Exact rational number num / den in lowest terms, with den > 0. Every finite double
+    converts exactly.
+*/
+class Rational {
+public:
+    Rational() : num(0), den(1) {}
+    explicit Rational(double);
+    Rational(const BigInt &, const BigInt &);
+    bool IsZero() const { return num.IsZero(); }
+    int Sign() const { return num.Sign(); }
+    const BigInt &Numerator() const { return num; }
+    const BigInt &Denominator() const { return den; }
+    Rational operator-() const;
+    Rational operator+(const Rational &) const;
+    Rational operator-(const Rational &) const;
+    Rational operator*(const Rational &) const;
+    Rational operator/(const Rational &) const;
+    int Compare(const Rational &) const;
+    bool operator==(const Rational &other) const { return num == other.num && den == other.den; }
+
+private:
+    void Reduce();
+
+    BigInt num, den;
+};
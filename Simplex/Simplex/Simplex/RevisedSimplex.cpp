@@ -0,0 +1,479 @@
+/**
+    Implementation of the revised simplex method
+**/
+
+#include "RevisedSimplex.h"
+#include "Stats.h"
+
+const char *const pricingRuleNames[PRICING_RULE_COUNT] = { "bland", "dantzig", "partial", "devex", "steepest" };
+
+/*
+    param[in]: constraints - CSC constraint matrix; must outlive the solver
+    param[in]: rhs - right hand side; must outlive the solver
+    param[in]: tol - see Tolerances
+*/
+RevisedSimplex::RevisedSimplex(const SparseMatrix &constraints, const vector<double> &rhs, const Tolerances &tol) :
+    pivots(0),
+    pricing(PRICING_BLAND),
+    enterLimit(constraints.cols),
+    tolerances(tol),
+    rows(constraints.rows),
+    A(constraints),
+    rowwise(Transpose(constraints)),
+    b(rhs),
+    bScale(1.),
+    partialStart(0)
+{
+    for (vector<double>::const_iterator it = b.begin(); it != b.end(); it++) {
+        bScale = std::max(bScale, 1. + fabs(*it));
+    }
+    unitColumn.assign(rows, NONBASIC);
+    for (uint32_t j = A.cols; j-- > 0;) {
+        uint32_t k = A.start[j];
+        if (A.start[j + 1] - k == 1 && fabs(A.value[k]) > LU_PIVOT_TOLERANCE) {
+            unitColumn[A.index[k]] = j;
+        }
+    }
+}
+
+/*
+    Starts from the basis basic, with the remaining variables in the order given by nonbasic.
+    Returns false if the basis is singular.
+*/
+bool RevisedSimplex::SetBasis(const vector<uint32_t> &basic, const vector<uint32_t> &nonbasic) {
+    B = basic;
+    B_comp = nonbasic;
+    position.assign(A.cols, NONBASIC);
+    compIndex.assign(A.cols, NONBASIC);
+    for (uint32_t p = 0; p < rows; p++) {
+        position[B[p]] = p;
+    }
+    for (uint32_t j = 0; j < B_comp.size(); j++) {
+        compIndex[B_comp[j]] = j;
+    }
+    return Refactor();
+}
+
+// Factorise the current basis from scratch and recompute x_B = B^{-1}b
+bool RevisedSimplex::Refactor() {
+    STATS_COUNT("refactorizations", 1);
+    if (!lu.Factor(A, B)) {
+        return false;
+    }
+    x_B = b;
+    lu.FTRAN(x_B);
+    return true;
+}
+
+/*
+    Called after Refactor fails: replaces each basic column that depends on the others by the
+    unit column of a row left without a pivot, whose variable cannot be basic already, and
+    refactorises. The variables taken out become nonbasic at 0, so x_B changes and may lose
+    primal or dual feasibility. Returns false if a row has no unit column.
+*/
+bool RevisedSimplex::RepairBasis() {
+    STATS_COUNT("basisRepairs", 1);
+    vector<uint32_t> singular = lu.SingularPositions(), uncovered = lu.SingularRows();
+    for (uint32_t i = 0; i < singular.size(); i++) {
+        uint32_t s = singular[i], t = unitColumn[uncovered[i]];
+        if (t == NONBASIC) {
+            return false;
+        }
+        uint32_t leaving = B[s];
+        B_comp[compIndex[t]] = leaving;
+        compIndex[leaving] = compIndex[t];
+        compIndex[t] = NONBASIC;
+        position[leaving] = NONBASIC;
+        position[t] = s;
+        B[s] = t;
+    }
+    return Refactor();
+}
+
+double RevisedSimplex::ColumnDot(const vector<double> &y, uint32_t j) {
+    double sum = 0.;
+    for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+        sum += y[A.index[k]] * A.value[k];
+    }
+    return sum;
+}
+
+/*
+    Row p of the tableau B^{-1}A. Computed as rho^T A with rho = B^{-1}e_p, a row at a time,
+    so only the rows of A where rho is nonzero are touched.
+*/
+vector<double> RevisedSimplex::TableauRow(uint32_t p) {
+    vector<double> rho(rows, 0.);
+    rho[p] = 1.;
+    lu.BTRAN(rho);
+
+    vector<double> row(A.cols, 0.);
+    for (uint32_t i = 0; i < rows; i++) {
+        if (rho[i] != 0.) {
+            for (uint32_t k = rowwise.start[i]; k < rowwise.start[i + 1]; k++) {
+                row[rowwise.index[k]] += rho[i] * rowwise.value[k];
+            }
+        }
+    }
+    return row;
+}
+
+// Dual values y^T = c_B^T B^{-1}, indexed by row
+vector<double> RevisedSimplex::Duals(const vector<double> &c) {
+    vector<double> y(rows);
+    for (uint32_t p = 0; p < rows; p++) {
+        y[p] = c[B[p]];
+    }
+    lu.BTRAN(y);
+    return y;
+}
+
+double RevisedSimplex::Objective(const vector<double> &c) {
+    double value = 0.;
+    for (uint32_t p = 0; p < rows; p++) {
+        value += c[B[p]] * x_B[p];
+    }
+    return value;
+}
+
+/*
+    Reduced cost c_j - y^Ta_j of column j. Sets improving if it is positive relative to the
+    size of the terms it is computed from.
+*/
+double RevisedSimplex::ReducedCost(const vector<double> &c, const vector<double> &y, uint32_t j,
+    bool &improving) {
+    double d = c[j], magnitude = fabs(c[j]);
+    for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+        d -= y[A.index[k]] * A.value[k];
+        magnitude += fabs(y[A.index[k]] * A.value[k]);
+    }
+    improving = d > tolerances.dual * (1. + magnitude);
+    return d;
+}
+
+/*
+    Chooses the entering variable under the pricing rule, or returns NONBASIC if no
+    reduced cost is positive.
+
+    param[in]: bland - use Bland's rule regardless of the pricing rule
+*/
+uint32_t RevisedSimplex::Price(const vector<double> &c, const vector<double> &y, bool bland) {
+    uint32_t variables = std::min(enterLimit, A.cols);
+    uint32_t best = NONBASIC;
+    double bestScore = 0.;
+    bool improving;
+
+    if (bland) {
+        for (uint32_t j = 0; j < variables; j++) {
+            if (position[j] == NONBASIC) {
+                ReducedCost(c, y, j, improving);
+                if (improving) {
+                    return j;
+                }
+            }
+        }
+        return NONBASIC;
+    }
+
+    // partial pricing scans a segment at a time from where the last scan stopped, and only
+    // moves on to the next segment if this one has no candidate
+    uint32_t segment = variables;
+    if (pricing == PRICING_PARTIAL) {
+        segment = std::max(variables / PARTIAL_PRICING_SEGMENTS, std::min(variables, PARTIAL_PRICING_MIN));
+    }
+    uint32_t j = (pricing == PRICING_PARTIAL) ? partialStart % variables : 0;
+    for (uint32_t scanned = 1; scanned <= variables; scanned++, j = (j + 1 == variables) ? 0 : j + 1) {
+        if (position[j] == NONBASIC) {
+            double d = ReducedCost(c, y, j, improving);
+            if (improving) {
+                double score = (pricing == PRICING_DANTZIG || pricing == PRICING_PARTIAL) ? d : d * d / weight[j];
+                if (best == NONBASIC || score > bestScore) {
+                    best = j;
+                    bestScore = score;
+                }
+            }
+        }
+        if (scanned % segment == 0 && best != NONBASIC) {
+            partialStart = j + 1;
+            break;
+        }
+    }
+    return best;
+}
+
+/*
+    Updates the devex or steepest edge weights for the basis change that brings t in at
+    position s. Must be called before Pivot, with alpha = B^{-1}a_t for the current basis.
+*/
+void RevisedSimplex::UpdateWeights(uint32_t s, uint32_t t, const vector<double> &alpha) {
+    vector<double> row = TableauRow(s);
+    double pivot = alpha[s];
+
+    if (pricing == PRICING_DEVEX) {
+        // reference framework weights: w_j = max(w_j, (alpha_sj / alpha_st)^2 w_t)
+        double w_t = weight[t];
+        for (uint32_t j = 0; j < A.cols; j++) {
+            if (position[j] == NONBASIC && j != t && row[j] != 0.) {
+                double ratio = row[j] / pivot;
+                weight[j] = std::max(weight[j], ratio * ratio * w_t);
+            }
+        }
+        weight[B[s]] = std::max(w_t / (pivot * pivot), 1.);
+    }
+    else {
+        // exact weights gamma_j = 1 + |B^{-1}a_j|^2, updated by the Goldfarb-Reid recurrence
+        // gamma_j = max(gamma_j - 2 r_j a_j^T B^{-T} alpha + r_j^2 gamma_t, 1 + r_j^2), r_j = alpha_sj / alpha_st
+        double gamma_t = 1.;
+        for (uint32_t p = 0; p < rows; p++) {
+            gamma_t += alpha[p] * alpha[p];
+        }
+        vector<double> w = alpha;
+        lu.BTRAN(w);
+        for (uint32_t j = 0; j < A.cols; j++) {
+            if (position[j] == NONBASIC && j != t && row[j] != 0.) {
+                double ratio = row[j] / pivot;
+                weight[j] = std::max(weight[j] - 2. * ratio * ColumnDot(w, j) + ratio * ratio * gamma_t,
+                    1. + ratio * ratio);
+            }
+        }
+        weight[B[s]] = std::max(gamma_t / (pivot * pivot), 1. + 1. / (pivot * pivot));
+    }
+}
+
+// Devex starts a reference framework at the current basis, steepest edge computes exact weights
+void RevisedSimplex::InitWeights() {
+    weight.assign(A.cols, 1.);
+    if (pricing == PRICING_STEEPEST_EDGE) {
+        for (uint32_t j = 0; j < A.cols; j++) {
+            if (position[j] == NONBASIC) {
+                vector<double> alpha = Column(j);
+                for (uint32_t p = 0; p < rows; p++) {
+                    weight[j] += alpha[p] * alpha[p];
+                }
+            }
+        }
+    }
+}
+
+/*
+    Exact minimum ratio test for the entering column alpha, ties broken by smallest basic
+    variable as BlandExit does. Returns NONBASIC if no entry of alpha is positive.
+*/
+uint32_t RevisedSimplex::BlandRatioTest(const vector<double> &alpha) {
+    uint32_t s = NONBASIC;
+    double minSlack = 0., tempSlack;
+    for (uint32_t p = 0; p < rows; p++) {
+        if (alpha[p] > tolerances.pivot) {
+            // basic values that drifted slightly negative count as zero
+            tempSlack = std::max(x_B[p], 0.) / alpha[p];
+            bool tie = s != NONBASIC && fabs(minSlack - tempSlack) < tolerances.primal * fabs(minSlack + tempSlack);
+            if (s == NONBASIC || tempSlack < minSlack || (tie && B[p] < B[s])) {
+                s = p;
+                minSlack = tempSlack;
+            }
+        }
+    }
+    return s;
+}
+
+/*
+    Harris' two pass ratio test: finds the largest step that keeps every basic variable above
+    -HARRIS_TOLERANCE, then takes the largest pivot among the rows whose exact ratio is within
+    that step (the smallest basic variable if bland), and never pivots on entries tiny next to
+    the largest entry of alpha. Returns NONBASIC if no entry of alpha is positive.
+*/
+uint32_t RevisedSimplex::HarrisRatioTest(const vector<double> &alpha, bool bland) {
+    double pivotTolerance = tolerances.pivot, maxStep = HUGE_VAL;
+    for (uint32_t p = 0; p < rows; p++) {
+        pivotTolerance = std::max(pivotTolerance, PIVOT_TOLERANCE * fabs(alpha[p]));
+    }
+    for (uint32_t p = 0; p < rows; p++) {
+        if (alpha[p] > pivotTolerance) {
+            maxStep = std::min(maxStep, (std::max(x_B[p], 0.) + HARRIS_TOLERANCE) / alpha[p]);
+        }
+    }
+    uint32_t s = NONBASIC;
+    for (uint32_t p = 0; p < rows; p++) {
+        if (alpha[p] > pivotTolerance && std::max(x_B[p], 0.) / alpha[p] <= maxStep &&
+            (s == NONBASIC || (bland ? B[p] < B[s] : alpha[p] > alpha[s]))) {
+            s = p;
+        }
+    }
+    return s;
+}
+
+/*
+    Runs simplex from the current (feasible) basis. On return B, B_comp and x_B hold the
+    final basis, which is optimal unless LP_UNBOUNDED is returned. If a refactorisation
+    finds the basis singular, it is repaired with RepairBasis and the method goes on, or
+    returns LP_SINGULAR if the repaired basis is not feasible.
+
+    The entering variable is chosen by the pricing rule, except after DEGENERATE_PIVOT_LIMIT
+    degenerate pivots in a row, when Bland's rule takes over until the objective moves again.
+    PRICING_BLAND uses the exact ratio test of the tableau, the other rules Harris' ratio test.
+
+    param[in]: bound - stop as soon as the objective reaches this value, which the caller knows
+    to be optimal (phase one stops at 0 instead of proving optimality through degenerate pivots)
+*/
+LPStatus RevisedSimplex::Maximize(const vector<double> &c, double bound) {
+    STATS_PHASE("primalSimplex");
+    bool weighted = pricing == PRICING_DEVEX || pricing == PRICING_STEEPEST_EDGE;
+    uint32_t degenerate = 0;
+    if (weighted) {
+        InitWeights();
+    }
+
+    while (true) {
+        if (lu.EtaCount() >= REFACTOR_INTERVAL && !Refactor()) {
+            if (!RepairBasis() || !IsPrimalFeasible()) {
+                return LP_SINGULAR;
+            }
+            if (weighted) {
+                InitWeights();
+            }
+        }
+        if (Objective(c) >= bound) {
+            return LP_OPTIMAL;
+        }
+
+        // price: y^T = c_B^T B^{-1}
+        vector<double> y = Duals(c);
+
+        bool bland = pricing == PRICING_BLAND || degenerate >= DEGENERATE_PIVOT_LIMIT;
+        uint32_t t = Price(c, y, bland);
+        if (t == NONBASIC) {
+            return LP_OPTIMAL;
+        }
+
+        vector<double> alpha = Column(t);
+
+        // ratio test
+        uint32_t s = (pricing == PRICING_BLAND) ? BlandRatioTest(alpha) : HarrisRatioTest(alpha, bland);
+        if (s == NONBASIC) {
+            return LP_UNBOUNDED;
+        }
+
+        if (weighted) {
+            UpdateWeights(s, t, alpha);
+        }
+        double step = std::max(x_B[s], 0.) / alpha[s];
+        degenerate = (step > tolerances.primal) ? 0 : degenerate + 1;
+        x_B[s] = std::max(x_B[s], 0.);
+        Pivot(s, t, alpha);
+    }
+}
+
+// True if no basic variable is negative
+bool RevisedSimplex::IsPrimalFeasible() {
+    for (uint32_t p = 0; p < rows; p++) {
+        if (x_B[p] < -tolerances.primal * bScale) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// True if no variable that may enter has a positive reduced cost under c
+bool RevisedSimplex::IsDualFeasible(const vector<double> &c) {
+    return Price(c, Duals(c), true) == NONBASIC;
+}
+
+/*
+    Runs the dual simplex method from the current basis, which must be dual feasible for c
+    but may have negative basic values. On return B, B_comp and x_B hold the final basis,
+    which is optimal unless LP_INFEASIBLE is returned, or LP_SINGULAR if a singular basis
+    could not be repaired (see RepairBasis) into a dual feasible one.
+
+    The most negative basic variable leaves. The entering variable is one among those with a
+    negative entry alpha_sj in the leaving row that minimises d_j / alpha_sj, so every reduced
+    cost stays nonpositive. If the row has no negative entry, no nonnegative x satisfies it
+    and the LP is infeasible.
+*/
+LPStatus RevisedSimplex::DualMaximize(const vector<double> &c) {
+    STATS_PHASE("dualSimplex");
+    uint32_t variables = std::min(enterLimit, A.cols);
+    bool improving;
+
+    while (true) {
+        if (lu.EtaCount() >= REFACTOR_INTERVAL && !Refactor() && (!RepairBasis() || !IsDualFeasible(c))) {
+            return LP_SINGULAR;
+        }
+
+        uint32_t s = NONBASIC;
+        for (uint32_t p = 0; p < rows; p++) {
+            if (x_B[p] < -tolerances.primal * bScale && (s == NONBASIC || x_B[p] < x_B[s])) {
+                s = p;
+            }
+        }
+        if (s == NONBASIC) {
+            return LP_OPTIMAL;
+        }
+
+        // Harris' two pass ratio test: find the largest step that keeps every reduced cost
+        // below HARRIS_TOLERANCE, then take the largest |alpha_sj| among the candidates whose
+        // exact ratio is within that step, which avoids pivoting on tiny entries
+        vector<double> y = Duals(c);
+        vector<double> row = TableauRow(s);
+        vector<double> d(variables, 0.);
+        double maxStep = HUGE_VAL, pivotTolerance = tolerances.pivot;
+        for (uint32_t j = 0; j < variables; j++) {
+            if (position[j] == NONBASIC) {
+                pivotTolerance = std::max(pivotTolerance, PIVOT_TOLERANCE * fabs(row[j]));
+            }
+        }
+        for (uint32_t j = 0; j < variables; j++) {
+            if (position[j] == NONBASIC && row[j] < -pivotTolerance) {
+                // reduced costs that drifted slightly positive count as zero
+                d[j] = std::min(ReducedCost(c, y, j, improving), 0.);
+                maxStep = std::min(maxStep, (d[j] - HARRIS_TOLERANCE) / row[j]);
+            }
+        }
+        uint32_t t = NONBASIC;
+        for (uint32_t j = 0; j < variables; j++) {
+            if (position[j] == NONBASIC && row[j] < -pivotTolerance && d[j] / row[j] <= maxStep &&
+                (t == NONBASIC || row[j] < row[t])) {
+                t = j;
+            }
+        }
+        if (t == NONBASIC) {
+            return LP_INFEASIBLE;
+        }
+
+        Pivot(s, t, Column(t));
+    }
+}
+
+/*
+    Replaces the basic variable at position s by the nonbasic variable t.
+
+    param[in]: alpha - B^{-1}a_t, as returned by FTRAN
+*/
+void RevisedSimplex::Pivot(uint32_t s, uint32_t t, const vector<double> &alpha) {
+    STATS_COUNT("pivots", 1);
+    double theta = x_B[s] / alpha[s];
+    for (uint32_t p = 0; p < rows; p++) {
+        x_B[p] -= theta * alpha[p];
+    }
+    x_B[s] = theta;
+    lu.Update(s, alpha);
+
+    // leaving variable takes the entering variable's place in B_comp
+    uint32_t leaving = B[s];
+    B_comp[compIndex[t]] = leaving;
+    compIndex[leaving] = compIndex[t];
+    compIndex[t] = NONBASIC;
+    position[leaving] = NONBASIC;
+    position[t] = s;
+    B[s] = t;
+    pivots++;
+}
+
+// B^{-1}a_j
+vector<double> RevisedSimplex::Column(uint32_t j) {
+    vector<double> alpha(rows, 0.);
+    for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+        alpha[A.index[k]] = A.value[k];
+    }
+    lu.FTRAN(alpha);
+    return alpha;
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <math.h>
+#include <vector>
+#include "LUFactor.h"
+
+using std::vector;
+
+// LP_SINGULAR: the basis lost rank to rounding and could not be repaired to go on from
+enum LPStatus { LP_OPTIMAL, LP_UNBOUNDED, LP_INFEASIBLE, LP_SINGULAR };
+
+// Default of every tolerance, see Tolerances
+#define DEFAULT_EPSILON (10000. * std::numeric_limits<double>::epsilon())
+
+/*
+    Tolerances of the solvers.
+        primal - basic values down to -primal (relative to 1 + max |b_i| in the revised method,
+        to 1 + sum |b_i| for phase one objectives) count as feasible, and steps this small as
+        degenerate
+        dual - reduced costs up to dual (relative to 1 + the size of their terms in the revised
+        method) count as optimal
+        pivot - entries at most this large are never pivoted on
+*/
+typedef struct Tolerances {
+    double primal = DEFAULT_EPSILON;
+    double dual = DEFAULT_EPSILON;
+    double pivot = DEFAULT_EPSILON;
+} Tolerances;
+
+/*
+    Rules for choosing the entering variable among those with positive reduced cost d_j:
+        PRICING_BLAND - smallest index
+        PRICING_DANTZIG - largest d_j
+        PRICING_PARTIAL - largest d_j within the first segment of columns that has a candidate
+        PRICING_DEVEX - largest d_j^2 / w_j with approximate reference framework weights w_j
+        PRICING_STEEPEST_EDGE - largest d_j^2 / (1 + |B^{-1}a_j|^2)
+*/
+enum PricingRule { PRICING_BLAND, PRICING_DANTZIG, PRICING_PARTIAL, PRICING_DEVEX, PRICING_STEEPEST_EDGE };
+#define PRICING_RULE_COUNT 5
+// command line names of the pricing rules, indexed by PricingRule
+extern const char *const pricingRuleNames[PRICING_RULE_COUNT];
+
+// Basis changes between refactorisations of the basis
+#define REFACTOR_INTERVAL 64
+#define NONBASIC UINT32_MAX
+// Consecutive degenerate pivots before falling back to Bland's rule
+#define DEGENERATE_PIVOT_LIMIT 50
+// Partial pricing splits the columns into this many segments of at least PARTIAL_PRICING_MIN
+#define PARTIAL_PRICING_SEGMENTS 8
+#define PARTIAL_PRICING_MIN 100u
+// Ratio tests skip entries smaller than this relative to the largest entry of the column or row
+#define PIVOT_TOLERANCE 1e-7
+// Harris' ratio tests may let basic values reach this far below 0, and reduced costs this
+// far above 0, to get a larger pivot
+#define HARRIS_TOLERANCE 1e-9
+
+/*
+    Revised simplex method for max c^Tx subject to Ax = b, x >= 0.
+
+    Instead of pivoting a dense tableau, only the basis is kept, as an LUFactor.
+    Each iteration prices the nonbasic columns with y^T = c_B^T B^{-1} (BTRAN), computes
+    the entering column alpha = B^{-1}a_q (FTRAN) for the ratio test and records the basis
+    change as an eta vector. With PRICING_BLAND, entering and leaving variables are chosen
+    exactly as BlandEnter and BlandExit do for the tableau.
+
+    DualMaximize is the dual simplex method, for re-optimising from a basis that stayed dual
+    feasible after the right hand side or the constraints changed.
+*/
+class RevisedSimplex {
+public:
+    RevisedSimplex(const SparseMatrix &, const vector<double> &, const Tolerances & = Tolerances());
+    bool SetBasis(const vector<uint32_t> &, const vector<uint32_t> &);
+    LPStatus Maximize(const vector<double> &, double = HUGE_VAL);
+    LPStatus DualMaximize(const vector<double> &);
+    bool IsPrimalFeasible();
+    bool IsDualFeasible(const vector<double> &);
+    double Objective(const vector<double> &);
+    vector<double> Duals(const vector<double> &);
+    void Pivot(uint32_t, uint32_t, const vector<double> &);
+    vector<double> Column(uint32_t);
+    vector<double> TableauRow(uint32_t);
+    double ColumnDot(const vector<double> &, uint32_t);
+    bool IsBasic(uint32_t j) { return position[j] != NONBASIC; }
+
+    // basic variable at each position, nonbasic variables, and values of the basic variables
+    vector<uint32_t> B, B_comp;
+    vector<double> x_B;
+    uint32_t pivots;
+    PricingRule pricing;
+    // only variables below this may enter the basis (phase two keeps artificials out)
+    uint32_t enterLimit;
+    Tolerances tolerances;
+
+private:
+    bool Refactor();
+    bool RepairBasis();
+    double ReducedCost(const vector<double> &, const vector<double> &, uint32_t, bool &);
+    uint32_t Price(const vector<double> &, const vector<double> &, bool);
+    uint32_t BlandRatioTest(const vector<double> &);
+    uint32_t HarrisRatioTest(const vector<double> &, bool);
+    void InitWeights();
+    void UpdateWeights(uint32_t, uint32_t, const vector<double> &);
+
+    uint32_t rows;
+    // the constraint matrix by column (CSC) and by row (CSR)
+    const SparseMatrix &A;
+    SparseMatrix rowwise;
+    const vector<double> &b;
+    // basic values below -tolerances.primal * bScale are infeasible, bScale = 1 + max |b_i|
+    double bScale;
+    // for each variable, its position in B or NONBASIC, and its index in B_comp
+    vector<uint32_t> position, compIndex;
+    // for each row, the first column with its only nonzero there (a slack or an artificial), or NONBASIC
+    vector<uint32_t> unitColumn;
+    LUFactor lu;
+    // devex or steepest edge weight of each variable, and where partial pricing resumes
+    vector<double> weight;
+    uint32_t partialStart;
+};
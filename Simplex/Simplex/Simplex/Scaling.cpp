@@ -0,0 +1,123 @@
+/**
+    Row and column scaling of constraint matrices
+**/
+
+#include "Scaling.h"
+
+// Nearest power of 2 to f
+static double RoundToPowerOfTwo(double f) {
+    return exp2(round(log2(f)));
+}
+
+// max |a_ij| / min |a_ij| over the nonzeros of R A C
+static double ScaledRange(const SparseMatrix &A, const Scaling &s) {
+    double smallest = HUGE_VAL, largest = 0.;
+    for (uint32_t j = 0; j < A.cols; j++) {
+        for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+            double a = fabs(A.value[k]) * s.row[A.index[k]] * s.col[j];
+            smallest = std::min(smallest, a);
+            largest = std::max(largest, a);
+        }
+    }
+    return (largest > 0.) ? largest / smallest : 1.;
+}
+
+/*
+    Computes factors that bring the nonzeros of A close to 1 in magnitude: passes of geometric
+    scaling, dividing each row and then each column by sqrt(min |a_ij| max |a_ij|) over its
+    nonzeros, while they shrink the spread of the magnitudes, followed by equilibration of the
+    columns so that the largest entry of each is 1. Empty rows and columns get factor 1.
+*/
+Scaling ScaleFactors(const SparseMatrix &A) {
+    Scaling s;
+    s.row.assign(A.rows, 1.);
+    s.col.assign(A.cols, 1.);
+    SparseMatrix rowwise = Transpose(A);
+
+    double range = ScaledRange(A, s);
+    for (uint32_t pass = 0; pass < SCALING_PASSES && range > 1.; pass++) {
+        Scaling next = s;
+        for (uint32_t i = 0; i < A.rows; i++) {
+            double smallest = HUGE_VAL, largest = 0.;
+            for (uint32_t k = rowwise.start[i]; k < rowwise.start[i + 1]; k++) {
+                double a = fabs(rowwise.value[k]) * next.col[rowwise.index[k]];
+                smallest = std::min(smallest, a);
+                largest = std::max(largest, a);
+            }
+            if (largest > 0.) {
+                next.row[i] = RoundToPowerOfTwo(1. / sqrt(smallest * largest));
+            }
+        }
+        for (uint32_t j = 0; j < A.cols; j++) {
+            double smallest = HUGE_VAL, largest = 0.;
+            for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+                double a = fabs(A.value[k]) * next.row[A.index[k]];
+                smallest = std::min(smallest, a);
+                largest = std::max(largest, a);
+            }
+            if (largest > 0.) {
+                next.col[j] = RoundToPowerOfTwo(1. / sqrt(smallest * largest));
+            }
+        }
+
+        double nextRange = ScaledRange(A, next);
+        if (nextRange > SCALING_MIN_IMPROVEMENT * range) {
+            if (nextRange < range) {
+                s = next;
+            }
+            break;
+        }
+        s = next;
+        range = nextRange;
+    }
+
+    for (uint32_t j = 0; j < A.cols; j++) {
+        double largest = 0.;
+        for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+            largest = std::max(largest, fabs(A.value[k]) * s.row[A.index[k]] * s.col[j]);
+        }
+        if (largest > 0.) {
+            s.col[j] *= RoundToPowerOfTwo(1. / largest);
+        }
+    }
+    return s;
+}
+
+// A <- R A C
+void ScaleMatrix(SparseMatrix &A, const Scaling &s) {
+    for (uint32_t j = 0; j < A.cols; j++) {
+        for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+            A.value[k] *= s.row[A.index[k]] * s.col[j];
+        }
+    }
+}
+
+/*
+    Scales lp in place to max (Cc)^Tx' subject to (RAC)x' = Rb, C^{-1}l <= x' <= C^{-1}u, whose
+    solutions give x = Cx', y = Ry' and reduced costs d = C^{-1}d' (see UnscaleSolution). Its
+    bases are those of lp.
+*/
+Scaling ScaleLP(LinearProgram &lp) {
+    Scaling s = ScaleFactors(lp.A);
+    ScaleMatrix(lp.A, s);
+    for (uint32_t i = 0; i < lp.A.rows; i++) {
+        lp.b[i] *= s.row[i];
+    }
+    for (uint32_t j = 0; j < lp.A.cols; j++) {
+        lp.c[j] *= s.col[j];
+        lp.lower[j] /= s.col[j];
+        lp.upper[j] /= s.col[j];
+    }
+    return s;
+}
+
+// Maps a solution of the LP scaled by ScaleLP back to the original LP
+void UnscaleSolution(const Scaling &s, LPSolution &solution) {
+    for (uint32_t j = 0; j < solution.x.size(); j++) {
+        solution.x[j] *= s.col[j];
+        solution.reducedCosts[j] /= s.col[j];
+    }
+    for (uint32_t i = 0; i < solution.y.size(); i++) {
+        solution.y[i] *= s.row[i];
+    }
+}
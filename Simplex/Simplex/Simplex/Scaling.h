@@ -0,0 +1,24 @@
+#pragma once
+#include <vector>
+#include "LPSolver.h"
+#include "SparseMatrix.h"
+
+using std::vector;
+
+// Most passes of geometric scaling before the final equilibration
+#define SCALING_PASSES 8
+// Geometric scaling stops once a pass shrinks max |a_ij| / min |a_ij| by less than this factor
+#define SCALING_MIN_IMPROVEMENT 0.9
+
+/*
+    Row and column factors of a scaled matrix R A C. Every factor is a power of 2, so scaling
+    and unscaling are exact.
+*/
+typedef struct Scaling {
+    vector<double> row, col;
+} Scaling;
+
+Scaling ScaleFactors(const SparseMatrix &);
+void ScaleMatrix(SparseMatrix &, const Scaling &);
+Scaling ScaleLP(LinearProgram &);
+void UnscaleSolution(const Scaling &, LPSolution &);
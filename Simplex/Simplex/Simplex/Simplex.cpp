@@ -1,38 +1,21 @@
 // Simplex.cpp
-#include <algorithm>
-#include <iostream>
-#include <math.h>
-#include <vector>
-
-using std::vector;
-
-int problemCount;
-uint16_t n, m;
-double tolerance = std::numeric_limits<double>::epsilon();
-double epsilon = 10000. * tolerance;
-
-typedef vector<uint16_t> Basis;
-typedef vector<vector<double>> DoubleMatrix;
-
-int RowReduce(DoubleMatrix, vector<double>, vector<int> &);
-vector<uint16_t>::iterator BlandEnter(Basis &, vector<double> &);
-uint16_t BlandExit(DoubleMatrix &, vector<double> &, Basis &, uint16_t, double &);
-
-double Simplex(double, DoubleMatrix &, vector<double> &, vector<double> &, vector<double> &,
-    Basis &, Basis &);
-
-void FeasibleBasis(DoubleMatrix &, vector<double> &);
+#include <atomic>
+#include <thread>
+#include "Presolve.h"
+#include "Scaling.h"
+#include "Simplex.h"
+#include "Stats.h"
 
 /*
     Compute the smallest element t in B such that c[t] > 0
 */
-Basis::iterator BlandEnter(Basis &B, vector<double> &c) {
+Basis::iterator BlandEnter(const Problem &P, Basis &B, vector<double> &c) {
     Basis::iterator it = B.begin();
     Basis::iterator minimum = B.end();
     bool found = false;
 
     for (; it != B.end(); it++) {
-        if (c[*it] > epsilon) {
+        if (c[*it] > P.tolerances.dual) {
             if (found) {
                 if (*it < *minimum) {
                     minimum = it;
@@ -52,25 +35,29 @@ Basis::iterator BlandEnter(Basis &B, vector<double> &c) {
     
     param[out]: minSlack - minimum adjustment to remain feasible. If A_{i,t} <= 0 for all i in [m], minSlack has value -1 on return to indicate UNBOUNDED.
 
-    Returns pointer to B[k] where k is choose to minimize B[k] subject to A_{k,t} > 0 and b_k/A_{k,t} = lambda^*
+    Returns pointer to B[k] where k is choose to minimize B[k] subject to A_{k,t} > 0 and b_k/A_{k,t} = lambda^*.
+    Entries up to the pivot tolerance count as 0, and ratios equal to within the primal
+    tolerance (relative) as ties.
 */
-uint16_t BlandExit(DoubleMatrix &A,
-                        vector<double> &b,
+uint16_t BlandExit(const Problem &P,
                         Basis &B, 
                         uint16_t t, 
                         double & minSlack) {
 
+    const DoubleMatrix &A = P.A;
+    const vector<double> &b = P.b;
+    const Tolerances &tol = P.tolerances;
+    uint16_t m = P.m;
     uint16_t minimum = m + 1;
     double tempSlack;
     bool found = false;
     
     for (int i = 0; i < m; i++) {
-        if (A[i][t] > epsilon) {
+        if (A[i][t] > tol.pivot) {
             tempSlack = b[i] / A[i][t];
             if (found) {
-                // TODO need to use approx equals
                 if (tempSlack < minSlack || 
-                    (std::fabs(minSlack - tempSlack) < epsilon * std::fabs(minSlack + tempSlack) && B[i] < B[minimum])) {
+                    (std::fabs(minSlack - tempSlack) < tol.primal * std::fabs(minSlack + tempSlack) && B[i] < B[minimum])) {
                     minimum = i;
                     minSlack = tempSlack;
                 }
@@ -90,10 +77,12 @@ uint16_t BlandExit(DoubleMatrix &A,
 }
 
 /**
-    Returns optimal value of LP given by max c^Tx subject to Ax = b, x >= 0
+    Solves the LP given by max c^Tx subject to Ax = b, x >= 0. Returns LP_UNBOUNDED if the
+    objective is unbounded and LP_OPTIMAL otherwise.
 
-    param[in/out]: A - matrix of constraint coefficients
-    param[in/out]: b - vector of constaint values
+    param[in/out]: P - problem whose A (matrix of constraint coefficients) and b (vector of
+                   constaint values) are pivoted in place
+    param[in/out]: V - objective value of the initial assignment. If simplex halts, the optimal value.
     param[in/out]: c - vector of objective constants
     param[in/out]: B_comp - the complement of B in {0,...,m+n-1}
     param[in/out]: B - Contains initial feasible basis. If simplex halts, contains an optimal feasible basis.
@@ -102,22 +91,25 @@ uint16_t BlandExit(DoubleMatrix &A,
     Note: Initially, we require Ax = b and x >= 0 and A_B is invertible.
 **/
 
-double Simplex( double V,
-                DoubleMatrix &A,
-                vector<double> &b,
-                vector<double> &c,
-                vector<double> &x,
-                Basis &B,
-                Basis &B_comp) {
-
+LPStatus Simplex(Problem &P,
+                 double &V,
+                 vector<double> &c,
+                 vector<double> &x,
+                 Basis &B,
+                 Basis &B_comp) {
+    STATS_PHASE("Simplex");
+
+    DoubleMatrix &A = P.A;
+    vector<double> &b = P.b;
+    uint16_t m = P.m;
     double lambda;
-    Basis::iterator t = BlandEnter(B_comp, c);
+    Basis::iterator t = BlandEnter(P, B_comp, c);
 
     while (t != B_comp.end()) {
-        uint16_t s = BlandExit(A, b, B, *t, lambda);
+        STATS_COUNT("pivots", 1);
+        uint16_t s = BlandExit(P, B, *t, lambda);
         if (lambda < 0) {
-            // unbounded
-            return 1.;
+            return LP_UNBOUNDED;
         }
         else {
             double a_st = A[s][*t];
@@ -157,30 +149,36 @@ double Simplex( double V,
         *t = B[s];
         B[s] = temp;
 
-        t = BlandEnter(B_comp, c);
+        t = BlandEnter(P, B_comp, c);
     }
 
-    return V;
+    return LP_OPTIMAL;
 }
 
 /*
-    Outputs indices for an initial feasible basis.
+    Computes indices of an initial feasible basis. Returns false if the LP is infeasible.
 
     Assumes m x m identity has already been adjoined to A
 
     Calls simplex on intermediate LP: max -1y subject to A(x|y) = b, x >= 0
+
+    param[out]: B_out - sorted (0-indexed) columns of a feasible basis
 */
-void FeasibleBasis(DoubleMatrix &A, vector<double> &b) {
+bool FeasibleBasis(Problem &P, Basis &B_out) {
+    const DoubleMatrix &A = P.A;
+    const vector<double> &b = P.b;
+    uint16_t n = P.n, m = P.m;
     Basis B, B_complement;
     vector<double> c;
     vector<double> x;
-    double val = 0.0;
+    double val = 0.0, scale = 1.;
     for (uint16_t i = 0; i < n + m; i++) {
         if( i >= n ){ 
             B.push_back(i); 
             c.push_back(0.);
             x.push_back(b[i - n]);
             val -= b[i - n];
+            scale += std::fabs(b[i - n]);
         }
         else {
             double f = 0.0;
@@ -206,18 +204,18 @@ void FeasibleBasis(DoubleMatrix &A, vector<double> &b) {
     val = c_B^T b = - column sum(b)
     where C_i is the sum of column i of A. Note 1-C_i = 0 for i >= n
     */
-    val = Simplex(val, A, b, c, x, B, B_complement);
+    // phase one is bounded above by 0; rounding error in val grows with |b|_1
+    Simplex(P, val, c, x, B, B_complement);
 
-    if (std::fabs(val) > epsilon) {
-        std::cout << "INFEASIBLE\n";
+    if (std::fabs(val) > P.tolerances.primal * scale) {
+        return false;
     }
     else {
-        Basis B_out;
         for (int i = 0; i < m; i++) {
             // Remove remaining y's from B
-            if (B[i] > n) {
+            if (B[i] >= n) {
                 Basis::iterator x_new = std::find_if(B_complement.begin(), B_complement.end(),
-                    [A, i](uint16_t j) { return j < n && A[i][j] != 0.; }); 
+                    [&A, i, n, &P](uint16_t j) { return j < n && std::fabs(A[i][j]) > P.tolerances.pivot; }); 
                 // Note: x_new should never be B.end() here since rank(A) = m
                 B_out.push_back(*x_new);
                 B_complement.erase(x_new);
@@ -228,108 +226,418 @@ void FeasibleBasis(DoubleMatrix &A, vector<double> &b) {
         }
 
         std::sort(B_out.begin(), B_out.end());
-        for (Basis::iterator it = B_out.begin(); it != B_out.end(); it++) {
-            std::cout << *it + 1 << " ";
-        }
-        std::cout << std::endl;
+        return true;
     }
 }
 
-int main() {
-    std::cin >> problemCount;
-    double r;
-    // read in problem
-    for (int i = 0; i < problemCount; i++) {
-        std::cin >> n;
-        std::cin >> m;
-        vector<vector<double>> A;
-        vector<double> b;
-        for (int j = 0; j < m; j++) {
-            vector<double> v;
-            for (int k = 0; k < n; k++) {
-                std::cin >> r;
-                v.push_back(r);
+/*
+    Same as FeasibleBasis, but on a DenseTableau: the whole tableau is pivoted with the
+    vectorised rank-1 update, split across threads for large tableaus. Like the revised
+    method, phase one stops as soon as the artificials reach 0, feasibility is judged
+    relative to |b|_1 and artificials left in the basis are pivoted out.
+
+    param[in]: threads - threads to pivot with
+*/
+bool DenseFeasibleBasis(const Problem &P, Basis &B_out, uint32_t threads) {
+    const DoubleMatrix &A = P.A;
+    const vector<double> &b = P.b;
+    const Tolerances &tol = P.tolerances;
+    uint16_t n = P.n, m = P.m;
+    DenseTableau T(m, n + m);
+    double *objective = T.Row(m);
+    double scale = 1.;
+    for (uint16_t i = 0; i < m; i++) {
+        double *row = T.Row(i);
+        std::copy(A[i].begin(), A[i].end(), row);
+        row[n + m] = b[i];
+        // reduced costs of max -(sum of artificials) at the artificial basis, as in FeasibleBasis
+        for (uint16_t j = 0; j < n; j++) {
+            objective[j] += A[i][j];
+        }
+        objective[n + m] += b[i];
+        scale += fabs(b[i]);
+    }
+
+    Basis B;
+    vector<bool> basic(n + m, false);
+    for (uint16_t i = 0; i < m; i++) {
+        B.push_back(n + i);
+        basic[n + i] = true;
+    }
+
+    // the objective row's right hand side is minus the objective value
+    while (objective[n + m] > tol.primal * scale) {
+        uint16_t t = 0;
+        while (t < n + m && (basic[t] || objective[t] <= tol.dual)) {
+            t++;
+        }
+        if (t == n + m) {
+            break;
+        }
+
+        uint16_t s = m;
+        double minSlack = 0., tempSlack;
+        for (uint16_t i = 0; i < m; i++) {
+            double a_it = T.At(i, t);
+            if (a_it > tol.pivot) {
+                tempSlack = std::max(T.At(i, n + m), 0.) / a_it;
+                if (s == m || tempSlack < minSlack ||
+                    (std::fabs(minSlack - tempSlack) < tol.primal * std::fabs(minSlack + tempSlack) && B[i] < B[s])) {
+                    s = i;
+                    minSlack = tempSlack;
+                }
             }
-            for (int k = 0; k < m; k++) {
-                // Adjoin m x m identity to A
-                v.push_back((k == j) ? 1. : 0.);
+        }
+        // phase one is bounded, so s < m here
+
+        T.Pivot(s, t, threads);
+        basic[B[s]] = false;
+        basic[t] = true;
+        B[s] = t;
+    }
+
+    if (objective[n + m] > tol.primal * scale) {
+        return false;
+    }
+
+    for (uint16_t i = 0; i < m; i++) {
+        if (B[i] >= n) {
+            for (uint16_t j = 0; j < n; j++) {
+                if (!basic[j] && std::fabs(T.At(i, j)) > tol.pivot) {
+                    T.Pivot(i, j, threads);
+                    basic[B[i]] = false;
+                    basic[j] = true;
+                    B[i] = j;
+                    break;
+                }
             }
-            A.push_back(v);
-            std::cin >> r;
-            b.push_back(r);
         }
+        if (B[i] < n) {
+            B_out.push_back(B[i]);
+        }
+    }
 
-        vector<int> redundant;
-        int R = RowReduce(A, b, redundant);
+    std::sort(B_out.begin(), B_out.end());
+    return true;
+}
 
-        if (R == -1) {
-            std::cout << "INFEASIBLE\n";
+/*
+    Reads one problem (n, m, then m rows of n coefficients followed by b_i) into P and
+    adjoins the m x m identity to A.
+*/
+void ReadProblem(std::istream &in, Problem &P) {
+    DoubleMatrix &A = P.A;
+    vector<double> &b = P.b;
+    uint16_t &n = P.n, &m = P.m;
+    double r;
+    in >> n;
+    in >> m;
+    A.clear();
+    b.clear();
+    for (int j = 0; j < m; j++) {
+        vector<double> v;
+        for (int k = 0; k < n; k++) {
+            in >> r;
+            v.push_back(r);
         }
-        else {
-            // remove redundant constraints
-            for (vector<int>::iterator it = redundant.begin(); it != redundant.end(); it++) {
-                A.erase(A.begin() + *it);
-                b.erase(b.begin() + *it);
-                m--;
+        for (int k = 0; k < m; k++) {
+            // Adjoin m x m identity to A
+            v.push_back((k == j) ? 1. : 0.);
+        }
+        A.push_back(v);
+        in >> r;
+        b.push_back(r);
+    }
+}
+
+/*
+    Scales the rows and the first n columns of A (see ScaleFactors) and b with them. The
+    identity columns stay as they are, which amounts to scaling them by the inverse of their
+    row's factor, so bases and their feasibility are those of the unscaled problem.
+*/
+void ScaleProblem(Problem &P) {
+    vector<Triple> entries;
+    for (uint16_t i = 0; i < P.m; i++) {
+        for (uint16_t j = 0; j < P.n; j++) {
+            if (P.A[i][j] != 0.) {
+                Triple t = { i, j, P.A[i][j] };
+                entries.push_back(t);
             }
-            FeasibleBasis(A, b);
         }
     }
+    Scaling s = ScaleFactors(CompressColumns(P.m, P.n, entries));
+    for (uint16_t i = 0; i < P.m; i++) {
+        for (uint16_t j = 0; j < P.n; j++) {
+            P.A[i][j] *= s.row[i] * s.col[j];
+        }
+        P.b[i] *= s.row[i];
+    }
 }
 
 /*
-    Computes the rank of matrix A by putting A in reduced row echelon form.
-    If the linear system Ax = b is infeasible, returns -1.
+    Reads one problem in sparse form: n, m and the number of nonzeros k, then k triples
+    "i j a_ij" with 1-indexed i and j (duplicates are summed), then b_1 ... b_m.
+    Rows with b_i < 0 are negated, and the m x m identity is appended as columns n..n+m-1.
+*/
+void ReadSparseProblem(std::istream &in, SparseMatrix &A, vector<double> &b) {
+    uint32_t cols, rows;
+    size_t nonzeros;
+    in >> cols >> rows >> nonzeros;
+
+    vector<Triple> entries(nonzeros);
+    for (size_t k = 0; k < nonzeros; k++) {
+        in >> entries[k].row >> entries[k].col >> entries[k].value;
+        entries[k].row--;
+        entries[k].col--;
+    }
+    b.resize(rows);
+    for (uint32_t i = 0; i < rows; i++) {
+        in >> b[i];
+    }
+
+    for (vector<Triple>::iterator it = entries.begin(); it != entries.end(); it++) {
+        if (b[it->row] < 0.) {
+            it->value = -it->value;
+        }
+    }
+    for (uint32_t i = 0; i < rows; i++) {
+        Triple t = { i, cols + i, 1. };
+        entries.push_back(t);
+        b[i] = fabs(b[i]);
+    }
+    A = CompressColumns(rows, cols + rows, entries);
+}
 
-    param[out]: redundancies - list of redundant constraints that can be removed
+/*
+    Computes a feasible basis of Ax = b, x >= 0 with the revised simplex method, working on
+    A in sparse form throughout. Returns false if the LP is infeasible, or if phase one ends on
+    a singular basis that could not be repaired.
+
+    Assumes b >= 0 and that the columns from structural on are the m x m identity. Runs phase
+    one as FeasibleBasis does, then pivots the remaining artificials out of the basis. Rows
+    whose artificial cannot leave are redundant and are left out of B_out, so B_out has
+    rank(A) entries.
+
+    param[out]: B_out - sorted (0-indexed) columns of a feasible basis
+    param[in]: rule - pricing rule for phase one
+    param[out]: pivots - if not NULL, the number of pivots taken
+    param[in]: tolerances - see Tolerances
 */
-int RowReduce(DoubleMatrix A, vector<double> b, vector<int> &redundancies) {
-    int pivotRow = 0, pivotCol, rank;
-    double scale;
-
-    rank = m;
-
-    while (pivotRow < m) {
-        pivotCol = -1;
-        // select a pivot column with nonzero entry
-        for (int i = 0; i < n; i++) {
-            if (A[pivotRow][i] != 0.0) {
-                scale = A[pivotRow][i];
-                for (int j = 0; j < n; j++) {
-                    A[pivotRow][j] /= scale;
+bool SparseFeasibleBasis(const SparseMatrix &A, const vector<double> &b, uint32_t structural,
+    vector<uint32_t> &B_out, PricingRule rule, uint32_t *pivots, const Tolerances &tolerances) {
+    vector<uint32_t> B, B_complement;
+    vector<double> c(A.cols, 0.);
+    double scale = 1.;
+    for (uint32_t j = 0; j < A.cols; j++) {
+        if (j >= structural) {
+            B.push_back(j);
+            c[j] = -1.;
+            scale += std::fabs(b[j - structural]);
+        }
+        else {
+            B_complement.push_back(j);
+        }
+    }
+
+    RevisedSimplex lp(A, b, tolerances);
+    lp.pricing = rule;
+    lp.SetBasis(B, B_complement);
+    LPStatus status = lp.Maximize(c, -tolerances.primal * scale);
+    if (pivots != NULL) {
+        *pivots = lp.pivots;
+    }
+
+    if (status == LP_SINGULAR || -lp.Objective(c) > tolerances.primal * scale) {
+        return false;
+    }
+
+    B_out.clear();
+    for (uint32_t i = 0; i < A.rows; i++) {
+        if (lp.B[i] >= structural) {
+            vector<double> row = lp.TableauRow(i);
+            for (uint32_t j = 0; j < structural; j++) {
+                if (fabs(row[j]) > tolerances.pivot && !lp.IsBasic(j)) {
+                    lp.Pivot(i, j, lp.Column(j));
+                    break;
                 }
-                b[pivotRow] /= scale;
-                pivotCol = i;
-                break;
             }
         }
+        if (lp.B[i] < structural) {
+            B_out.push_back(lp.B[i]);
+        }
+    }
 
-        if (pivotCol == -1) {
-            // singularity
-            if (b[pivotRow] != 0.0) {
-                // infeasible
-                return -1;
-            }
-            else {
-                // redundant constraint, delete row
-                rank--;
-                redundancies.push_back(pivotRow);
+    std::sort(B_out.begin(), B_out.end());
+    return true;
+}
+
+/*
+    Same as SparseFeasibleBasis, but with the interior point method and crossover of SolveLP
+    (see SolveBarrier) in place of phase one. On large, sparse and degenerate problems the
+    barrier takes a few dozen iterations where phase one can take a great many pivots.
+
+    param[in]: threads - threads for the barrier's factorisations
+    param[out]: pivots - if not NULL, the number of pivots of the crossover
+*/
+bool BarrierFeasibleBasis(const SparseMatrix &A, const vector<double> &b, uint32_t structural,
+    vector<uint32_t> &B_out, uint32_t threads, uint32_t *pivots, const Tolerances &tolerances) {
+    LinearProgram lp;
+    lp.A = LeadingColumns(A, structural);
+    lp.b = b;
+    lp.c.assign(structural, 0.);
+    lp.lower.assign(structural, 0.);
+    lp.upper.assign(structural, HUGE_VAL);
+    LPSettings settings;
+    settings.tolerances = tolerances;
+    settings.barrier = true;
+    settings.threads = threads;
+    LPSolution solution = SolveLP(lp, PRICING_STEEPEST_EDGE, NULL, settings);
+    if (pivots != NULL) {
+        *pivots = solution.pivots;
+    }
+    if (solution.status != LP_OPTIMAL) {
+        return false;
+    }
+
+    B_out.clear();
+    for (uint32_t j = 0; j < structural; j++) {
+        if (solution.basis.columns[j] == VAR_BASIC) {
+            B_out.push_back(j);
+        }
+    }
+    return true;
+}
+
+// The columns of P.A, identity included, as a sparse matrix
+static SparseMatrix SparseColumns(const Problem &P) {
+    const DoubleMatrix &A = P.A;
+    uint16_t n = P.n, m = P.m;
+    vector<Triple> entries;
+    for (uint16_t i = 0; i < m; i++) {
+        for (uint16_t j = 0; j < n + m; j++) {
+            if (A[i][j] != 0.) {
+                Triple t = { i, j, A[i][j] };
+                entries.push_back(t);
             }
         }
-        else {
-            // Adjust A and B
-            for (int i = 0; i < m; i++) {
-                if (i != pivotRow) {
-                    scale = A[i][pivotCol];
-                    for (int j = 0; j < n; j++) {
-                        A[i][j] -= scale * A[pivotRow][j];
-                    }
-                    b[i] -= scale * b[pivotRow];
-                }
+    }
+    return CompressColumns(m, n + m, entries);
+}
+
+/*
+    Same as FeasibleBasis, but runs phase one with the revised simplex method on an
+    LU-factored basis instead of the dense tableau.
+*/
+bool RevisedFeasibleBasis(const Problem &P, Basis &B_out, PricingRule rule, uint32_t *pivots) {
+    vector<uint32_t> B;
+    if (!SparseFeasibleBasis(SparseColumns(P), P.b, P.n, B, rule, pivots, P.tolerances)) {
+        return false;
+    }
+    B_out.assign(B.begin(), B.end());
+    return true;
+}
+
+// Same as FeasibleBasis, but with the barrier and crossover (see BarrierFeasibleBasis)
+bool InteriorFeasibleBasis(const Problem &P, Basis &B_out, uint32_t threads, uint32_t *pivots) {
+    vector<uint32_t> B;
+    if (!BarrierFeasibleBasis(SparseColumns(P), P.b, P.n, B, threads, pivots, P.tolerances)) {
+        return false;
+    }
+    B_out.assign(B.begin(), B.end());
+    return true;
+}
+
+/*
+    Removes redundant constraints and computes a feasible basis of Ax = b, x >= 0, scaling
+    the problem first if P.scale is set. Returns false if the LP is infeasible.
+*/
+bool SolveFeasibility(Problem &P, Basis &B_out, Engine engine, PricingRule rule,
+    uint32_t *pivots, uint32_t threads) {
+    STATS_PHASE("SolveFeasibility");
+    DoubleMatrix &A = P.A;
+    vector<double> &b = P.b;
+    if (P.scale) {
+        ScaleProblem(P);
+    }
+    vector<int> redundant;
+    int R = RowReduce(P, redundant);
+
+    if (R == -1) {
+        return false;
+    }
+
+    // remove redundant constraints, last first so that the indices of the others stay valid,
+    // along with their columns of the adjoined identity
+    for (vector<int>::reverse_iterator it = redundant.rbegin(); it != redundant.rend(); it++) {
+        A.erase(A.begin() + *it);
+        b.erase(b.begin() + *it);
+        for (DoubleMatrix::iterator row = A.begin(); row != A.end(); row++) {
+            row->erase(row->begin() + P.n + *it);
+        }
+        P.m--;
+    }
+    switch (engine) {
+    case ENGINE_REVISED:
+        return RevisedFeasibleBasis(P, B_out, rule, pivots);
+    case ENGINE_DENSE:
+        return DenseFeasibleBasis(P, B_out, threads);
+    case ENGINE_BARRIER:
+        return InteriorFeasibleBasis(P, B_out, threads, pivots);
+    default:
+        return FeasibleBasis(P, B_out);
+    }
+}
+
+/*
+    Computes the rank of the first n columns of A, finding the rows that are combinations of
+    earlier rows by sparse LU (see DependentRows). If the linear system Ax = b is infeasible,
+    returns -1.
+
+    param[out]: redundancies - list of redundant constraints that can be removed, in increasing order
+*/
+int RowReduce(const Problem &P, vector<int> &redundancies) {
+    const DoubleMatrix &A = P.A;
+    uint16_t n = P.n, m = P.m;
+    vector<SparseVector> rows(m);
+    for (uint16_t i = 0; i < m; i++) {
+        for (uint16_t j = 0; j < n; j++) {
+            if (A[i][j] != 0.) {
+                rows[i].push_back(std::make_pair(j, A[i][j]));
             }
         }
+    }
 
-        pivotRow++;
+    vector<uint32_t> dependent;
+    if (!DependentRows(rows, P.b, n, dependent)) {
+        return -1;
     }
-    return rank;
-}
\ No newline at end of file
+    redundancies.assign(dependent.begin(), dependent.end());
+    return m - static_cast<int>(dependent.size());
+}
+
+/*
+    Runs task(0), ..., task(count - 1) on a pool of workers threads. Each worker takes the
+    next task nobody has started, so uneven tasks keep every worker busy; tasks must only
+    share read-only state. workers = 1 runs the tasks in order on the calling thread.
+*/
+void RunBatch(uint32_t count, uint32_t workers, const std::function<void(uint32_t)> &task) {
+    if (workers <= 1) {
+        for (uint32_t i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    std::atomic<uint32_t> next(0);
+    vector<std::thread> pool;
+    for (uint32_t w = 0; w < std::min(workers, count); w++) {
+        pool.push_back(std::thread([&next, count, &task]() {
+            for (uint32_t i = next++; i < count; i = next++) {
+                task(i);
+            }
+        }));
+    }
+    for (vector<std::thread>::iterator it = pool.begin(); it != pool.end(); it++) {
+        it->join();
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <math.h>
+#include <vector>
+#include "DenseTableau.h"
+#include "RevisedSimplex.h"
+
+using std::vector;
+
+typedef vector<uint16_t> Basis;
+typedef vector<vector<double>> DoubleMatrix;
+
+// Phase one implementations: the original tableau, the revised method, the contiguous tableau,
+// and the interior point method with crossover
+enum Engine { ENGINE_TABLEAU, ENGINE_REVISED, ENGINE_DENSE, ENGINE_BARRIER };
+
+/*
+    One feasibility problem and the state its solve works on, so that problems can be solved
+    side by side: Ax = b, x >= 0 with the m x m identity adjoined to A as columns n..n+m-1.
+    Removing redundant rows lowers m.
+        tolerances - see Tolerances
+        scale - scale A and b before solving (see ScaleProblem)
+*/
+typedef struct Problem {
+    uint16_t n, m;
+    DoubleMatrix A;
+    vector<double> b;
+    Tolerances tolerances;
+    bool scale = false;
+} Problem;
+
+int RowReduce(const Problem &, vector<int> &);
+vector<uint16_t>::iterator BlandEnter(const Problem &, Basis &, vector<double> &);
+uint16_t BlandExit(const Problem &, Basis &, uint16_t, double &);
+
+LPStatus Simplex(Problem &, double &, vector<double> &, vector<double> &, Basis &, Basis &);
+
+bool FeasibleBasis(Problem &, Basis &);
+bool DenseFeasibleBasis(const Problem &, Basis &, uint32_t = 1);
+bool RevisedFeasibleBasis(const Problem &, Basis &, PricingRule = PRICING_BLAND, uint32_t * = NULL);
+bool SparseFeasibleBasis(const SparseMatrix &, const vector<double> &, uint32_t, vector<uint32_t> &,
+    PricingRule = PRICING_BLAND, uint32_t * = NULL, const Tolerances & = Tolerances());
+bool BarrierFeasibleBasis(const SparseMatrix &, const vector<double> &, uint32_t, vector<uint32_t> &, uint32_t = 1,
+    uint32_t * = NULL, const Tolerances & = Tolerances());
+bool InteriorFeasibleBasis(const Problem &, Basis &, uint32_t = 1, uint32_t * = NULL);
+void ReadProblem(std::istream &, Problem &);
+void ScaleProblem(Problem &);
+void ReadSparseProblem(std::istream &, SparseMatrix &, vector<double> &);
+bool SolveFeasibility(Problem &, Basis &, Engine = ENGINE_TABLEAU,
+    PricingRule = PRICING_BLAND, uint32_t * = NULL, uint32_t = 1);
+void RunBatch(uint32_t, uint32_t, const std::function<void(uint32_t)> &);
@@ -0,0 +1,82 @@
+/**
+    Construction and transposition of compressed sparse matrices
+**/
+
+#include "SparseMatrix.h"
+
+/*
+    Builds a rows x cols CSC matrix from coordinate triples. Duplicate entries are
+    summed and entries that sum to zero are dropped.
+
+    param[in/out]: entries - sorted by (col, row) on return
+*/
+SparseMatrix CompressColumns(uint32_t rows, uint32_t cols, vector<Triple> &entries) {
+    std::sort(entries.begin(), entries.end(), [](const Triple &x, const Triple &y) {
+        return x.col < y.col || (x.col == y.col && x.row < y.row);
+    });
+
+    SparseMatrix A;
+    A.rows = rows;
+    A.cols = cols;
+    A.start.assign(cols + 1, 0);
+    A.index.reserve(entries.size());
+    A.value.reserve(entries.size());
+
+    for (size_t k = 0; k < entries.size();) {
+        Triple t = entries[k];
+        double sum = 0.;
+        for (; k < entries.size() && entries[k].col == t.col && entries[k].row == t.row; k++) {
+            sum += entries[k].value;
+        }
+        if (sum != 0.) {
+            A.index.push_back(t.row);
+            A.value.push_back(sum);
+            A.start[t.col + 1]++;
+        }
+    }
+    for (uint32_t j = 0; j < cols; j++) {
+        A.start[j + 1] += A.start[j];
+    }
+    return A;
+}
+
+/*
+    Returns the transpose of A, i.e. the CSR form of A if A is CSC. Entries of each
+    output column come out sorted since A's columns are scanned in order.
+*/
+SparseMatrix Transpose(const SparseMatrix &A) {
+    SparseMatrix T;
+    T.rows = A.cols;
+    T.cols = A.rows;
+    T.start.assign(A.rows + 1, 0);
+    T.index.resize(A.index.size());
+    T.value.resize(A.value.size());
+
+    for (size_t k = 0; k < A.index.size(); k++) {
+        T.start[A.index[k] + 1]++;
+    }
+    for (uint32_t i = 0; i < A.rows; i++) {
+        T.start[i + 1] += T.start[i];
+    }
+
+    vector<uint32_t> next(T.start.begin(), T.start.end() - 1);
+    for (uint32_t j = 0; j < A.cols; j++) {
+        for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+            uint32_t pos = next[A.index[k]]++;
+            T.index[pos] = j;
+            T.value[pos] = A.value[k];
+        }
+    }
+    return T;
+}
+
+// The first cols columns of A
+SparseMatrix LeadingColumns(const SparseMatrix &A, uint32_t cols) {
+    SparseMatrix leading;
+    leading.rows = A.rows;
+    leading.cols = cols;
+    leading.start.assign(A.start.begin(), A.start.begin() + cols + 1);
+    leading.index.assign(A.index.begin(), A.index.begin() + leading.start[cols]);
+    leading.value.assign(A.value.begin(), A.value.begin() + leading.start[cols]);
+    return leading;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+typedef struct Triple {
+    uint32_t row, col;
+    double value;
+} Triple;
+
+/*
+    Compressed sparse column (CSC) matrix: the nonzeros of column j are
+    (index[k], value[k]) for start[j] <= k < start[j + 1], sorted by row.
+
+    The transpose of a CSC matrix is the compressed sparse row (CSR) form of the same
+    matrix, so Transpose converts between the two.
+*/
+typedef struct SparseMatrix {
+    uint32_t rows, cols;
+    vector<uint32_t> start;
+    vector<uint32_t> index;
+    vector<double> value;
+} SparseMatrix;
+
+SparseMatrix CompressColumns(uint32_t, uint32_t, vector<Triple> &);
+SparseMatrix Transpose(const SparseMatrix &);
+SparseMatrix LeadingColumns(const SparseMatrix &, uint32_t);
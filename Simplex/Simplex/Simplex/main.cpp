@@ -0,0 +1,168 @@
+// Simplex driver
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include "LPSolver.h"
+#include "Presolve.h"
+#include "Simplex.h"
+#include "Stats.h"
+
+// How main reads and solves the problems of the input (see the flags in main)
+typedef struct Options {
+    Engine engine;
+    bool sparse, solve, presolve;
+    PricingRule rule, lpRule;
+    uint32_t threads;
+    LPSettings settings;
+} Options;
+
+/*
+    Reads the next problem of the input and returns the solve of it, which writes the
+    problem's answer to the stream it is given. The solve owns the problem, so solves of
+    different problems can run concurrently.
+*/
+std::function<void(std::ostream &)> ReadNext(std::istream &in, const Options &options) {
+    if (options.solve) {
+        std::shared_ptr<LinearProgram> lp = std::make_shared<LinearProgram>();
+        ReadLinearProgram(in, *lp);
+        return [lp, options](std::ostream &out) {
+            WriteSolution(out, options.presolve ? SolvePresolved(*lp, options.lpRule, options.settings) :
+                SolveLP(*lp, options.lpRule, NULL, options.settings));
+        };
+    }
+    if (options.sparse) {
+        std::shared_ptr<SparseMatrix> A = std::make_shared<SparseMatrix>();
+        std::shared_ptr<vector<double>> b = std::make_shared<vector<double>>();
+        ReadSparseProblem(in, *A, *b);
+        return [A, b, options](std::ostream &out) {
+            vector<uint32_t> B;
+            bool feasible = (options.engine == ENGINE_BARRIER) ?
+                BarrierFeasibleBasis(*A, *b, A->cols - A->rows, B, options.threads, NULL, options.settings.tolerances) :
+                SparseFeasibleBasis(*A, *b, A->cols - A->rows, B, options.rule, NULL, options.settings.tolerances);
+            if (feasible) {
+                for (vector<uint32_t>::iterator it = B.begin(); it != B.end(); it++) {
+                    out << *it + 1 << " ";
+                }
+                out << std::endl;
+            }
+            else {
+                out << "INFEASIBLE\n";
+            }
+        };
+    }
+
+    std::shared_ptr<Problem> P = std::make_shared<Problem>();
+    ReadProblem(in, *P);
+    P->tolerances = options.settings.tolerances;
+    P->scale = options.settings.scale;
+    return [P, options](std::ostream &out) {
+        Basis B;
+        if (SolveFeasibility(*P, B, options.engine, options.rule, NULL, options.threads)) {
+            for (Basis::iterator it = B.begin(); it != B.end(); it++) {
+                out << *it + 1 << " ";
+            }
+            out << std::endl;
+        }
+        else {
+            out << "INFEASIBLE\n";
+        }
+    };
+}
+
+int main(int argc, char *argv[]) {
+    // -r: phase one with the revised simplex method instead of the dense tableau
+    // -s: problems are given as coordinate triples (see ReadSparseProblem) and kept sparse
+    // -p <rule>: pricing rule for the revised method (bland, dantzig, partial, devex, steepest)
+    // -d: phase one on the contiguous, vectorised tableau
+    // -t <threads>: threads for each pivot of -d, and for the factorisations of -b
+    // -b: interior point method with crossover to a basis instead of phase one / the two phases of -l
+    // -l: problems are full LPs (see ReadLinearProgram); presolve and solve them and print x, y and reduced costs
+    // -n: no presolve for -l
+    // -j <workers>: batch mode, read every problem first and solve them on this many threads; output stays in input order
+    // -e <primal> <dual> <pivot>: tolerances (see Tolerances)
+    // -c: scale the problems before solving them (not for -s)
+    // -v: recheck the optimal basis of -l in exact rational arithmetic and print VERIFIED or NOT VERIFIED
+    Options options = { ENGINE_TABLEAU, false, false, true, PRICING_BLAND, PRICING_STEEPEST_EDGE, 1, LPSettings() };
+    bool ruleGiven = false;
+    uint32_t workers = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        options.sparse |= arg == "-s";
+        options.solve |= arg == "-l";
+        options.presolve &= arg != "-n";
+        options.settings.scale |= arg == "-c";
+        options.settings.verify |= arg == "-v";
+        if (arg == "-r") {
+            options.engine = ENGINE_REVISED;
+        }
+        else if (arg == "-d") {
+            options.engine = ENGINE_DENSE;
+        }
+        else if (arg == "-b") {
+            options.engine = ENGINE_BARRIER;
+            options.settings.barrier = true;
+        }
+        else if (arg == "-t" && i + 1 < argc) {
+            options.threads = std::max(std::atoi(argv[++i]), 1);
+        }
+        else if (arg == "-j" && i + 1 < argc) {
+            workers = std::max(std::atoi(argv[++i]), 1);
+        }
+        else if (arg == "-e" && i + 3 < argc) {
+            options.settings.tolerances.primal = std::atof(argv[++i]);
+            options.settings.tolerances.dual = std::atof(argv[++i]);
+            options.settings.tolerances.pivot = std::atof(argv[++i]);
+        }
+        else if (arg == "-p" && i + 1 < argc) {
+            std::string name(argv[++i]);
+            int k = 0;
+            while (k < PRICING_RULE_COUNT && name != pricingRuleNames[k]) {
+                k++;
+            }
+            if (k == PRICING_RULE_COUNT) {
+                std::cerr << "unknown pricing rule " << name << std::endl;
+                return 1;
+            }
+            options.rule = static_cast<PricingRule>(k);
+            ruleGiven = true;
+            options.engine = ENGINE_REVISED;
+        }
+    }
+    if (ruleGiven) {
+        options.lpRule = options.rule;
+    }
+    options.settings.threads = options.threads;
+
+    int problemCount;
+    std::cin >> problemCount;
+    if (workers == 1) {
+        // solve each problem as soon as it is read
+        for (int i = 0; i < problemCount; i++) {
+            STATS_BEGIN();
+            ReadNext(std::cin, options)(std::cout);
+            STATS_END("simplex", i, 1);
+        }
+        return 0;
+    }
+
+    vector<std::function<void(std::ostream &)>> solves;
+    for (int i = 0; i < problemCount; i++) {
+        solves.push_back(ReadNext(std::cin, options));
+    }
+    vector<std::string> output(solves.size());
+    // the solves run concurrently, so they are counted together
+    STATS_BEGIN();
+    RunBatch(static_cast<uint32_t>(solves.size()), workers, [&solves, &output](uint32_t i) {
+        std::ostringstream out;
+        solves[i](out);
+        output[i] = out.str();
+        // free the problem as soon as it is solved
+        solves[i] = nullptr;
+    });
+    STATS_END("simplex", 0, static_cast<uint32_t>(solves.size()));
+    for (vector<std::string>::iterator it = output.begin(); it != output.end(); it++) {
+        std::cout << *it;
+    }
+}
@@ -0,0 +1,133 @@
+/**
+    Parallel prefix doubling suffix array construction
+**/
+
+#include <algorithm>
+#include <thread>
+#include "ParallelSuffixArray.h"
+#include "Stats.h"
+
+// Number of buckets per radix pass
+#define RADIX_BUCKETS (1u << RADIX_BITS)
+
+// Start of slice j when [0, n) is cut into threads nearly equal slices
+static uint32_t Slice(uint32_t n, uint32_t threads, uint32_t j) {
+    return static_cast<uint32_t>(static_cast<uint64_t>(n) * j / threads);
+}
+
+/*
+    Runs f(j, begin, end) on each slice j of [0, n) at once, slice 0 on the calling thread.
+*/
+template<class F>
+static void ParallelFor(uint32_t threads, uint32_t n, F f) {
+    vector<std::thread> workers;
+    for (uint32_t j = 1; j < threads; j++) {
+        workers.push_back(std::thread(f, j, Slice(n, threads, j), Slice(n, threads, j + 1)));
+    }
+    f(0, 0, Slice(n, threads, 1));
+    for (vector<std::thread>::iterator it = workers.begin(); it != workers.end(); it++) {
+        it->join();
+    }
+}
+
+/*
+    Stable LSD radix sort of the keys, and the suffix indices along with them, by their
+    low bits. Each thread counts the digits of its slice, and then writes its part of
+    every bucket after the parts of the slices before it.
+
+    param[in]: keyOut, indexOut - scratch space of the same size
+*/
+static void RadixSort(vector<uint64_t> &key, vector<uint32_t> &index, vector<uint64_t> &keyOut,
+    vector<uint32_t> &indexOut, uint32_t bits, uint32_t threads) {
+    STATS_PHASE("RadixSort");
+    uint32_t n = key.size();
+    vector<vector<uint32_t>> count(threads, vector<uint32_t>(RADIX_BUCKETS));
+    for (uint32_t shift = 0; shift < bits; shift += RADIX_BITS) {
+        ParallelFor(threads, n, [&](uint32_t j, uint32_t begin, uint32_t end) {
+            vector<uint32_t> &c = count[j];
+            std::fill(c.begin(), c.end(), 0);
+            for (uint32_t i = begin; i < end; i++) {
+                c[(key[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+            }
+        });
+
+        uint32_t offset = 0;
+        for (uint32_t d = 0; d < RADIX_BUCKETS; d++) {
+            for (uint32_t j = 0; j < threads; j++) {
+                uint32_t c = count[j][d];
+                count[j][d] = offset;
+                offset += c;
+            }
+        }
+
+        ParallelFor(threads, n, [&](uint32_t j, uint32_t begin, uint32_t end) {
+            vector<uint32_t> &c = count[j];
+            for (uint32_t i = begin; i < end; i++) {
+                uint32_t to = c[(key[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+                keyOut[to] = key[i];
+                indexOut[to] = index[i];
+            }
+        });
+        key.swap(keyOut);
+        index.swap(indexOut);
+    }
+}
+
+void BuildSuffixArrayParallel(const std::string &t, vector<uint32_t> &sa, uint32_t threads) {
+    STATS_PHASE("BuildSuffixArrayParallel");
+    uint32_t n = t.size();
+    threads = std::max(1u, std::min(threads, n));
+    sa.resize(n);
+    vector<uint32_t> rank(n), indexOut(n), heads(threads);
+    vector<uint64_t> key(n), keyOut(n);
+
+    // 0 is left for the end of the text
+    ParallelFor(threads, n, [&](uint32_t, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            rank[i] = static_cast<uint8_t>(t[i]) + 1;
+        }
+    });
+    uint32_t ranks = 256;
+
+    // after the round for k, rank[i] is the rank of the first 2k characters of suffix i;
+    // once all n ranks differ they give the order of the whole suffixes
+    uint32_t k = 1;
+    do {
+        STATS_COUNT("doublingRounds", 1);
+        uint32_t bits = 0;
+        while ((1ull << bits) <= ranks) {
+            bits++;
+        }
+
+        ParallelFor(threads, n, [&](uint32_t, uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                key[i] = static_cast<uint64_t>(rank[i]) << bits | (k < n - i ? rank[i + k] : 0);
+                sa[i] = i;
+            }
+        });
+        RadixSort(key, sa, keyOut, indexOut, 2 * bits, threads);
+
+        // new ranks: a prefix sum over the starts of the groups of equal keys
+        ParallelFor(threads, n, [&](uint32_t j, uint32_t begin, uint32_t end) {
+            uint32_t h = 0;
+            for (uint32_t i = begin; i < end; i++) {
+                h += i == 0 || key[i] != key[i - 1];
+            }
+            heads[j] = h;
+        });
+        ranks = 0;
+        for (uint32_t j = 0; j < threads; j++) {
+            uint32_t h = heads[j];
+            heads[j] = ranks;
+            ranks += h;
+        }
+        ParallelFor(threads, n, [&](uint32_t j, uint32_t begin, uint32_t end) {
+            uint32_t r = heads[j];
+            for (uint32_t i = begin; i < end; i++) {
+                r += i == 0 || key[i] != key[i - 1];
+                rank[sa[i]] = r;
+            }
+        });
+        k <<= 1;
+    } while (ranks < n);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using std::vector;
+
+// Bits of the key sorted per radix pass
+#define RADIX_BITS 11
+
+/*
+    Suffix array of a text of any length (below 2^32 characters) by prefix doubling on
+    several threads. Each round sorts the suffixes by (rank of the first k characters, rank
+    of the next k) with a parallel LSD radix sort over only the bits the ranks need, then
+    renumbers them with a parallel prefix sum over the group boundaries, until every suffix
+    has a rank of its own.
+
+    Characters are ordered as unsigned bytes and the end of the text before all of them, so
+    on the '$'-terminated lowercase texts of BuildSuffixArray the result is the same.
+    Unlike BuildSuffixArray it keeps no global state and has no length limit; it needs
+    about 28 bytes of memory per character.
+
+    param[in]: threads - number of threads to sort and scan with (at least 1)
+    param[out]: sa - the suffix array
+*/
+void BuildSuffixArrayParallel(const std::string &, vector<uint32_t> &, uint32_t);
@@ -1,8 +1,67 @@
 #include "SuffixArray.h"
+#include "Stats.h"
+
+uint32_t len;
+
+// Tuples 
+vector<SuffixTuple *> tuples(MAX_LEN);
+// Storage for suffix array
+uint32_t A[MAX_LEN];
+// Storage for suffix array
+uint32_t SuffixArray[MAX_LEN];
+
+// Buckets for sorting
+vector<list<SuffixTuple *>> buckets(MAX_LEN);
+
+void AllocateTuples() {
+    for (uint32_t i = 0; i < MAX_LEN; i++) {
+        tuples[i] = new SuffixTuple();
+    }
+}
+
+uint8_t CharToDigit(char a) {
+    if (a == '$') {
+        return 0;
+    }
+    else {
+        return a - 96;
+    }
+}
+
+void BucketSort(bool sortByMSD) {
+    for (uint32_t i = 0; i < len; i++) {
+        if (sortByMSD) {
+            buckets[tuples[i]->msb].push_back(tuples[i]);
+        }
+        else {
+            buckets[tuples[i]->lsb].push_back(tuples[i]);
+        }
+    }
+
+    // iterate over buckets, put back into tuples array
+    uint32_t j = 0;
+    uint32_t numBuckets = MAX(len, NUM_CHARS);
+    for (uint32_t i = 0; i < numBuckets; i++) {
+        list<SuffixTuple *>::iterator it = buckets[i].begin();
+        for (; it != buckets[i].end(); it++) {
+            tuples[j] = *it;
+            j++;
+        }
+        buckets[i].clear();
+    }
+}
+
+void TupleSort() {
+    STATS_PHASE("TupleSort");
+    BucketSort(false);
+    BucketSort(true);
+}
 
 void BuildSuffixArray() {
+    STATS_PHASE("BuildSuffixArray");
     uint32_t k = 1;
     while (k < len) {
+        STATS_COUNT("doublingRounds", 1);
         // build the tuples from A
         for (uint32_t i = 0; i < len; i++) {
             if (A[i] == 0) {
@@ -41,33 +100,14 @@ void BuildSuffixArray() {
     }
 }
 
-int main() {
-    uint32_t n;
-    std::cin >> n;
+// Translate t (lowercase letters terminated by '$') into A and build its suffix array
+void BuildSuffixArray(const std::string &t) {
+    len = t.length();
 
-    for (uint32_t i = 0; i < MAX_LEN; i++) {
-        tuples[i] = new SuffixTuple();
+    // translate
+    for (uint32_t i = 0; i < len; i++) {
+        A[i] = CharToDigit(t[i]);
     }
-   
-    std::string t; 
-    for (uint32_t i = 0; i < n; i++) {
-        // read in string
-        std::cin >> t;
-        t += "$";
-        len = t.length();
-        
-        // translate
-        for (uint32_t i = 0; i < len; i++) {
-            A[i] = CharToDigit(t[i]);
-        }
-
-        // build suffix array
-        BuildSuffixArray();
 
-        // output array
-        for (uint32_t i = 0; i < len; i++) {
-            std::cout << SuffixArray[i] << " ";
-        }
-        std::cout << std::endl;
-    }
-}
\ No newline at end of file
+    BuildSuffixArray();
+}
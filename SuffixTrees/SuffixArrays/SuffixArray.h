@@ -5,6 +5,7 @@
 #include <iostream>
 #include <vector>
 #include <list>
+#include <string>
 
 #define MIN(a,b) ((a) < (b) ? (a) : (b))
 #define MAX(a,b) ((a) > (b) ? (a) : (b))
@@ -17,52 +18,21 @@ typedef struct SuffixTuple {
     uint32_t msb, lsb, index;
 } SuffixTuple;
 
-uint32_t len;
+extern uint32_t len;
 
 // Tuples 
-vector<SuffixTuple *> tuples(MAX_LEN);
+extern vector<SuffixTuple *> tuples;
 // Storage for suffix array
-uint32_t A[MAX_LEN];
+extern uint32_t A[MAX_LEN];
 // Storage for suffix array
-uint32_t SuffixArray[MAX_LEN];
+extern uint32_t SuffixArray[MAX_LEN];
 
 // Buckets for sorting
-vector<list<SuffixTuple *>> buckets(MAX_LEN);
-
-uint8_t CharToDigit(char a) {
-    if (a == '$') {
-        return 0;
-    }
-    else {
-        return a - 96;
-    }
-}
-
-void BucketSort(bool sortByMSD) {
-    for (uint32_t i = 0; i < len; i++) {
-        if (sortByMSD) {
-            buckets[tuples[i]->msb].push_back(tuples[i]);
-        }
-        else {
-            buckets[tuples[i]->lsb].push_back(tuples[i]);
-        }
-    }
-
-    // iterate over buckets, put back into tuples array
-    uint32_t j = 0;
-    uint32_t numBuckets = MAX(len, NUM_CHARS);
-    for (uint32_t i = 0; i < numBuckets; i++) {
-        list<SuffixTuple *>::iterator it = buckets[i].begin();
-        for (; it != buckets[i].end(); it++) {
-            tuples[j] = *it;
-            j++;
-        }
-        buckets[i].clear();
-    }
-}
-
-void TupleSort() {
-    BucketSort(false);
-    BucketSort(true);
-}
-
+extern vector<list<SuffixTuple *>> buckets;
+
+void AllocateTuples();
+uint8_t CharToDigit(char);
+void BucketSort(bool);
+void TupleSort();
+void BuildSuffixArray();
+void BuildSuffixArray(const std::string &);
@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <cstdlib>
+#include "ParallelSuffixArray.h"
+#include "SuffixArray.h"
+#include "Stats.h"
+
+int main(int argc, char *argv[]) {
+    // -t <threads>: build with BuildSuffixArrayParallel on that many threads, for texts of any length
+    uint32_t threads = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        if (arg == "-t" && i + 1 < argc) {
+            threads = std::max(std::atoi(argv[++i]), 1);
+        }
+    }
+
+    uint32_t n;
+    std::cin >> n;
+
+    if (!threads) {
+        AllocateTuples();
+    }
+   
+    std::string t; 
+    vector<uint32_t> sa;
+    for (uint32_t i = 0; i < n; i++) {
+        // read in string
+        std::cin >> t;
+        t += "$";
+        STATS_BEGIN();
+
+        // build suffix array
+        if (threads) {
+            BuildSuffixArrayParallel(t, sa, threads);
+        }
+        else {
+            BuildSuffixArray(t);
+            sa.assign(SuffixArray, SuffixArray + len);
+        }
+
+        // output array
+        for (uint32_t i = 0; i < sa.size(); i++) {
+            std::cout << sa[i] << " ";
+        }
+        std::cout << std::endl;
+        STATS_END("suffixarray", i, 1);
+    }
+}
\ No newline at end of file
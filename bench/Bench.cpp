@@ -0,0 +1,100 @@
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include "Bench.h"
+
+std::atomic<uint64_t> allocationCount(0);
+std::atomic<uint64_t> allocationBytes(0);
+
+// Count every heap allocation made through operator new
+void *operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    void *p = std::malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+    std::free(p);
+}
+
+uint32_t Repetitions(int argc, char *argv[]) {
+    return (argc > 1) ? std::max(std::stoul(argv[1]), 1ul) : DEFAULT_REPETITIONS;
+}
+
+void PrintHeader(const std::string &title) {
+    std::cout << std::endl << "== " << title << std::endl;
+    std::cout << std::left << std::setw(40) << "case" << std::right
+        << std::setw(12) << "median ms" << std::setw(12) << "p90 ms" << std::setw(12) << "max ms"
+        << std::setw(12) << "allocs" << std::setw(12) << "alloc MB" << "  throughput" << std::endl;
+}
+
+/*
+    Prints the median, 90th percentile and maximum time of the samples, the median
+    allocation count and volume per run, and items / median time.
+*/
+void Report(const std::string &name, vector<Sample> samples, double items, const std::string &unit) {
+    vector<double> times;
+    vector<uint64_t> allocations, bytes;
+    for (vector<Sample>::iterator it = samples.begin(); it != samples.end(); it++) {
+        times.push_back(it->seconds);
+        allocations.push_back(it->allocations);
+        bytes.push_back(it->bytes);
+    }
+    std::sort(times.begin(), times.end());
+    std::sort(allocations.begin(), allocations.end());
+    std::sort(bytes.begin(), bytes.end());
+
+    size_t mid = times.size() / 2;
+    size_t p90 = std::min(times.size() - 1, static_cast<size_t>(0.9 * times.size()));
+    std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(3)
+        << std::setw(12) << 1e3 * times[mid] << std::setw(12) << 1e3 * times[p90]
+        << std::setw(12) << 1e3 * times.back() << std::setw(12) << allocations[mid]
+        << std::setw(12) << bytes[mid] / 1e6 << "  ";
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(4) << items / times[mid] << " " << unit << "/s" << std::endl;
+}
+
+// Strip carriage returns, trailing spaces on each line and trailing blank lines
+std::string Normalize(const std::string &text) {
+    std::istringstream in(text);
+    std::string line, out, pending;
+    while (std::getline(in, line)) {
+        line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+        line.erase(line.find_last_not_of(" \t") + 1);
+        pending += line + "\n";
+        if (!line.empty()) {
+            out += pending;
+            pending.clear();
+        }
+    }
+    return out;
+}
+
+std::string ReadFile(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
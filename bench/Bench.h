@@ -0,0 +1,51 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using std::vector;
+
+/*
+    Shared helpers for the benchmark programs: wall-clock timing, heap allocation
+    counting, percentile reports and output comparison.
+*/
+
+// Default number of timed repetitions per case, override with the first argument
+#define DEFAULT_REPETITIONS 5
+
+// Updated by the replacement operator new in Bench.cpp
+extern std::atomic<uint64_t> allocationCount;
+extern std::atomic<uint64_t> allocationBytes;
+
+typedef struct Sample {
+    double seconds;
+    uint64_t allocations, bytes;
+} Sample;
+
+uint32_t Repetitions(int, char *[]);
+void PrintHeader(const std::string &);
+void Report(const std::string &, vector<Sample>, double, const std::string &);
+std::string Normalize(const std::string &);
+std::string ReadFile(const std::string &);
+
+/*
+    Runs f() reps times and returns the time and heap traffic of each run.
+*/
+template <typename F>
+vector<Sample> Measure(uint32_t reps, F f) {
+    vector<Sample> samples;
+    for (uint32_t i = 0; i < reps; i++) {
+        uint64_t allocations = allocationCount.load(), bytes = allocationBytes.load();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        f();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        Sample s = { seconds, allocationCount.load() - allocations, allocationBytes.load() - bytes };
+        samples.push_back(s);
+    }
+    return samples;
+}
@@ -0,0 +1,557 @@
+/**
+    Edmond-Karp and push-relabel on random, layered and grid flow networks.
+    Both engines must agree on the flow value, on graphs built edge by edge and in bulk.
+    Also times bulk construction of the flat adjacency on networks with high-degree hubs,
+    and loading a network from DIMACS text against mapping its binary graph file.
+    Minimum cost flows by successive shortest paths and cost scaling must agree on cost.
+    Hopcroft-Karp must find matchings as large as the flows of the general engines.
+    Boykov-Kolmogorov segments generated images of 1 to 16 megapixels on implicit grids,
+    checked against itself on the explicit network and against Edmond-Karp on small ones.
+    Gomory-Hu trees are built on 1..N threads, and their cuts checked against single max flows.
+
+    usage: maxflow_bench [repetitions]
+**/
+
+#include <cmath>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include "Bench.h"
+#include "BoykovKolmogorov.h"
+#include "Graph.h"
+#include "GomoryHu.h"
+#include "GraphFile.h"
+#include "GridGraph.h"
+#include "Matching.h"
+#include "MinCostFlow.h"
+
+typedef std::tuple<uint16_t, uint16_t, uint32_t> Arc;
+
+typedef struct Network {
+    uint16_t order, source, sink;
+    vector<Arc> arcs;
+} Network;
+
+// order vertices, size arcs between distinct random endpoints
+Network RandomNetwork(uint16_t order, uint32_t size, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint16_t> vertex(1, order);
+    std::uniform_int_distribution<uint32_t> cap(1, 100);
+    Network net = { order, 1, order, vector<Arc>() };
+    while (net.arcs.size() < size) {
+        uint16_t u = vertex(gen), v = vertex(gen);
+        if (u != v) {
+            net.arcs.push_back(Arc(u, v, cap(gen)));
+        }
+    }
+    return net;
+}
+
+// layers x width vertices, each joined to degree random vertices of the next layer
+Network LayeredNetwork(uint16_t layers, uint16_t width, uint16_t degree, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint16_t> column(0, width - 1);
+    std::uniform_int_distribution<uint32_t> cap(1, 100);
+    uint16_t order = layers * width + 2;
+    Network net = { order, 1, order, vector<Arc>() };
+    for (uint16_t w = 0; w < width; w++) {
+        net.arcs.push_back(Arc(1, 2 + w, cap(gen)));
+        net.arcs.push_back(Arc(2 + (layers - 1) * width + w, order, cap(gen)));
+    }
+    for (uint16_t l = 0; l + 1 < layers; l++) {
+        for (uint16_t w = 0; w < width; w++) {
+            for (uint16_t d = 0; d < degree; d++) {
+                net.arcs.push_back(Arc(2 + l * width + w, 2 + (l + 1) * width + column(gen), cap(gen)));
+            }
+        }
+    }
+    return net;
+}
+
+// rows x cols 4-connected grid, source feeds the first column and the last column drains to sink
+Network GridNetwork(uint16_t rows, uint16_t cols, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint32_t> cap(1, 100);
+    uint16_t order = rows * cols + 2;
+    Network net = { order, 1, order, vector<Arc>() };
+    for (uint16_t r = 0; r < rows; r++) {
+        net.arcs.push_back(Arc(1, 2 + r * cols, cap(gen)));
+        net.arcs.push_back(Arc(2 + r * cols + cols - 1, order, cap(gen)));
+        for (uint16_t c = 0; c < cols; c++) {
+            uint16_t v = 2 + r * cols + c;
+            if (c + 1 < cols) {
+                net.arcs.push_back(Arc(v, v + 1, cap(gen)));
+                net.arcs.push_back(Arc(v + 1, v, cap(gen)));
+            }
+            if (r + 1 < rows) {
+                net.arcs.push_back(Arc(v, v + cols, cap(gen)));
+                net.arcs.push_back(Arc(v + cols, v, cap(gen)));
+            }
+        }
+    }
+    return net;
+}
+
+// order vertices, size arcs, each with one endpoint among the first hubs vertices; hubs
+// feed odd vertices and drain even ones, so that few arcs are antiparallel
+Network HubNetwork(uint16_t order, uint16_t hubs, uint32_t size, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint16_t> hub(1, hubs), vertex(1, order);
+    std::uniform_int_distribution<uint32_t> cap(1, 100);
+    Network net = { order, 1, order, vector<Arc>() };
+    while (net.arcs.size() < size) {
+        uint16_t u = hub(gen), v = vertex(gen);
+        if (u != v) {
+            net.arcs.push_back((v % 2) ? Arc(u, v, cap(gen)) : Arc(v, u, cap(gen)));
+        }
+    }
+    return net;
+}
+
+vector<FlowEdge> Edges(const Network &net) {
+    vector<FlowEdge> edges;
+    edges.reserve(net.arcs.size());
+    for (vector<Arc>::const_iterator it = net.arcs.begin(); it != net.arcs.end(); it++) {
+        FlowEdge e = { std::get<0>(*it), std::get<1>(*it), std::get<2>(*it) };
+        edges.push_back(e);
+    }
+    return edges;
+}
+
+Graph BuildBulk(const Network &net) {
+    vector<FlowEdge> edges = Edges(net);
+    return Graph(BuildFlowNetwork(net.order, edges));
+}
+
+Graph Build(const Network &net) {
+    Graph g(net.order);
+    for (vector<Arc>::const_iterator it = net.arcs.begin(); it != net.arcs.end(); it++) {
+        g.AddEdgeNoReversal(std::get<0>(*it), std::get<1>(*it), std::get<2>(*it));
+    }
+    return g;
+}
+
+// Returns false if the engines disagree
+bool Run(const std::string &name, const Network &net, uint32_t reps) {
+    uint32_t ek = 0, pr = 0, edgewise = Build(net).EdmondKarp(net.source, net.sink);
+    Report(name + " build", Measure(reps, [&]() { Build(net); }), net.arcs.size(), "arcs");
+    Report(name + " bulk build", Measure(reps, [&]() { BuildBulk(net); }), net.arcs.size(), "arcs");
+    Report(name + " EdmondKarp", Measure(reps, [&]() { ek = BuildBulk(net).EdmondKarp(net.source, net.sink); }),
+        net.arcs.size(), "arcs");
+    Report(name + " PushRelabel", Measure(reps, [&]() { pr = BuildBulk(net).PushRelabelFlow(net.source, net.sink); }),
+        net.arcs.size(), "arcs");
+    if (ek != pr || ek != edgewise) {
+        std::cout << "MISMATCH " << name << ": EdmondKarp " << ek << ", PushRelabel " << pr
+            << ", EdmondKarp built edge by edge " << edgewise << std::endl;
+    }
+    return ek == pr && ek == edgewise;
+}
+
+// Edge by edge and bulk construction of Graph, then the flat adjacency alone on 1..N threads
+void RunBuild(const std::string &name, const Network &net, uint32_t reps, bool edgewise) {
+    if (edgewise) {
+        Report(name + " build", Measure(reps, [&]() { Build(net); }), net.arcs.size(), "arcs");
+    }
+    Report(name + " bulk build", Measure(reps, [&]() { BuildBulk(net); }), net.arcs.size(), "arcs");
+    uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (uint32_t threads = 1; threads <= maxThreads; threads *= 2) {
+        vector<Sample> samples;
+        for (uint32_t i = 0; i < reps; i++) {
+            // copying the edges is not part of the build
+            vector<FlowEdge> edges = Edges(net);
+            vector<Sample> one = Measure(1, [&]() { BuildFlowNetwork(net.order, edges, threads); });
+            samples.push_back(one[0]);
+        }
+        std::ostringstream label;
+        label << name << " FlowNetwork t=" << threads;
+        Report(label.str(), samples, net.arcs.size(), "arcs");
+    }
+}
+
+// Parsing DIMACS text and building the adjacency, against mapping a binary graph file;
+// returns false if they disagree
+bool RunLoad(const std::string &name, const Network &net, uint32_t reps) {
+    std::ostringstream text;
+    text << "p max " << net.order << " " << net.arcs.size() << "\nn " << net.source << " s\nn " << net.sink << " t\n";
+    for (vector<Arc>::const_iterator it = net.arcs.begin(); it != net.arcs.end(); it++) {
+        text << "a " << std::get<0>(*it) << " " << std::get<1>(*it) << " " << std::get<2>(*it) << "\n";
+    }
+    std::string dimacs = text.str();
+    const char *path = "maxflow_bench.graph";
+    vector<FlowEdge> edges = Edges(net);
+    FlowNetwork network = BuildFlowNetwork(net.order, edges);
+    WriteGraphFile(path, network, net.source, net.sink);
+    uint64_t expected = 0, parsed = 0, mapped = 0;
+    for (size_t k = 0; k < network.capacity.size(); k++) {
+        expected += network.capacity[k];
+    }
+
+    Report(name + " DIMACS", Measure(reps, [&]() {
+        std::istringstream in(dimacs);
+        uint32_t order, source, sink;
+        vector<FlowEdge> read;
+        ReadDimacs(in, order, source, sink, read);
+        FlowNetwork built = BuildFlowNetwork(order, read);
+        parsed = 0;
+        for (size_t k = 0; k < built.capacity.size(); k++) {
+            parsed += built.capacity[k];
+        }
+    }), net.arcs.size(), "arcs");
+    // summing the capacities touches every page of the mapping
+    Report(name + " mapped", Measure(reps, [&]() {
+        MappedGraphFile file;
+        file.Open(path);
+        const FlowNetworkView &view = file.View();
+        mapped = 0;
+        for (uint32_t k = 0; k < view.first[view.order + 1]; k++) {
+            mapped += view.capacity[k];
+        }
+    }), net.arcs.size(), "arcs");
+    remove(path);
+    if (parsed != expected || mapped != expected) {
+        std::cout << "MISMATCH " << name << ": total capacity " << expected << ", parsed " << parsed
+            << ", mapped " << mapped << std::endl;
+    }
+    return parsed == expected && mapped == expected;
+}
+
+// left x right unit-capacity bipartite network, each left vertex joined to degree random right ones
+Network BipartiteNetwork(uint16_t left, uint16_t right, uint16_t degree, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint16_t> column(0, right - 1);
+    uint16_t order = left + right + 2;
+    Network net = { order, static_cast<uint16_t>(order - 1), order, vector<Arc>() };
+    for (uint16_t u = 1; u <= left; u++) {
+        net.arcs.push_back(Arc(net.source, u, 1));
+        for (uint16_t d = 0; d < degree; d++) {
+            net.arcs.push_back(Arc(u, left + 1 + column(gen), 1));
+        }
+    }
+    for (uint16_t v = left + 1; v <= left + right; v++) {
+        net.arcs.push_back(Arc(v, net.sink, 1));
+    }
+    return net;
+}
+
+// Returns false if Hopcroft-Karp and the general engines disagree
+bool RunMatching(const std::string &name, const Network &net, uint32_t reps, bool general) {
+    vector<FlowEdge> edges = Edges(net);
+    FlowNetwork network = BuildFlowNetwork(net.order, edges);
+    vector<uint32_t> left;
+    if (!IsUnitBipartite(View(network), net.source, net.sink, left)) {
+        std::cout << "MISMATCH " << name << ": not detected as a bipartite matching instance" << std::endl;
+        return false;
+    }
+    uint32_t matched = 0, ek = 0, pr = 0;
+    Report(name + " HopcroftKarp", Measure(reps, [&]() {
+        IsUnitBipartite(View(network), net.source, net.sink, left);
+        matched = HopcroftKarp(View(network), left).size;
+    }), net.arcs.size(), "arcs");
+    if (!general) {
+        return true;
+    }
+    Report(name + " EdmondKarp", Measure(reps, [&]() { ek = Graph(network).EdmondKarp(net.source, net.sink); }),
+        net.arcs.size(), "arcs");
+    Report(name + " PushRelabel", Measure(reps, [&]() { pr = Graph(network).PushRelabelFlow(net.source, net.sink); }),
+        net.arcs.size(), "arcs");
+    if (matched != ek || matched != pr) {
+        std::cout << "MISMATCH " << name << ": HopcroftKarp " << matched << ", EdmondKarp " << ek
+            << ", PushRelabel " << pr << std::endl;
+    }
+    return matched == ek && matched == pr;
+}
+
+typedef struct Image {
+    uint32_t width, height;
+    vector<uint8_t> pixels;
+} Image;
+
+// Bright random discs on a dark background, with noise
+Image SegmentationImage(uint32_t width, uint32_t height, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::normal_distribution<double> noise(0, 40);
+    Image image = { width, height, vector<uint8_t>(static_cast<size_t>(width) * height) };
+    vector<std::tuple<double, double, double>> discs;
+    for (uint32_t i = 0; i < 12; i++) {
+        discs.push_back(std::make_tuple(unit(gen) * width, unit(gen) * height, (0.05 + 0.1 * unit(gen)) * width));
+    }
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            double value = 60;
+            for (size_t i = 0; i < discs.size(); i++) {
+                double dx = x - std::get<0>(discs[i]), dy = y - std::get<1>(discs[i]);
+                if (dx * dx + dy * dy < std::get<2>(discs[i]) * std::get<2>(discs[i])) {
+                    value = 190;
+                }
+            }
+            image.pixels[static_cast<size_t>(y) * width + x] =
+                static_cast<uint8_t>(std::min(255.0, std::max(0.0, value + noise(gen))));
+        }
+    }
+    return image;
+}
+
+/*
+    Calls f(x, y, direction, capacity) for every arc between neighbouring pixels of the
+    segmentation of image, and f(x, y, source, sink) with direction GRID_DIRECTIONS for
+    the terminal arcs. Pixels pay their distance from the background and foreground
+    intensities to be foreground and background; neighbours pay more to be split the
+    closer their intensities.
+*/
+template <typename F>
+void SegmentationArcs(const Image &image, bool diagonal, F f) {
+    static const int dx[GRID_DIRECTIONS] = { 1, -1, 0, 0, 1, -1, -1, 1 };
+    static const int dy[GRID_DIRECTIONS] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+    uint32_t directions = diagonal ? 8 : 4;
+    for (uint32_t y = 0; y < image.height; y++) {
+        for (uint32_t x = 0; x < image.width; x++) {
+            int p = image.pixels[static_cast<size_t>(y) * image.width + x];
+            f(x, y, GRID_DIRECTIONS, std::abs(p - 60), std::abs(p - 190));
+            for (uint32_t d = 0; d < directions; d++) {
+                int64_t nx = static_cast<int64_t>(x) + dx[d], ny = static_cast<int64_t>(y) + dy[d];
+                if (nx < 0 || ny < 0 || nx >= image.width || ny >= image.height) {
+                    continue;
+                }
+                int q = image.pixels[static_cast<size_t>(ny) * image.width + nx];
+                uint32_t weight = static_cast<uint32_t>(60 * std::exp(-(p - q) * (p - q) / 3200.0) / (d < 4 ? 1 : 1.4142));
+                f(x, y, d, weight, 0);
+            }
+        }
+    }
+}
+
+GridGraph SegmentationGrid(const Image &image, bool diagonal) {
+    GridGraph grid(image.width, image.height, diagonal);
+    SegmentationArcs(image, diagonal, [&](uint32_t x, uint32_t y, uint32_t d, uint32_t a, uint32_t b) {
+        if (d == GRID_DIRECTIONS) {
+            grid.SetTerminals(x, y, a, b);
+        }
+        else {
+            grid.SetEdge(x, y, static_cast<GridDirection>(d), a);
+        }
+    });
+    return grid;
+}
+
+// The same segmentation as an explicit flow network, pixel (x, y) being vertex y * width + x + 1
+FlowNetwork SegmentationNetwork(const Image &image, bool diagonal, uint32_t &source, uint32_t &sink) {
+    uint32_t pixels = image.width * image.height;
+    source = pixels + 1;
+    sink = pixels + 2;
+    vector<FlowEdge> edges;
+    SegmentationArcs(image, diagonal, [&](uint32_t x, uint32_t y, uint32_t d, uint32_t a, uint32_t b) {
+        uint32_t v = y * image.width + x + 1;
+        if (d == GRID_DIRECTIONS) {
+            FlowEdge in = { source, v, a }, out = { v, sink, b };
+            edges.push_back(in);
+            edges.push_back(out);
+            return;
+        }
+        static const int dx[GRID_DIRECTIONS] = { 1, -1, 0, 0, 1, -1, -1, 1 };
+        static const int dy[GRID_DIRECTIONS] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+        FlowEdge e = { v, static_cast<uint32_t>(v + dy[d] * static_cast<int64_t>(image.width) + dx[d]), a };
+        edges.push_back(e);
+    });
+    return BuildFlowNetwork(pixels + 2, edges);
+}
+
+/*
+    Boykov-Kolmogorov on the implicit grid and on the explicit network, and Edmond-Karp if
+    asked for. Returns false if they disagree.
+*/
+bool RunGrid(const std::string &name, const Image &image, bool diagonal, uint32_t reps, bool explicitNetwork, bool general) {
+    uint64_t pixels = static_cast<uint64_t>(image.width) * image.height, grid = 0, terminal = 0, ek = 0;
+    Report(name + " grid build", Measure(reps, [&]() { SegmentationGrid(image, diagonal); }), pixels, "pixels");
+    vector<Sample> samples;
+    for (uint32_t i = 0; i < reps; i++) {
+        // solving consumes the capacities, so every run needs its own grid
+        GridGraph g = SegmentationGrid(image, diagonal);
+        samples.push_back(Measure(1, [&]() { grid = BoykovKolmogorov<GridGraph>(g).MaxFlow(); })[0]);
+    }
+    Report(name + " grid BoykovKolmogorov", samples, pixels, "pixels");
+    if (!explicitNetwork) {
+        return true;
+    }
+    uint32_t source, sink;
+    FlowNetwork network = SegmentationNetwork(image, diagonal, source, sink);
+    Report(name + " network BoykovKolmogorov", Measure(reps, [&]() {
+        TerminalNetwork t(View(network));
+        t.SetTerminals(source, sink);
+        terminal = BoykovKolmogorov<TerminalNetwork>(t).MaxFlow() + t.DirectFlow();
+    }), pixels, "pixels");
+    if (general) {
+        Report(name + " EdmondKarp", Measure(reps, [&]() { ek = Graph(network).EdmondKarp(source, sink); }),
+            pixels, "pixels");
+    }
+    bool agree = grid == terminal && (!general || grid == ek);
+    if (!agree) {
+        std::cout << "MISMATCH " << name << ": grid " << grid << ", network " << terminal;
+        if (general) {
+            std::cout << ", EdmondKarp " << ek;
+        }
+        std::cout << std::endl;
+    }
+    return agree;
+}
+
+/*
+    Gomory-Hu tree of net as an undirected network on 1..N threads, against a max flow per
+    pair for some random pairs. Returns false if any cut differs.
+*/
+bool RunGomoryHu(const std::string &name, const Network &net, uint32_t reps, uint32_t pairs) {
+    vector<FlowEdge> edges = Edges(net);
+    for (vector<FlowEdge>::iterator it = edges.begin(); it != edges.end(); it++) {
+        if (it->tail > it->head) {
+            std::swap(it->tail, it->head);
+        }
+    }
+    FlowNetwork network = BuildFlowNetwork(net.order, edges);
+    uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (uint32_t threads = 1; threads <= maxThreads; threads *= 2) {
+        std::ostringstream label;
+        label << name << " GomoryHu t=" << threads;
+        Report(label.str(), Measure(reps, [&]() { GomoryHuTree tree(View(network), threads); }), net.order, "vertices");
+    }
+
+    GomoryHuTree tree(View(network));
+    std::mt19937 gen(net.order);
+    std::uniform_int_distribution<uint32_t> vertex(1, net.order);
+    vector<std::pair<uint32_t, uint32_t>> sample;
+    while (sample.size() < pairs) {
+        uint32_t u = vertex(gen), v = vertex(gen);
+        if (u != v) {
+            sample.push_back(std::make_pair(u, v));
+        }
+    }
+    vector<uint64_t> cuts(pairs);
+    TerminalNetwork terminals(View(network), true);
+    BoykovKolmogorov<TerminalNetwork> engine(terminals);
+    Report(name + " max flow per pair", Measure(reps, [&]() {
+        for (uint32_t i = 0; i < pairs; i++) {
+            terminals.SetTerminals(sample[i].first, sample[i].second);
+            cuts[i] = engine.MaxFlow() + terminals.DirectFlow();
+        }
+    }), pairs, "pairs");
+    for (uint32_t i = 0; i < pairs; i++) {
+        if (cuts[i] != tree.MinCut(sample[i].first, sample[i].second)) {
+            std::cout << "MISMATCH " << name << ": cut between " << sample[i].first << " and " << sample[i].second
+                << " is " << cuts[i] << ", tree says " << tree.MinCut(sample[i].first, sample[i].second) << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+typedef struct CostProblem {
+    uint32_t order, source, sink;
+    vector<CostEdge> edges;
+} CostProblem;
+
+// n workers and n jobs, each worker able to do degree random jobs at a random cost
+CostProblem AssignmentProblem(uint32_t n, uint32_t degree, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint32_t> job(0, n - 1);
+    std::uniform_int_distribution<int32_t> cost(1, 1000);
+    CostProblem p = { 2 * n + 2, 2 * n + 1, 2 * n + 2, vector<CostEdge>() };
+    for (uint32_t w = 1; w <= n; w++) {
+        CostEdge in = { p.source, w, 1, 0 }, out = { n + w, p.sink, 1, 0 };
+        p.edges.push_back(in);
+        p.edges.push_back(out);
+        for (uint32_t d = 0; d < degree; d++) {
+            CostEdge e = { w, n + 1 + job(gen), 1, cost(gen) };
+            p.edges.push_back(e);
+        }
+    }
+    return p;
+}
+
+// suppliers ship to every consumer at a random unit cost, with random supplies and demands
+CostProblem TransportProblem(uint32_t suppliers, uint32_t consumers, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint32_t> amount(100, 10000);
+    std::uniform_int_distribution<int32_t> cost(1, 1000);
+    uint32_t order = suppliers + consumers + 2;
+    CostProblem p = { order, order - 1, order, vector<CostEdge>() };
+    for (uint32_t s = 1; s <= suppliers; s++) {
+        CostEdge supply = { p.source, s, amount(gen), 0 };
+        p.edges.push_back(supply);
+        for (uint32_t c = 1; c <= consumers; c++) {
+            CostEdge e = { s, suppliers + c, UINT32_MAX / 2, cost(gen) };
+            p.edges.push_back(e);
+        }
+    }
+    for (uint32_t c = 1; c <= consumers; c++) {
+        CostEdge demand = { suppliers + c, p.sink, amount(gen), 0 };
+        p.edges.push_back(demand);
+    }
+    return p;
+}
+
+// Returns false if the algorithms disagree on the flow or its cost
+bool RunMinCost(const std::string &name, const CostProblem &p, uint32_t reps) {
+    CostNetwork network(p.order, p.edges);
+    MinCostFlowResult results[MIN_COST_ALGORITHM_COUNT];
+    for (int k = 0; k < MIN_COST_ALGORITHM_COUNT; k++) {
+        MinCostAlgorithm algorithm = static_cast<MinCostAlgorithm>(k);
+        Report(name + " " + minCostAlgorithmNames[k], Measure(reps, [&]() {
+            results[k] = network.Solve(algorithm, p.source, p.sink);
+        }), p.edges.size(), "arcs");
+    }
+    bool agree = true;
+    for (int k = 1; k < MIN_COST_ALGORITHM_COUNT; k++) {
+        if (results[k].flow != results[0].flow || results[k].cost != results[0].cost) {
+            std::cout << "MISMATCH " << name << ": ssp " << results[0].flow << " at " << results[0].cost
+                << ", " << minCostAlgorithmNames[k] << " " << results[k].flow << " at " << results[k].cost << std::endl;
+            agree = false;
+        }
+    }
+    return agree;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t reps = Repetitions(argc, argv);
+    bool ok = true;
+
+    PrintHeader("maxflow (build includes Graph construction)");
+    ok &= Run("random V=100 E=1000", RandomNetwork(100, 1000, 1), reps);
+    ok &= Run("random V=200 E=4000", RandomNetwork(200, 4000, 2), reps);
+    ok &= Run("layered 8x25 d=4", LayeredNetwork(8, 25, 4, 3), reps);
+    ok &= Run("layered 16x50 d=4", LayeredNetwork(16, 50, 4, 4), reps);
+    ok &= Run("grid 10x10", GridNetwork(10, 10, 5), reps);
+    ok &= Run("grid 20x20", GridNetwork(20, 20, 6), reps);
+
+    PrintHeader("Graph construction with high-degree hubs (edge by edge vs BuildFlowNetwork)");
+    RunBuild("hubs V=5000 H=4 E=20000", HubNetwork(5000, 4, 20000, 7), reps, true);
+    RunBuild("hubs V=60000 H=16 E=2000000", HubNetwork(60000, 16, 2000000, 8), reps, false);
+
+    PrintHeader("Loading a network (DIMACS text vs mapped binary graph file)");
+    ok &= RunLoad("random V=60000 E=2000000", RandomNetwork(60000, 2000000, 9), reps);
+
+    PrintHeader("Bipartite matching (Hopcroft-Karp against the general engines)");
+    ok &= RunMatching("bipartite 100x100 d=3", BipartiteNetwork(100, 100, 3, 14), reps, true);
+    ok &= RunMatching("bipartite 300x300 d=3", BipartiteNetwork(300, 300, 3, 15), reps, true);
+    ok &= RunMatching("bipartite 30000x30000 d=5", BipartiteNetwork(30000, 30000, 5, 16), reps, false);
+
+    PrintHeader("Minimum cost maximum flow (CostNetwork)");
+    ok &= RunMinCost("assignment n=200 d=10", AssignmentProblem(200, 10, 10), reps);
+    ok &= RunMinCost("assignment n=1000 d=10", AssignmentProblem(1000, 10, 11), reps);
+    ok &= RunMinCost("transport 20x50", TransportProblem(20, 50, 12), reps);
+    ok &= RunMinCost("transport 50x200", TransportProblem(50, 200, 13), reps);
+    ok &= RunMinCost("transport 100x1000", TransportProblem(100, 1000, 26), reps);
+
+    PrintHeader("All-pairs minimum cuts (Gomory-Hu trees)");
+    ok &= RunGomoryHu("random V=500 E=2500", RandomNetwork(500, 2500, 24), reps, 200);
+    ok &= RunGomoryHu("random V=2000 E=10000", RandomNetwork(2000, 10000, 25), reps, 200);
+
+    PrintHeader("Image segmentation (Boykov-Kolmogorov on implicit grids)");
+    ok &= RunGrid("grid 32x32 4-connected", SegmentationImage(32, 32, 17), false, reps, true, true);
+    ok &= RunGrid("grid 32x32 8-connected", SegmentationImage(32, 32, 18), true, reps, true, true);
+    ok &= RunGrid("grid 1MP 4-connected", SegmentationImage(1024, 1024, 19), false, reps, true, false);
+    ok &= RunGrid("grid 1MP 8-connected", SegmentationImage(1024, 1024, 20), true, reps, true, false);
+    ok &= RunGrid("grid 4MP 4-connected", SegmentationImage(2048, 2048, 21), false, reps, false, false);
+    ok &= RunGrid("grid 16MP 4-connected", SegmentationImage(4096, 4096, 22), false, reps, false, false);
+    ok &= RunGrid("grid 16MP 8-connected", SegmentationImage(4096, 4096, 23), true, reps, false, false);
+
+    return ok ? 0 : 1;
+}
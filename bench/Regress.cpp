@@ -0,0 +1,94 @@
+/**
+    Regression runner for the four programs. Runs each built a.out on every bundled
+    .in file, compares the output with the matching .out file and reports run times.
+    Replaces the per-project test.py scripts.
+
+    usage: regress [repetitions]
+**/
+
+#include <glob.h>
+#include <stdio.h>
+#include "Bench.h"
+
+typedef struct Suite {
+    std::string name, program, flags, pattern;
+} Suite;
+
+vector<std::string> Glob(const std::string &pattern) {
+    vector<std::string> paths;
+    glob_t g;
+    if (glob(pattern.c_str(), 0, NULL, &g) == 0) {
+        for (size_t i = 0; i < g.gl_pathc; i++) {
+            paths.push_back(g.gl_pathv[i]);
+        }
+    }
+    globfree(&g);
+    return paths;
+}
+
+// Run a shell command and return its standard output
+std::string Capture(const std::string &command) {
+    std::string out;
+    FILE *pipe = popen(command.c_str(), "r");
+    if (!pipe) {
+        return out;
+    }
+    char buffer[1 << 16];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+        out.append(buffer, read);
+    }
+    pclose(pipe);
+    return out;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t reps = Repetitions(argc, argv);
+    vector<Suite> suites = {
+        { "SegmentTree", "../SegmentTree/SegmentTree/a.out", "", "../SegmentTree/hw4/[0-9]*.in" },
+        { "DynamicSegmentTree", "../SegmentTree/SegmentTree/a.out", "-d", "../SegmentTree/hw4/[0-9]*.in" },
+        { "Simplex", "../Simplex/Simplex/Simplex/a.out", "", "../Simplex/csc284484homework2/test*.in" },
+        { "RevisedSimplex", "../Simplex/Simplex/Simplex/a.out", "-r", "../Simplex/csc284484homework2/test*.in" },
+        { "DenseSimplex", "../Simplex/Simplex/Simplex/a.out", "-d", "../Simplex/csc284484homework2/test*.in" },
+        { "SparseSimplex", "../Simplex/Simplex/Simplex/a.out", "-s", "../Simplex/sparse/test*.in" },
+        { "LPSolver", "../Simplex/Simplex/Simplex/a.out", "-l", "../Simplex/lp/test*.in" },
+        { "Crossover", "../Simplex/Simplex/Simplex/a.out", "-l -n -b", "../Simplex/lp/test4.in" },
+        { "SuffixArray", "../SuffixTrees/SuffixArrays/a.out", "", "../SuffixTrees/*.in" },
+        { "ParallelSuffixArray", "../SuffixTrees/SuffixArrays/a.out", "-t 4", "../SuffixTrees/*.in" },
+        { "MaxFlow", "../maxflow/a.out", "", "../Debug/[0-9]*.in" },
+        { "EdmondKarp", "../maxflow/a.out", "-e", "../Debug/[0-9]*.in" },
+        { "PushRelabel", "../maxflow/a.out", "-p -e", "../Debug/[0-9]*.in" },
+        { "BoykovKolmogorov", "../maxflow/a.out", "-b -e", "../Debug/[0-9]*.in" },
+        { "HopcroftKarp", "../maxflow/a.out", "-a", "../maxflow/matching/test*.in" },
+        { "MinCostFlow", "../maxflow/a.out", "-m ssp", "../maxflow/mincost/test*.in" },
+        { "CostScaling", "../maxflow/a.out", "-m scaling", "../maxflow/mincost/test*.in" },
+        { "NetworkSimplex", "../maxflow/a.out", "-m simplex", "../maxflow/mincost/test*.in" },
+        { "GomoryHu", "../maxflow/a.out", "-u", "../maxflow/gomoryhu/test*.in" },
+    };
+
+    uint32_t failures = 0;
+    for (vector<Suite>::iterator suite = suites.begin(); suite != suites.end(); suite++) {
+        PrintHeader(suite->name + " (" + suite->program + " " + suite->flags + ")");
+        vector<std::string> inputs = Glob(suite->pattern);
+        for (vector<std::string>::iterator in = inputs.begin(); in != inputs.end(); in++) {
+            std::string expectedPath = in->substr(0, in->size() - 3) + ".out";
+            std::string expected = Normalize(ReadFile(expectedPath));
+            std::string command = suite->program + " " + suite->flags + " < " + *in;
+            std::string output;
+
+            vector<Sample> samples = Measure(reps, [&]() { output = Capture(command); });
+
+            bool match = (Normalize(output) == expected);
+            std::string name = in->substr(in->find_last_of('/') + 1) + (match ? "  ok" : "  MISMATCH");
+            Report(name, samples, ReadFile(*in).size() / 1e6, "MB in");
+            failures += match ? 0 : 1;
+        }
+    }
+
+    if (failures) {
+        std::cout << std::endl << "FAILED: " << failures << " mismatched outputs" << std::endl;
+        return 1;
+    }
+    std::cout << std::endl << "all outputs match" << std::endl;
+    return 0;
+}
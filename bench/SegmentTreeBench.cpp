@@ -0,0 +1,160 @@
+/**
+    SegmentTree construction at 1M and 10M endpoints, a random interval workload on
+    SegmentTree and DynamicSegmentTree (whose answers must agree), and multi-threaded
+    Insert/Delete throughput of SegmentTree behind one global mutex versus
+    ConcurrentSegmentTree.
+
+    usage: segment_bench [repetitions] [max threads]
+**/
+
+#include <mutex>
+#include <thread>
+#include "Bench.h"
+#include "ConcurrentSegmentTree.h"
+#include "DynamicSegmentTree.h"
+#include "SegmentTree.h"
+
+using std::pair;
+
+typedef vector<pair<uint32_t, uint32_t>> Workload;
+
+vector<uint32_t> Endpoints(uint32_t n) {
+    vector<uint32_t> endpoints;
+    for (uint32_t i = 0; i < n; i++) {
+        endpoints.push_back(2 * i);
+    }
+    return endpoints;
+}
+
+// Short random intervals with endpoints drawn from the tree's endpoint set
+Workload MakeWorkload(const vector<uint32_t> &endpoints, uint32_t count, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<size_t> start(0, endpoints.size() - 2);
+    std::uniform_int_distribution<size_t> width(1, 64);
+    Workload w;
+    for (uint32_t i = 0; i < count; i++) {
+        size_t s = start(gen);
+        size_t e = std::min(s + width(gen), endpoints.size() - 1);
+        w.push_back(pair<uint32_t, uint32_t>(endpoints[s], endpoints[e]));
+    }
+    return w;
+}
+
+// Build a tree over n endpoints with 1, 2, 4, ... maxThreads threads
+void BenchConstruction(uint32_t n, uint32_t maxThreads, uint32_t reps) {
+    vector<uint32_t> endpoints = Endpoints(n);
+    for (uint32_t threads = 1; threads <= maxThreads; threads <<= 1) {
+        Report("build n=" + std::to_string(n) + " threads=" + std::to_string(threads),
+            Measure(reps, [&]() { SegmentTree tree(endpoints, threads); }), n, "endpoints");
+    }
+}
+
+/*
+    Inserts every interval of work, answers one covered length, max coverage and gap
+    query per interval, then deletes them all. Returns a checksum of the answers.
+*/
+template <typename Tree>
+uint64_t RunWorkload(Tree &T, const Workload &work) {
+    uint64_t sum = 0;
+    for (Workload::const_iterator it = work.begin(); it != work.end(); it++) {
+        sum += T.Insert(it->first, it->second);
+    }
+    for (Workload::const_iterator it = work.begin(); it != work.end(); it++) {
+        sum += T.CoveredLength(it->first, it->second + 1000);
+        sum += T.MaxCoverage(it->first, it->second + 1000);
+        sum += T.UncoveredGaps(it->first, it->second + 1000).size();
+    }
+    for (Workload::const_iterator it = work.begin(); it != work.end(); it++) {
+        sum += T.Delete(it->first, it->second);
+    }
+    return sum;
+}
+
+// Returns false if the two trees disagree
+bool BenchWorkload(uint32_t n, uint32_t ops, uint32_t reps) {
+    vector<uint32_t> endpoints = Endpoints(n);
+    Workload work = MakeWorkload(endpoints, ops, 7);
+    uint64_t fixed = 0, dynamic = 0;
+
+    SegmentTree tree(endpoints);
+    Report("SegmentTree n=" + std::to_string(n), Measure(reps, [&]() { fixed = RunWorkload(tree, work); }),
+        3. * ops, "ops");
+    Report("DynamicSegmentTree", Measure(reps, [&]() {
+        DynamicSegmentTree dynamicTree;
+        dynamic = RunWorkload(dynamicTree, work);
+    }), 3. * ops, "ops");
+
+    if (fixed != dynamic) {
+        std::cout << "ERROR: SegmentTree and DynamicSegmentTree answers differ" << std::endl;
+    }
+    return fixed == dynamic;
+}
+
+// Each thread inserts its own intervals then deletes them, so counts never go negative
+template <typename Insert, typename Delete>
+void RunThreads(uint32_t threads, const vector<Workload> &work, Insert insert, Delete remove) {
+    vector<std::thread> pool;
+    for (uint32_t t = 0; t < threads; t++) {
+        pool.push_back(std::thread([&work, t, &insert, &remove]() {
+            for (Workload::const_iterator it = work[t].begin(); it != work[t].end(); it++) {
+                insert(it->first, it->second);
+            }
+            for (Workload::const_iterator it = work[t].begin(); it != work[t].end(); it++) {
+                remove(it->first, it->second);
+            }
+        }));
+    }
+    for (vector<std::thread>::iterator it = pool.begin(); it != pool.end(); it++) {
+        it->join();
+    }
+}
+
+// Returns false if a tree is not empty after every interval is deleted
+bool BenchThreads(uint32_t n, uint32_t ops, uint32_t maxThreads, uint32_t reps) {
+    vector<uint32_t> endpoints = Endpoints(n);
+    vector<Workload> work;
+    for (uint32_t t = 0; t < maxThreads; t++) {
+        work.push_back(MakeWorkload(endpoints, ops, t + 1));
+    }
+
+    SegmentTree tree(endpoints);
+    ConcurrentSegmentTree concurrent(endpoints, 64 * maxThreads);
+    std::mutex lock;
+    for (uint32_t threads = 1; threads <= maxThreads; threads <<= 1) {
+        std::string suffix = " threads=" + std::to_string(threads);
+        Report("global mutex" + suffix, Measure(reps, [&]() {
+            RunThreads(threads, work,
+                [&](uint32_t x, uint32_t y) { std::lock_guard<std::mutex> g(lock); tree.Insert(x, y); },
+                [&](uint32_t x, uint32_t y) { std::lock_guard<std::mutex> g(lock); tree.Delete(x, y); });
+        }), 2. * ops * threads, "ops");
+        Report("ConcurrentSegmentTree" + suffix, Measure(reps, [&]() {
+            RunThreads(threads, work,
+                [&](uint32_t x, uint32_t y) { concurrent.Insert(x, y); },
+                [&](uint32_t x, uint32_t y) { concurrent.Delete(x, y); });
+        }), 2. * ops * threads, "ops");
+    }
+
+    if (tree.tree[0].measure != 0 || concurrent.Measure() != 0) {
+        std::cout << "ERROR: measure not zero after deleting every interval" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t reps = Repetitions(argc, argv);
+    uint32_t maxThreads = (argc > 2) ? std::stoul(argv[2]) : std::max(std::thread::hardware_concurrency(), 4u);
+    bool ok = true;
+
+    PrintHeader("SegmentTree construction");
+    BenchConstruction(1000000, maxThreads, reps);
+    BenchConstruction(10000000, maxThreads, reps);
+
+    PrintHeader("random interval workload (insert, query, delete)");
+    ok &= BenchWorkload(1 << 20, 1 << 16, reps);
+
+    PrintHeader("concurrent insert/delete, hardware threads: " + std::to_string(std::thread::hardware_concurrency()));
+    ok &= BenchThreads(1 << 20, 1 << 16, maxThreads, reps);
+
+    return ok ? 0 : 1;
+}
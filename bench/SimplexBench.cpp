@@ -0,0 +1,1132 @@
+/**
+    Phase one of the simplex solver, tableau and revised, on random feasible LPs of growing size.
+    Each returned basis is checked to be nonsingular and feasible.
+
+    Also compares the pricing rules of the revised method by pivot count and time, and runs the
+    full two-phase solver on bounded LPs, checking the optimality conditions of each answer, and
+    re-solves them after a change from the previous optimal basis against solving from scratch,
+    and solves them with and without presolve after padding them with redundant structure.
+    Degenerate LPs are solved with the barrier and crossover against the simplex method, badly
+    scaled LPs with and without ScaleLP and checked in exact arithmetic, and batches of small
+    independent LPs on a growing number of worker threads. Sparse bases of up to 100k rows
+    are factorised by LUFactor and checked by the residuals of FTRAN and BTRAN. Last,
+    transportation and circulation models are solved by Simplex on the dense tableau
+    against the network simplex of maxflow/NetworkSimplex.h.
+
+    usage: simplex_bench [repetitions] [max threads]
+**/
+
+#include <glob.h>
+#include <sstream>
+#include <thread>
+#include "Bench.h"
+#include "LPSolver.h"
+#include "NetworkSimplex.h"
+#include "Presolve.h"
+#include "Scaling.h"
+#include "Simplex.h"
+
+/*
+    Random m x n system with integer coefficients in [-10, 10] and b = Ax0 for a random
+    x0 >= 0 with about half its entries zero, written in the Simplex input format.
+    Rows are negated where needed so that b >= 0.
+*/
+std::string RandomLP(uint16_t rows, uint16_t cols, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> coef(-10, 10);
+    std::uniform_int_distribution<int> value(-5, 5);
+    vector<int> x0;
+    for (uint16_t j = 0; j < cols; j++) {
+        x0.push_back(std::max(value(gen), 0));
+    }
+
+    std::ostringstream out;
+    out << cols << " " << rows << "\n";
+    for (uint16_t i = 0; i < rows; i++) {
+        vector<int> row;
+        int b = 0;
+        for (uint16_t j = 0; j < cols; j++) {
+            row.push_back(coef(gen));
+            b += row.back() * x0[j];
+        }
+        int sign = (b < 0) ? -1 : 1;
+        for (uint16_t j = 0; j < cols; j++) {
+            out << sign * row[j] << " ";
+        }
+        out << sign * b << "\n";
+    }
+    return out.str();
+}
+
+/*
+    Random sparse m x n system in the sparse (-s) input format with perRow nonzeros per row,
+    integer coefficients in [-10, 10] and b = Ax0 for a random x0 >= 0 as in RandomLP.
+*/
+std::string RandomSparseLP(uint32_t rows, uint32_t cols, uint32_t perRow, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> coef(-10, 10);
+    std::uniform_int_distribution<int> value(-5, 5);
+    std::uniform_int_distribution<uint32_t> column(0, cols - 1);
+    vector<int> x0;
+    for (uint32_t j = 0; j < cols; j++) {
+        x0.push_back(std::max(value(gen), 0));
+    }
+
+    std::ostringstream out, rhs;
+    out << cols << " " << rows << " " << static_cast<uint64_t>(rows) * perRow << "\n";
+    for (uint32_t i = 0; i < rows; i++) {
+        int b = 0;
+        for (uint32_t k = 0; k < perRow; k++) {
+            uint32_t j = column(gen);
+            int a = coef(gen);
+            b += a * x0[j];
+            out << i + 1 << " " << j + 1 << " " << a << "\n";
+        }
+        rhs << b << " ";
+    }
+    out << rhs.str() << "\n";
+    return out.str();
+}
+
+/*
+    Returns true if B has one column per row, x_B = A_B^{-1}b is nonnegative and the
+    residual |A_B x_B - b| is small.
+*/
+bool CheckSparseBasis(const SparseMatrix &A, const vector<double> &b, const vector<uint32_t> &B) {
+    if (B.size() != A.rows) {
+        return false;
+    }
+    LUFactor lu;
+    if (!lu.Factor(A, B)) {
+        return false;
+    }
+    vector<double> x = b;
+    lu.FTRAN(x);
+
+    vector<double> residual = b;
+    for (uint32_t p = 0; p < A.rows; p++) {
+        if (x[p] < -1e-6) {
+            return false;
+        }
+        for (uint32_t k = A.start[B[p]]; k < A.start[B[p] + 1]; k++) {
+            residual[A.index[k]] -= A.value[k] * x[p];
+        }
+    }
+    for (uint32_t i = 0; i < A.rows; i++) {
+        if (std::fabs(residual[i]) > 1e-6 * (1. + std::fabs(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+    Solves A_B x_B = b by Gaussian elimination with partial pivoting on the original
+    columns and returns true if A_B is nonsingular and x_B >= 0.
+*/
+bool CheckBasis(DoubleMatrix A, vector<double> b, const Basis &B) {
+    size_t rows = A.size();
+    if (B.size() != rows) {
+        return false;
+    }
+    DoubleMatrix M(rows, vector<double>(rows + 1));
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < rows; j++) {
+            M[i][j] = A[i][B[j]];
+        }
+        M[i][rows] = b[i];
+    }
+    for (size_t k = 0; k < rows; k++) {
+        size_t p = k;
+        for (size_t i = k + 1; i < rows; i++) {
+            if (std::fabs(M[i][k]) > std::fabs(M[p][k])) {
+                p = i;
+            }
+        }
+        if (std::fabs(M[p][k]) < 1e-9) {
+            return false;
+        }
+        std::swap(M[p], M[k]);
+        for (size_t i = 0; i < rows; i++) {
+            if (i != k) {
+                double f = M[i][k] / M[k][k];
+                for (size_t j = k; j <= rows; j++) {
+                    M[i][j] -= f * M[k][j];
+                }
+            }
+        }
+    }
+    for (size_t k = 0; k < rows; k++) {
+        if (M[k][rows] / M[k][k] < -1e-6) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Pivots per timed repetition of the pivot kernel benchmarks
+#define KERNEL_PIVOTS 20
+
+// Random entries in [1, 2), so every pivot element is safely nonzero
+void FillTableau(DenseTableau &T) {
+    std::mt19937 gen(T.rows);
+    std::uniform_real_distribution<double> entry(1., 2.);
+    for (uint32_t i = 0; i <= T.rows; i++) {
+        for (uint32_t j = 0; j <= T.cols; j++) {
+            T.At(i, j) = entry(gen);
+        }
+    }
+}
+
+// Bytes read and written by KERNEL_PIVOTS pivots, in GB
+double PivotTraffic(uint32_t rows, size_t stride) {
+    return KERNEL_PIVOTS * 2. * (rows + 1) * stride * sizeof(double) / 1e9;
+}
+
+/*
+    KERNEL_PIVOTS pivots on a rows x cols DenseTableau. The tableau is refilled before each
+    repetition, untimed: the pivot columns are left zero but for the pivot, and pivoting on
+    them again would skip every row.
+*/
+void BenchPivots(uint32_t rows, uint32_t cols, PivotKernel kernel, uint32_t threads, uint32_t reps) {
+    const char *names[] = { "scalar", "avx2", "avx512" };
+    DenseTableau T(rows, cols);
+    T.kernel = kernel;
+    vector<Sample> samples;
+    for (uint32_t r = 0; r < reps; r++) {
+        FillTableau(T);
+        vector<Sample> one = Measure(1, [&]() {
+            for (uint32_t k = 0; k < KERNEL_PIVOTS; k++) {
+                T.Pivot(k * 37 % rows, k * 53 % cols, threads);
+            }
+        });
+        samples.push_back(one[0]);
+    }
+    std::string name = "pivot " + std::to_string(rows) + "x" + std::to_string(cols) + " " + names[kernel] +
+        " " + std::to_string(threads) + " threads";
+    Report(name, samples, PivotTraffic(rows, T.stride), "GB");
+}
+
+/*
+    The same pivots in the style of Simplex(): rows are separate vectors and every row is
+    updated through the vector of nonbasic column indices. Refilled before each repetition
+    like BenchPivots.
+*/
+void BenchNestedPivots(uint32_t rows, uint32_t cols, uint32_t reps) {
+    DenseTableau T(rows, cols);
+    FillTableau(T);
+    DoubleMatrix A(rows + 1, vector<double>(cols + 1));
+    vector<uint32_t> columns(cols + 1);
+    for (uint32_t j = 0; j <= cols; j++) {
+        columns[j] = j;
+    }
+
+    vector<Sample> samples;
+    for (uint32_t r = 0; r < reps; r++) {
+        for (uint32_t i = 0; i <= rows; i++) {
+            std::copy(T.Row(i), T.Row(i) + cols + 1, A[i].begin());
+        }
+        vector<Sample> one = Measure(1, [&]() {
+            for (uint32_t k = 0; k < KERNEL_PIVOTS; k++) {
+                uint32_t s = k * 37 % rows, t = k * 53 % cols;
+                double a_st = A[s][t];
+                for (vector<uint32_t>::iterator j = columns.begin(); j != columns.end(); j++) {
+                    A[s][*j] /= a_st;
+                }
+                for (uint32_t i = 0; i <= rows; i++) {
+                    if (i != s) {
+                        double a_it = A[i][t];
+                        for (vector<uint32_t>::iterator j = columns.begin(); j != columns.end(); j++) {
+                            A[i][*j] -= a_it * A[s][*j];
+                        }
+                    }
+                }
+            }
+        });
+        samples.push_back(one[0]);
+    }
+    Report("pivot " + std::to_string(rows) + "x" + std::to_string(cols) + " nested vectors", samples,
+        PivotTraffic(rows, T.stride), "GB");
+}
+
+// Case name with the pricing rule and pivot count of the revised method
+std::string CaseName(const std::string &name, bool revised, PricingRule rule, uint32_t pivots) {
+    if (!revised) {
+        return name;
+    }
+    return name + " " + pricingRuleNames[rule] + " (" + std::to_string(pivots) + " pivots)";
+}
+
+/*
+    Random sparse LP with perRow nonzeros per row and b = Ax0 for a random x0 within the bounds.
+    A quarter of the variables each are boxed in [-5, 5], nonnegative, bounded above only, or
+    free, with costs signed so that the LP stays bounded: a variable with no upper bound gets
+    c_j <= 0, one with no lower bound c_j >= 0, and a free one c_j = 0.
+*/
+LinearProgram RandomBoundedLP(uint32_t rows, uint32_t cols, uint32_t perRow, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> coef(-10, 10);
+    std::uniform_int_distribution<int> value(0, 5);
+    std::uniform_int_distribution<uint32_t> column(0, cols - 1);
+    LinearProgram lp;
+    vector<double> x0(cols);
+    lp.c.resize(cols);
+    lp.lower.assign(cols, -HUGE_VAL);
+    lp.upper.assign(cols, HUGE_VAL);
+    for (uint32_t j = 0; j < cols; j++) {
+        double cost = coef(gen);
+        switch (j % 4) {
+        case 0:
+            lp.lower[j] = -5.;
+            lp.upper[j] = 5.;
+            x0[j] = value(gen) - 2.;
+            break;
+        case 1:
+            lp.lower[j] = 0.;
+            x0[j] = value(gen);
+            cost = -std::fabs(cost);
+            break;
+        case 2:
+            lp.upper[j] = 0.;
+            x0[j] = -value(gen);
+            cost = std::fabs(cost);
+            break;
+        default:
+            x0[j] = value(gen) - 2.;
+            cost = 0.;
+        }
+        lp.c[j] = cost;
+    }
+
+    vector<Triple> entries;
+    lp.b.assign(rows, 0.);
+    for (uint32_t i = 0; i < rows; i++) {
+        for (uint32_t k = 0; k < perRow; k++) {
+            Triple t = { i, column(gen), static_cast<double>(coef(gen)) };
+            entries.push_back(t);
+            lp.b[i] += t.value * x0[t.col];
+        }
+    }
+    lp.A = CompressColumns(rows, cols, entries);
+    return lp;
+}
+
+/*
+    Checks the optimality conditions of an LPSolution: Ax = b and the bounds hold, each
+    reduced cost has the sign its active bound allows (0 if neither is active), and the
+    primal objective equals the dual objective b^Ty + sum of d_j times the active bound.
+*/
+bool CheckOptimal(const LinearProgram &lp, const LPSolution &solution) {
+    const double tol = 1e-6;
+    const SparseMatrix &A = lp.A;
+    vector<double> residual = lp.b;
+    double dual = 0.;
+    for (uint32_t j = 0; j < A.cols; j++) {
+        double x = solution.x[j], d = solution.reducedCosts[j];
+        if (x < lp.lower[j] - tol || x > lp.upper[j] + tol) {
+            return false;
+        }
+        bool atLower = x < lp.lower[j] + tol, atUpper = x > lp.upper[j] - tol;
+        if ((d > tol && !atUpper) || (d < -tol && !atLower)) {
+            return false;
+        }
+        // a reduced cost within tol of 0 may sit on an infinite bound; it contributes d_j x_j
+        dual += (d > tol) ? d * lp.upper[j] : ((d < -tol) ? d * lp.lower[j] : d * x);
+        for (uint32_t k = A.start[j]; k < A.start[j + 1]; k++) {
+            residual[A.index[k]] -= A.value[k] * x;
+        }
+    }
+    for (uint32_t i = 0; i < A.rows; i++) {
+        if (std::fabs(residual[i]) > tol * (1. + std::fabs(lp.b[i]))) {
+            return false;
+        }
+        dual += lp.b[i] * solution.y[i];
+    }
+    return std::fabs(dual - solution.objective) <= tol * (1. + std::fabs(solution.objective));
+}
+
+// Full solve of a random bounded LP; returns false unless it is solved to optimality
+bool RunSolve(uint32_t rows, uint32_t cols, uint32_t perRow, uint32_t reps, PricingRule rule) {
+    LinearProgram lp = RandomBoundedLP(rows, cols, perRow, rows * 7919 + cols);
+    LPSolution solution;
+    vector<Sample> samples = Measure(reps, [&]() {
+        solution = SolveLP(lp, rule);
+    });
+    std::string name = "bounded m=" + std::to_string(rows) + " n=" + std::to_string(cols);
+    Report(CaseName(name, true, rule, solution.pivots), samples, static_cast<double>(rows) * perRow, "nonzeros");
+
+    if (solution.status != LP_OPTIMAL || !CheckOptimal(lp, solution)) {
+        std::cout << "ERROR " << name << ": "
+            << ((solution.status == LP_OPTIMAL) ? "optimality conditions fail" : "not solved to optimality")
+            << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Re-solves lp warm from basis and cold, reports both and returns false unless they agree
+bool CompareWarm(const std::string &name, const LinearProgram &lp, const LPBasis &basis, uint32_t reps, PricingRule rule) {
+    LPSolution warm, cold;
+    vector<Sample> samples = Measure(reps, [&]() {
+        warm = SolveLP(lp, rule, &basis);
+    });
+    Report(name + " warm (" + std::to_string(warm.pivots) + " pivots)", samples, 1., "solves");
+    samples = Measure(reps, [&]() {
+        cold = SolveLP(lp, rule);
+    });
+    Report(name + " cold (" + std::to_string(cold.pivots) + " pivots)", samples, 1., "solves");
+
+    if (warm.status != cold.status || (warm.status == LP_OPTIMAL && (!CheckOptimal(lp, warm) ||
+        std::fabs(warm.objective - cold.objective) > 1e-6 * (1. + std::fabs(cold.objective))))) {
+        std::cout << "ERROR " << name << ": warm start disagrees with solving from scratch" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+    Solves a random bounded LP, then re-solves it from the optimal basis after each of: a
+    changed right hand side, a tightened bound on a basic variable, and an added cut on the
+    objective c^Tx <= optimum - 1.
+*/
+bool RunWarmStart(uint32_t rows, uint32_t cols, uint32_t perRow, uint32_t reps, PricingRule rule) {
+    LinearProgram lp = RandomBoundedLP(rows, cols, perRow, rows * 7919 + cols);
+    LPSolution solution = SolveLP(lp, rule);
+    std::string name = "bounded m=" + std::to_string(rows) + " n=" + std::to_string(cols);
+    if (solution.status != LP_OPTIMAL) {
+        std::cout << "ERROR " << name << ": not solved to optimality" << std::endl;
+        return false;
+    }
+    bool ok = true;
+
+    LinearProgram changed = lp;
+    changed.b[0] += 5.;
+    ok &= CompareWarm(name + " rhs", changed, solution.basis, reps, rule);
+
+    // halve the distance of the first boxed basic variable to its lower bound
+    changed = lp;
+    for (uint32_t j = 0; j < cols; j++) {
+        if (solution.basis.columns[j] == VAR_BASIC && changed.lower[j] > -HUGE_VAL && changed.upper[j] < HUGE_VAL) {
+            changed.upper[j] = (changed.lower[j] + solution.x[j]) / 2.;
+            break;
+        }
+    }
+    ok &= CompareWarm(name + " bound", changed, solution.basis, reps, rule);
+
+    changed = lp;
+    LPBasis basis = solution.basis;
+    SparseVector cut;
+    for (uint32_t j = 0; j < cols; j++) {
+        if (lp.c[j] != 0.) {
+            cut.push_back(std::make_pair(j, lp.c[j]));
+        }
+    }
+    AddRow(changed, cut, solution.objective - 1., basis);
+    ok &= CompareWarm(name + " cut", changed, basis, reps, rule);
+    return ok;
+}
+
+/*
+    RandomBoundedLP padded with what presolve removes: a scaled copy of every fourth row, a
+    singleton row for every eighth variable, fixing it at its value in x0, and every eighth
+    variable fixed by its bounds.
+*/
+LinearProgram RedundantLP(uint32_t rows, uint32_t cols, uint32_t perRow, uint32_t seed) {
+    LinearProgram lp = RandomBoundedLP(rows, cols, perRow, seed);
+    // x0 is not kept by RandomBoundedLP, so solve for a feasible point to fix variables at
+    LPSolution feasible = SolveLP(lp, PRICING_DANTZIG);
+
+    SparseMatrix rowwise = Transpose(lp.A);
+    vector<Triple> entries;
+    for (uint32_t j = 0; j < cols; j++) {
+        for (uint32_t k = lp.A.start[j]; k < lp.A.start[j + 1]; k++) {
+            Triple t = { lp.A.index[k], j, lp.A.value[k] };
+            entries.push_back(t);
+        }
+    }
+    uint32_t added = rows;
+    for (uint32_t i = 0; i < rows; i += 4, added++) {
+        for (uint32_t k = rowwise.start[i]; k < rowwise.start[i + 1]; k++) {
+            Triple t = { added, rowwise.index[k], 3. * rowwise.value[k] };
+            entries.push_back(t);
+        }
+        lp.b.push_back(3. * lp.b[i]);
+    }
+    for (uint32_t j = 0; j < cols; j += 8, added++) {
+        Triple t = { added, j, 2. };
+        entries.push_back(t);
+        lp.b.push_back(2. * feasible.x[j]);
+    }
+    for (uint32_t j = 4; j < cols; j += 8) {
+        lp.lower[j] = lp.upper[j] = feasible.x[j];
+    }
+    lp.A = CompressColumns(added, cols, entries);
+    return lp;
+}
+
+// Solves a RedundantLP with and without presolve; returns false unless both are optimal and agree
+bool RunPresolve(uint32_t rows, uint32_t cols, uint32_t perRow, uint32_t reps, PricingRule rule) {
+    LinearProgram lp = RedundantLP(rows, cols, perRow, rows * 7919 + cols);
+    std::string name = "redundant m=" + std::to_string(lp.A.rows) + " n=" + std::to_string(cols);
+
+    Presolved presolved;
+    LPSolution plain, presolvedSolution;
+    vector<Sample> samples = Measure(reps, [&]() {
+        Presolve(lp, presolved);
+    });
+    Report(name + " presolve to m=" + std::to_string(presolved.lp.A.rows) + " n=" +
+        std::to_string(presolved.lp.A.cols), samples, static_cast<double>(lp.A.index.size()), "nonzeros");
+    samples = Measure(reps, [&]() {
+        presolvedSolution = SolvePresolved(lp, rule);
+    });
+    Report(CaseName(name + " presolved", true, rule, presolvedSolution.pivots), samples, 1., "solves");
+    samples = Measure(reps, [&]() {
+        plain = SolveLP(lp, rule);
+    });
+    Report(CaseName(name, true, rule, plain.pivots), samples, 1., "solves");
+
+    if (plain.status != LP_OPTIMAL || presolvedSolution.status != LP_OPTIMAL || !CheckOptimal(lp, presolvedSolution) ||
+        std::fabs(plain.objective - presolvedSolution.objective) > 1e-6 * (1. + std::fabs(plain.objective))) {
+        std::cout << "ERROR " << name << ": presolved solution is wrong" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+    RandomBoundedLP with its rows and columns multiplied by random powers of 10 up to
+    10^spread either way, as models that mix units end up. The optimal objective is that of
+    the unscaled LP.
+*/
+LinearProgram BadlyScaledLP(uint32_t rows, uint32_t cols, uint32_t perRow, uint32_t seed, int spread) {
+    LinearProgram lp = RandomBoundedLP(rows, cols, perRow, seed);
+    std::mt19937 gen(seed + 1);
+    std::uniform_int_distribution<int> power(-spread, spread);
+    Scaling s;
+    for (uint32_t i = 0; i < rows; i++) {
+        s.row.push_back(pow(10., power(gen)));
+        lp.b[i] *= s.row[i];
+    }
+    for (uint32_t j = 0; j < cols; j++) {
+        s.col.push_back(pow(10., power(gen)));
+        lp.c[j] *= s.col[j];
+        lp.lower[j] /= s.col[j];
+        lp.upper[j] /= s.col[j];
+    }
+    ScaleMatrix(lp.A, s);
+    return lp;
+}
+
+/*
+    Solves a BadlyScaledLP as given and after ScaleLP, checking both answers exactly with
+    VerifyBasis. Returns false unless the scaled solve is verified optimal.
+*/
+bool RunScaling(uint32_t rows, uint32_t cols, uint32_t perRow, uint32_t reps, PricingRule rule, int spread) {
+    LinearProgram lp = BadlyScaledLP(rows, cols, perRow, rows * 7919 + cols, spread);
+    std::string name = "1e" + std::to_string(spread) + "-scaled m=" + std::to_string(rows) + " n=" + std::to_string(cols);
+    LPSettings plainSettings, scaledSettings;
+    plainSettings.verify = scaledSettings.verify = true;
+    scaledSettings.scale = true;
+
+    LPSolution plain, scaled;
+    vector<Sample> samples = Measure(reps, [&]() {
+        plain = SolveLP(lp, rule, NULL, plainSettings);
+    });
+    Report(CaseName(name, true, rule, plain.pivots) + (plain.verified ? " exact" : " inexact"), samples, 1., "solves");
+    samples = Measure(reps, [&]() {
+        scaled = SolveLP(lp, rule, NULL, scaledSettings);
+    });
+    Report(CaseName(name + " ScaleLP", true, rule, scaled.pivots) + (scaled.verified ? " exact" : " inexact"), samples,
+        1., "solves");
+
+    if (scaled.status != LP_OPTIMAL || !scaled.verified) {
+        std::cout << "ERROR " << name << ": scaled solve is not verified optimal" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+    Times VerifyBasis on the optimal basis of a random bounded LP, and checks that it accepts
+    that basis and rejects it once a nonbasic variable at a bound with a nonzero reduced cost
+    is moved to its other bound.
+*/
+bool RunVerify(uint32_t rows, uint32_t cols, uint32_t perRow, uint32_t reps) {
+    LinearProgram lp = RandomBoundedLP(rows, cols, perRow, rows * 7919 + cols);
+    LPSolution solution = SolveLP(lp);
+    std::string name = "bounded m=" + std::to_string(rows) + " n=" + std::to_string(cols);
+    if (solution.status != LP_OPTIMAL) {
+        std::cout << "ERROR " << name << ": not solved to optimality" << std::endl;
+        return false;
+    }
+
+    bool verified = false;
+    vector<Sample> samples = Measure(reps, [&]() {
+        verified = VerifyBasis(lp, solution.basis);
+    });
+    Report(name + " VerifyBasis", samples, static_cast<double>(rows), "rows");
+
+    LPBasis wrong = solution.basis;
+    for (uint32_t j = 0; j < cols; j++) {
+        if (wrong.columns[j] == VAR_AT_LOWER && lp.upper[j] < HUGE_VAL && std::fabs(solution.reducedCosts[j]) > 1e-6) {
+            wrong.columns[j] = VAR_AT_UPPER;
+            break;
+        }
+    }
+    if (!verified || VerifyBasis(lp, wrong)) {
+        std::cout << "ERROR " << name << ": " << (verified ? "accepts a wrong basis" : "rejects the optimal basis")
+            << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+    Solves count small bounded LPs, as a scenario analysis would, with RunBatch on 1, 2, 4, ...
+    workers; returns false unless every batch gives the objectives of the one-worker batch.
+*/
+bool RunBatchSolve(uint32_t count, uint32_t rows, uint32_t cols, uint32_t reps, uint32_t maxThreads) {
+    vector<LinearProgram> lps;
+    for (uint32_t i = 0; i < count; i++) {
+        lps.push_back(RandomBoundedLP(rows, cols, 4, i));
+    }
+    std::string name = std::to_string(count) + " LPs m=" + std::to_string(rows) + " n=" + std::to_string(cols);
+
+    vector<double> expected;
+    bool ok = true;
+    for (uint32_t workers = 1; workers <= maxThreads; workers <<= 1) {
+        vector<double> objectives(count);
+        vector<Sample> samples = Measure(reps, [&]() {
+            RunBatch(count, workers, [&lps, &objectives](uint32_t i) {
+                LPSolution solution = SolveLP(lps[i]);
+                objectives[i] = (solution.status == LP_OPTIMAL) ? solution.objective : HUGE_VAL;
+            });
+        });
+        Report(name + " workers=" + std::to_string(workers), samples, count, "solves");
+
+        if (expected.empty()) {
+            expected = objectives;
+        }
+        else if (objectives != expected) {
+            std::cout << "ERROR " << name << " workers=" << workers << ": answers differ from one worker" << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+/*
+    Random sparse LP over x >= 0 with perRow nonzeros per row, costs c_j <= 0, and b = Ax0
+    for an x0 with only one entry in ten nonzero, so that most vertices near the optimum are
+    degenerate.
+*/
+LinearProgram DegenerateLP(uint32_t rows, uint32_t cols, uint32_t perRow, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> coef(-10, 10);
+    std::uniform_int_distribution<int> value(0, 9);
+    std::uniform_int_distribution<uint32_t> column(0, cols - 1);
+    LinearProgram lp;
+    vector<double> x0(cols, 0.);
+    lp.c.resize(cols);
+    lp.lower.assign(cols, 0.);
+    lp.upper.assign(cols, HUGE_VAL);
+    for (uint32_t j = 0; j < cols; j++) {
+        lp.c[j] = -std::abs(coef(gen)) - 1.;
+        if (value(gen) == 0) {
+            x0[j] = 1. + value(gen);
+        }
+    }
+
+    vector<Triple> entries;
+    lp.b.assign(rows, 0.);
+    for (uint32_t i = 0; i < rows; i++) {
+        for (uint32_t k = 0; k < perRow; k++) {
+            Triple t = { i, column(gen), static_cast<double>(coef(gen)) };
+            entries.push_back(t);
+            lp.b[i] += t.value * x0[t.col];
+        }
+    }
+    lp.A = CompressColumns(rows, cols, entries);
+    return lp;
+}
+
+// Solves a degenerate LP with the two phases and with the barrier on 1..maxThreads threads
+bool RunBarrier(uint32_t rows, uint32_t cols, uint32_t perRow, uint32_t reps, uint32_t maxThreads) {
+    LinearProgram lp = DegenerateLP(rows, cols, perRow, rows * 7919 + cols);
+    std::string name = "degenerate m=" + std::to_string(rows) + " n=" + std::to_string(cols);
+    LPSolution simplex;
+    vector<Sample> samples = Measure(reps, [&]() {
+        simplex = SolveLP(lp, PRICING_STEEPEST_EDGE);
+    });
+    Report(CaseName(name, true, PRICING_STEEPEST_EDGE, simplex.pivots), samples, 1., "solves");
+    bool ok = simplex.status == LP_OPTIMAL && CheckOptimal(lp, simplex);
+
+    for (uint32_t threads = 1; threads <= maxThreads; threads <<= 1) {
+        LPSettings settings;
+        settings.barrier = true;
+        settings.threads = threads;
+        LPSolution barrier;
+        samples = Measure(reps, [&]() {
+            barrier = SolveLP(lp, PRICING_STEEPEST_EDGE, NULL, settings);
+        });
+        Report(name + " barrier threads=" + std::to_string(threads) + " (" + std::to_string(barrier.iterations) +
+            " iterations, " + std::to_string(barrier.pivots) + " pivots)", samples, 1., "solves");
+        ok &= barrier.status == LP_OPTIMAL && CheckOptimal(lp, barrier) &&
+            std::fabs(barrier.objective - simplex.objective) <= 1e-6 * (1. + std::fabs(simplex.objective));
+    }
+    if (!ok) {
+        std::cout << "ERROR " << name << ": the solves do not agree on an optimal solution" << std::endl;
+    }
+    return ok;
+}
+
+// Returns false if the solver reports infeasible or returns a bad basis
+bool Run(uint16_t rows, uint16_t cols, uint32_t reps, Engine engine, PricingRule rule) {
+    std::istringstream in(RandomLP(rows, cols, rows * 7919 + cols));
+    Problem P;
+    ReadProblem(in, P);
+
+    Basis B;
+    bool feasible = false;
+    uint32_t pivots = 0;
+    vector<Sample> samples = Measure(reps, [&]() {
+        // the solver works in place, so start from a fresh copy
+        Problem copy = P;
+        B.clear();
+        feasible = SolveFeasibility(copy, B, engine, rule, &pivots);
+    });
+    std::string name = "random m=" + std::to_string(rows) + " n=" + std::to_string(cols);
+    Report(CaseName(name, engine == ENGINE_REVISED, rule, pivots), samples, static_cast<double>(rows) * cols, "nonzeros");
+
+    if (!feasible || !CheckBasis(P.A, P.b, B)) {
+        std::cout << "ERROR " << name << ": " << (feasible ? "basis is not feasible" : "reported INFEASIBLE")
+            << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+    Solves every problem of a bundled input file with the revised method and checks that
+    the feasible ones get a feasible basis and the others are reported INFEASIBLE, as in the
+    expected output.
+*/
+bool RunBundled(const std::string &path, uint32_t reps, PricingRule rule) {
+    std::string input = ReadFile(path), expected = ReadFile(path.substr(0, path.size() - 3) + ".out");
+    std::istringstream expectedLines(expected);
+    vector<bool> expectFeasible;
+    std::string line;
+    while (std::getline(expectedLines, line)) {
+        if (line.find_first_not_of(" \r") != std::string::npos) {
+            expectFeasible.push_back(line.find("INFEASIBLE") == std::string::npos);
+        }
+    }
+
+    bool ok = true;
+    uint32_t pivots = 0;
+    vector<Sample> samples = Measure(reps, [&]() {
+        std::istringstream in(input);
+        int count;
+        in >> count;
+        pivots = 0;
+        for (int i = 0; i < count; i++) {
+            Problem P;
+            Basis B;
+            uint32_t p = 0;
+            ReadProblem(in, P);
+            bool feasible = SolveFeasibility(P, B, ENGINE_REVISED, rule, &p);
+            pivots += p;
+            // the revised method leaves A as it was after removing redundant rows
+            if (static_cast<size_t>(i) >= expectFeasible.size() || feasible != expectFeasible[i] ||
+                (feasible && !CheckBasis(P.A, P.b, B))) {
+                ok = false;
+            }
+        }
+    });
+    std::string name = path.substr(path.find_last_of('/') + 1);
+    Report(CaseName(name, true, rule, pivots), samples, static_cast<double>(pivots), "pivots");
+
+    if (!ok) {
+        std::cout << "ERROR " << name << " " << pricingRuleNames[rule] << ": wrong answer" << std::endl;
+    }
+    return ok;
+}
+
+/*
+    Random m x 2m matrix [S I] whose structural columns S have a diagonal entry in [20, 30]
+    and perColumn - 1 more in [-1, 1] in random rows, so that every basis of structural and
+    slack columns is nonsingular, and such a basis taking the structural column of each row
+    with probability share.
+*/
+void RandomBasis(uint32_t rows, uint32_t perColumn, double share, uint32_t seed, SparseMatrix &A, vector<uint32_t> &B) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> diagonal(20., 30.), entry(-1., 1.), unit(0., 1.);
+    std::uniform_int_distribution<uint32_t> row(0, rows - 1);
+    vector<Triple> triples;
+    for (uint32_t j = 0; j < rows; j++) {
+        triples.push_back({ j, j, diagonal(gen) });
+        for (uint32_t k = 1; k < perColumn; k++) {
+            uint32_t i = row(gen);
+            if (i != j) {
+                triples.push_back({ i, j, entry(gen) });
+            }
+        }
+        triples.push_back({ j, rows + j, 1. });
+    }
+    // CompressColumns adds up duplicate entries
+    A = CompressColumns(rows, 2 * rows, triples);
+    B.clear();
+    for (uint32_t i = 0; i < rows; i++) {
+        B.push_back(unit(gen) < share ? i : rows + i);
+    }
+}
+
+/*
+    Factorises a random basis of RandomBasis, reporting the size of its kernel and of the
+    part of it left to the dense LU, and returns false unless FTRAN and BTRAN of a random
+    right hand side solve to a small residual.
+*/
+bool RunFactor(uint32_t rows, uint32_t perColumn, double share, uint32_t reps) {
+    SparseMatrix A;
+    vector<uint32_t> B;
+    RandomBasis(rows, perColumn, share, rows * 7919 + perColumn, A, B);
+    LUFactor lu;
+    bool factored = false;
+    vector<Sample> samples = Measure(reps, [&]() {
+        factored = lu.Factor(A, B);
+    });
+    std::string name = "basis m=" + std::to_string(rows) + " " + std::to_string(perColumn) + "/column";
+    Report(name + " kernel " + std::to_string(lu.KernelSize()) + " dense " + std::to_string(lu.DenseSize()),
+        samples, static_cast<double>(rows), "rows");
+    if (!factored) {
+        std::cout << "ERROR " << name << ": reported singular" << std::endl;
+        return false;
+    }
+
+    std::mt19937 gen(rows);
+    std::uniform_real_distribution<double> value(-1., 1.);
+    vector<double> b(rows), x, w(rows), y;
+    for (uint32_t i = 0; i < rows; i++) {
+        b[i] = value(gen);
+        w[i] = value(gen);
+    }
+    x = b;
+    lu.FTRAN(x);
+    y = w;
+    lu.BTRAN(y);
+
+    // Bx - b by row, and y^T B - w^T by position
+    double worst = 0.;
+    vector<double> residual = b;
+    for (uint32_t p = 0; p < rows; p++) {
+        double dot = -w[p];
+        for (uint32_t k = A.start[B[p]]; k < A.start[B[p] + 1]; k++) {
+            residual[A.index[k]] -= A.value[k] * x[p];
+            dot += A.value[k] * y[A.index[k]];
+        }
+        worst = std::max(worst, std::fabs(dot));
+    }
+    for (uint32_t i = 0; i < rows; i++) {
+        worst = std::max(worst, std::fabs(residual[i]));
+    }
+    if (worst > 1e-9) {
+        std::cout << "ERROR " << name << ": residual " << worst << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Sparse input: time reading it, phase one with SparseFeasibleBasis, or both
+bool RunSparse(uint32_t rows, uint32_t cols, uint32_t perRow, uint32_t reps, PricingRule rule, bool read, bool solve) {
+    std::string text = RandomSparseLP(rows, cols, perRow, rows * 7919 + cols);
+    SparseMatrix A;
+    vector<double> b;
+    vector<uint32_t> B;
+    bool feasible = false;
+    uint32_t pivots = 0;
+    double nonzeros = static_cast<double>(rows) * perRow;
+    std::string name = "sparse m=" + std::to_string(rows) + " n=" + std::to_string(cols);
+
+    vector<Sample> samples = Measure(read ? reps : 1, [&]() {
+        std::istringstream in(text);
+        ReadSparseProblem(in, A, b);
+    });
+    if (read) {
+        Report(name + " read", samples, nonzeros, "nonzeros");
+    }
+    if (!solve) {
+        return true;
+    }
+
+    samples = Measure(reps, [&]() {
+        feasible = SparseFeasibleBasis(A, b, cols, B, rule, &pivots);
+    });
+    Report(CaseName(name, true, rule, pivots), samples, nonzeros, "nonzeros");
+
+    if (!feasible || !CheckSparseBasis(A, b, B)) {
+        std::cout << "ERROR " << name << ": " << (feasible ? "basis is not feasible" : "reported INFEASIBLE")
+            << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+    A minimum cost flow model: every vertex v of 1..order sends supply[v] more units than
+    it receives over the edges.
+*/
+typedef struct FlowModel {
+    uint32_t order;
+    vector<int64_t> supply;
+    vector<CostEdge> edges;
+} FlowModel;
+
+// Suppliers ship to every consumer at a random unit cost; the edges are uncapacitated
+FlowModel TransportationModel(uint32_t suppliers, uint32_t consumers, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int64_t> amount(10, 100);
+    std::uniform_int_distribution<int32_t> cost(1, 100);
+    FlowModel model = { suppliers + consumers, vector<int64_t>(suppliers + consumers + 1, 0), vector<CostEdge>() };
+    int64_t total = 0;
+    for (uint32_t s = 1; s <= suppliers; s++) {
+        model.supply[s] = amount(gen);
+        total += model.supply[s];
+        for (uint32_t c = 1; c <= consumers; c++) {
+            CostEdge e = { s, suppliers + c, UINT32_MAX / 2, cost(gen) };
+            model.edges.push_back(e);
+        }
+    }
+    // the demands share the total supply as evenly as it divides
+    for (uint32_t c = 1; c <= consumers; c++) {
+        model.supply[suppliers + c] = -(total / consumers + (c <= total % consumers ? 1 : 0));
+    }
+    return model;
+}
+
+// Random capacitated edges, some of negative cost, and no supplies: the cheapest circulation
+FlowModel CirculationModel(uint32_t order, uint32_t size, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint32_t> vertex(1, order), capacity(1, 20);
+    std::uniform_int_distribution<int32_t> cost(-50, 50);
+    FlowModel model = { order, vector<int64_t>(order + 1, 0), vector<CostEdge>() };
+    while (model.edges.size() < size) {
+        CostEdge e = { vertex(gen), vertex(gen), capacity(gen), cost(gen) };
+        if (e.tail != e.head) {
+            model.edges.push_back(e);
+        }
+    }
+    return model;
+}
+
+/*
+    The model as an LP for Simplex, max -cost^Tx subject to flow conservation and
+    x <= capacity. The balance row of the last vertex is left out, as the others imply it,
+    and edges of capacity UINT32_MAX / 2 or more are uncapacitated. Rows are negated where the
+    right hand side is negative, and the adjoined identity is the starting basis: the
+    slacks of the capacity rows and artificials of the balance rows, which cost more than
+    any path of edges so that they leave the basis (big M).
+
+    param[out]: c, V, x, B, B_comp - the starting reduced costs, objective value, assignment
+    and basis for Simplex
+*/
+void FlowLP(const FlowModel &model, Problem &P, vector<double> &c, double &V, vector<double> &x, Basis &B,
+    Basis &B_comp) {
+    int64_t highest = 0;
+    for (vector<CostEdge>::const_iterator e = model.edges.begin(); e != model.edges.end(); e++) {
+        highest = std::max(highest, static_cast<int64_t>(std::abs(e->cost)));
+    }
+    double bigM = static_cast<double>((highest + 1) * (model.order + 1));
+
+    uint16_t n = static_cast<uint16_t>(model.edges.size()), balances = static_cast<uint16_t>(model.order - 1);
+    vector<vector<double>> rows(balances, vector<double>(n, 0.));
+    vector<double> b;
+    for (uint32_t v = 1; v < model.order; v++) {
+        b.push_back(static_cast<double>(model.supply[v]));
+    }
+    for (uint16_t j = 0; j < n; j++) {
+        const CostEdge &e = model.edges[j];
+        if (e.tail < model.order) {
+            rows[e.tail - 1][j] += 1.;
+        }
+        if (e.head < model.order) {
+            rows[e.head - 1][j] -= 1.;
+        }
+        if (e.capacity < UINT32_MAX / 2) {
+            rows.push_back(vector<double>(n, 0.));
+            rows.back()[j] = 1.;
+            b.push_back(e.capacity);
+        }
+    }
+
+    uint16_t m = static_cast<uint16_t>(rows.size());
+    P.n = n;
+    P.m = m;
+    P.A.clear();
+    P.b = b;
+    c.assign(n + m, 0.);
+    x.assign(n + m, 0.);
+    V = 0.;
+    for (uint16_t j = 0; j < n; j++) {
+        c[j] = -model.edges[j].cost;
+    }
+    for (uint16_t i = 0; i < m; i++) {
+        double sign = b[i] < 0 ? -1. : 1.;
+        vector<double> row(n + m, 0.);
+        for (uint16_t j = 0; j < n; j++) {
+            row[j] = sign * rows[i][j];
+            // reduced costs at the starting basis: c_j - c_B^T A_j with c_B = -M on the artificials
+            if (i < balances) {
+                c[j] += bigM * row[j];
+            }
+        }
+        row[n + i] = 1.;
+        P.A.push_back(row);
+        P.b[i] = sign * b[i];
+        x[n + i] = P.b[i];
+        if (i < balances) {
+            V -= bigM * P.b[i];
+        }
+    }
+    B.clear();
+    B_comp.clear();
+    for (uint16_t j = 0; j < n + m; j++) {
+        (j < n ? B_comp : B).push_back(j);
+    }
+}
+
+// Returns false if the tableau and the network simplex disagree on the least cost
+bool RunFlowModel(const std::string &name, const FlowModel &model, uint32_t reps) {
+    Problem P;
+    vector<double> c, x;
+    double V;
+    Basis B, B_comp;
+    FlowLP(model, P, c, V, x, B, B_comp);
+    double tableauCost = 0.;
+    Report(name + " tableau m=" + std::to_string(P.m), Measure(reps, [&]() {
+        // Simplex pivots in place, so start from a fresh copy
+        Problem copy = P;
+        vector<double> cCopy = c, xCopy = x;
+        Basis BCopy = B, BCompCopy = B_comp;
+        double value = V;
+        Simplex(copy, value, cCopy, xCopy, BCopy, BCompCopy);
+        tableauCost = -value;
+    }), model.edges.size(), "arcs");
+
+    NetworkSimplex simplex(model.order, model.edges);
+    bool feasible = false;
+    Report(name + " NetworkSimplex", Measure(reps, [&]() { feasible = simplex.Solve(model.supply); }),
+        model.edges.size(), "arcs");
+
+    if (!feasible || std::llround(tableauCost) != simplex.Cost()) {
+        std::cout << "ERROR " << name << ": tableau cost " << tableauCost << ", network simplex "
+            << (feasible ? std::to_string(simplex.Cost()) : "INFEASIBLE") << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t reps = Repetitions(argc, argv);
+    uint32_t maxThreads = (argc > 2) ? std::stoul(argv[2]) : std::max(std::thread::hardware_concurrency(), 4u);
+    bool ok = true;
+
+    PrintHeader("Simplex phase one (FeasibleBasis)");
+    for (uint16_t rows = 10; rows <= 160; rows *= 2) {
+        ok &= Run(rows, 2 * rows, reps, ENGINE_TABLEAU, PRICING_BLAND);
+    }
+
+    PrintHeader("Simplex phase one (RevisedFeasibleBasis)");
+    for (uint16_t rows = 10; rows <= 160; rows *= 2) {
+        ok &= Run(rows, 2 * rows, reps, ENGINE_REVISED, PRICING_BLAND);
+    }
+
+    PrintHeader("Simplex phase one (DenseFeasibleBasis)");
+    for (uint16_t rows = 10; rows <= 160; rows *= 2) {
+        ok &= Run(rows, 2 * rows, reps, ENGINE_DENSE, PRICING_BLAND);
+    }
+
+    // a rank-1 update streams the tableau through memory twice (read and write)
+    PrintHeader("Dense pivot kernel");
+    for (uint32_t rows = 1000; rows <= 2000; rows *= 2) {
+        BenchNestedPivots(rows, 2 * rows, reps);
+        for (int kernel = KERNEL_SCALAR; kernel <= KERNEL_AVX512; kernel++) {
+            if (KernelSupported(static_cast<PivotKernel>(kernel))) {
+                for (uint32_t threads = 1; threads <= maxThreads; threads <<= 1) {
+                    BenchPivots(rows, 2 * rows, static_cast<PivotKernel>(kernel), threads, reps);
+                }
+            }
+        }
+    }
+
+    PrintHeader("Pricing rules, bundled problems");
+    glob_t g;
+    if (glob("../Simplex/csc284484homework2/test*.in", 0, NULL, &g) == 0) {
+        for (size_t i = 0; i < g.gl_pathc; i++) {
+            for (int rule = 0; rule < PRICING_RULE_COUNT; rule++) {
+                ok &= RunBundled(g.gl_pathv[i], reps, static_cast<PricingRule>(rule));
+            }
+        }
+    }
+    globfree(&g);
+
+    PrintHeader("Pricing rules, generated problems");
+    for (int rule = 0; rule < PRICING_RULE_COUNT; rule++) {
+        ok &= Run(160, 320, reps, ENGINE_REVISED, static_cast<PricingRule>(rule));
+    }
+    for (int rule = 0; rule < PRICING_RULE_COUNT; rule++) {
+        ok &= RunSparse(500, 500, 10, reps, static_cast<PricingRule>(rule), false, true);
+    }
+
+    PrintHeader("Two-phase solve with bounds (SolveLP)");
+    for (uint32_t rows = 50; rows <= 200; rows *= 2) {
+        ok &= RunSolve(rows, 2 * rows, 8, reps, PRICING_STEEPEST_EDGE);
+    }
+    ok &= RunSolve(200, 400, 8, reps, PRICING_DANTZIG);
+
+    PrintHeader("Re-solving after a change (SolveLP warm from the last basis)");
+    ok &= RunWarmStart(200, 400, 8, reps, PRICING_STEEPEST_EDGE);
+
+    PrintHeader("Presolve (SolvePresolved against SolveLP)");
+    for (uint32_t rows = 50; rows <= 200; rows *= 2) {
+        ok &= RunPresolve(rows, 2 * rows, 8, reps, PRICING_STEEPEST_EDGE);
+    }
+
+    PrintHeader("Interior point method with crossover (SolveLP with settings.barrier)");
+    for (uint32_t rows = 100; rows <= 400; rows *= 2) {
+        ok &= RunBarrier(rows, 2 * rows, 8, reps, maxThreads);
+    }
+
+    PrintHeader("Badly scaled LPs (ScaleLP, checked by VerifyBasis)");
+    for (int spread = 2; spread <= 6; spread += 2) {
+        ok &= RunScaling(50, 100, 8, reps, PRICING_STEEPEST_EDGE, spread);
+    }
+
+    PrintHeader("Exact rational recheck of the optimal basis (VerifyBasis)");
+    for (uint32_t rows = 25; rows <= 100; rows *= 2) {
+        ok &= RunVerify(rows, 2 * rows, 8, reps);
+    }
+
+    PrintHeader("Batch of small LPs (RunBatch)");
+    ok &= RunBatchSolve(2000, 10, 20, reps, maxThreads);
+
+    // the last case is 0.01% dense at 100k x 100k
+    PrintHeader("Simplex phase one, sparse input (SparseFeasibleBasis)");
+    ok &= RunSparse(250, 250, 10, reps, PRICING_BLAND, true, true);
+    ok &= RunSparse(500, 500, 10, reps, PRICING_BLAND, true, false);
+    ok &= RunSparse(100000, 100000, 10, reps, PRICING_BLAND, true, false);
+
+    PrintHeader("Basis factorisation (LUFactor), sparse LP bases up to 100k rows");
+    for (uint32_t rows = 10000; rows <= 100000; rows *= 10) {
+        ok &= RunFactor(rows, 3, 0.5, reps);
+        ok &= RunFactor(rows, 4, 0.5, reps);
+    }
+    ok &= RunFactor(30000, 5, 0.5, reps);
+
+    PrintHeader("Flow models, dense tableau (Simplex) against NetworkSimplex");
+    ok &= RunFlowModel("transportation 10x20", TransportationModel(10, 20, 27), reps);
+    ok &= RunFlowModel("transportation 20x50", TransportationModel(20, 50, 28), reps);
+    ok &= RunFlowModel("circulation V=30 E=150", CirculationModel(30, 150, 29), reps);
+    ok &= RunFlowModel("circulation V=60 E=400", CirculationModel(60, 400, 30), reps);
+
+    return ok ? 0 : 1;
+}
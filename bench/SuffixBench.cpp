@@ -0,0 +1,111 @@
+/**
+    Prefix-doubling suffix array construction on random strings over a small (2 letter)
+    and a large (26 letter) alphabet. Every result is checked against a comparison sort
+    of the suffixes. The parallel builder is checked against it, and then timed on 1 to
+    max threads on one large generated text (16 MB by default).
+
+    usage: suffix_bench [repetitions] [max threads] [megabytes]
+**/
+
+#include <cstring>
+#include <numeric>
+#include <thread>
+#include "Bench.h"
+#include "ParallelSuffixArray.h"
+#include "SuffixArray.h"
+
+std::string RandomText(uint32_t length, uint32_t alphabet, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint32_t> letter(0, alphabet - 1);
+    std::string t;
+    for (uint32_t i = 0; i < length; i++) {
+        t += static_cast<char>('a' + letter(gen));
+    }
+    return t + "$";
+}
+
+// '$' sorts before every letter in ASCII, so plain strcmp order is suffix order
+bool Check(const std::string &t) {
+    vector<uint32_t> expected(t.size());
+    std::iota(expected.begin(), expected.end(), 0);
+    const char *s = t.c_str();
+    std::sort(expected.begin(), expected.end(),
+        [s](uint32_t a, uint32_t b) { return strcmp(s + a, s + b) < 0; });
+    return std::equal(expected.begin(), expected.end(), SuffixArray);
+}
+
+// Returns false if the suffix array is wrong
+bool Run(uint32_t length, uint32_t alphabet, uint32_t reps) {
+    std::string t = RandomText(length, alphabet, length + alphabet);
+    std::string name = "n=" + std::to_string(length) + " sigma=" + std::to_string(alphabet);
+    Report(name, Measure(reps, [&]() { BuildSuffixArray(t); }), t.size(), "chars");
+    if (!Check(t)) {
+        std::cout << "ERROR " << name << ": suffix array differs from comparison sort" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Returns false if the parallel builder differs from BuildSuffixArray
+bool RunParallel(uint32_t length, uint32_t alphabet, uint32_t threads, uint32_t reps) {
+    std::string t = RandomText(length, alphabet, length + alphabet);
+    std::string name = "n=" + std::to_string(length) + " sigma=" + std::to_string(alphabet) +
+        " threads=" + std::to_string(threads);
+    vector<uint32_t> sa;
+    Report(name, Measure(reps, [&]() { BuildSuffixArrayParallel(t, sa, threads); }), t.size(), "chars");
+    BuildSuffixArray(t);
+    if (sa.size() != t.size() || !std::equal(sa.begin(), sa.end(), SuffixArray)) {
+        std::cout << "ERROR " << name << ": suffix array differs from BuildSuffixArray" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Scaling on one large text; every thread count must give the suffix array of one thread
+bool RunScaling(uint32_t length, uint32_t maxThreads, uint32_t reps) {
+    std::string t = RandomText(length, 26, length);
+    vector<uint32_t> expected, sa;
+    bool ok = true;
+    for (uint32_t threads = 1; threads <= maxThreads; threads <<= 1) {
+        std::string name = "n=" + std::to_string(length) + " threads=" + std::to_string(threads);
+        Report(name, Measure(reps, [&]() { BuildSuffixArrayParallel(t, sa, threads); }), t.size(), "chars");
+        if (threads == 1) {
+            expected.swap(sa);
+        }
+        else if (sa != expected) {
+            std::cout << "ERROR " << name << ": suffix array differs from one thread" << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t reps = Repetitions(argc, argv);
+    uint32_t maxThreads = (argc > 2) ? std::stoul(argv[2]) : std::max(std::thread::hardware_concurrency(), 4u);
+    uint32_t megabytes = (argc > 3) ? std::stoul(argv[3]) : 16;
+    bool ok = true;
+    AllocateTuples();
+
+    PrintHeader("BuildSuffixArray");
+    uint32_t lengths[] = { 1000, 10000, MAX_LEN - 1 };
+    for (uint32_t alphabet : { 2, 26 }) {
+        for (uint32_t length : lengths) {
+            ok &= Run(length, alphabet, reps);
+        }
+    }
+
+    PrintHeader("BuildSuffixArrayParallel");
+    for (uint32_t alphabet : { 2, 26 }) {
+        for (uint32_t threads = 1; threads <= maxThreads; threads <<= 1) {
+            ok &= RunParallel(MAX_LEN - 1, alphabet, threads, reps);
+        }
+    }
+
+    // the working set is about 28 bytes per character
+    PrintHeader("BuildSuffixArrayParallel scaling, hardware threads: " +
+        std::to_string(std::thread::hardware_concurrency()));
+    ok &= RunScaling(megabytes << 20, maxThreads, reps);
+
+    return ok ? 0 : 1;
+}
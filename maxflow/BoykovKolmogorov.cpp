@@ -0,0 +1,330 @@
+/**
+    Boykov-Kolmogorov max flow on image grids and general networks
+**/
+
+#include <algorithm>
+#include "BoykovKolmogorov.h"
+#include "GridGraph.h"
+#include "Stats.h"
+
+// Parent marks: not in a tree, child of a terminal, cut off from its tree
+#define NO_PARENT UINT32_MAX
+#define PARENT_TERMINAL (UINT32_MAX - 1)
+#define PARENT_ORPHAN (UINT32_MAX - 2)
+// No vertex or no arc; also marks a vertex that is not in the active queue
+#define NONE UINT32_MAX
+
+/*
+    Pairs up the residual arcs of network: arc v -> w of capacity c becomes a forward arc
+    of capacity c leaving v and a reverse arc leaving w, of capacity c if undirected, else 0.
+*/
+TerminalNetwork::TerminalNetwork(const FlowNetworkView &network, bool undirected) : direct(0) {
+    uint32_t arcs = network.first[network.order + 1];
+    first.assign(network.order + 2, 0);
+    for (uint32_t v = 1; v <= network.order; v++) {
+        for (uint32_t k = network.first[v]; k < network.first[v + 1]; k++) {
+            first[v + 1]++;
+            first[network.head[k] + 1]++;
+        }
+    }
+    for (uint32_t v = 1; v <= network.order + 1; v++) {
+        first[v] += first[v - 1];
+    }
+    vector<uint32_t> position(first.begin(), first.end() - 1);
+    head.resize(2 * static_cast<size_t>(arcs));
+    sister.resize(head.size());
+    capacity.resize(head.size());
+    for (uint32_t v = 1; v <= network.order; v++) {
+        for (uint32_t k = network.first[v]; k < network.first[v + 1]; k++) {
+            uint32_t w = network.head[k], a = position[v]++, b = position[w]++;
+            head[a] = w;
+            head[b] = v;
+            sister[a] = b;
+            sister[b] = a;
+            capacity[a] = network.capacity[k];
+            capacity[b] = undirected ? network.capacity[k] : 0;
+        }
+    }
+    residual = capacity;
+    sourceCapacity.assign(network.order + 1, 0);
+    sinkCapacity.assign(network.order + 1, 0);
+}
+
+/*
+    Resets the residual capacities and folds the arcs of source and sink into the
+    terminal capacities of their neighbours. Arcs into the source or out of the sink
+    can carry no flow and are dropped.
+*/
+void TerminalNetwork::SetTerminals(uint32_t source, uint32_t sink) {
+    residual = capacity;
+    std::fill(sourceCapacity.begin(), sourceCapacity.end(), 0);
+    std::fill(sinkCapacity.begin(), sinkCapacity.end(), 0);
+    direct = 0;
+    for (uint32_t a = first[source]; a < first[source + 1]; a++) {
+        if (head[a] == sink) {
+            direct += residual[a];
+        }
+        else {
+            sourceCapacity[head[a]] += residual[a];
+        }
+        residual[a] = residual[sister[a]] = 0;
+    }
+    for (uint32_t a = first[sink]; a < first[sink + 1]; a++) {
+        sinkCapacity[head[a]] += residual[sister[a]];
+        residual[a] = residual[sister[a]] = 0;
+    }
+}
+
+template <class G>
+void BoykovKolmogorov<G>::Activate(uint32_t v) {
+    if (next[v] != NONE) {
+        return;
+    }
+    // the last active vertex links to itself
+    next[v] = v;
+    if (lastActive != NONE) {
+        next[lastActive] = v;
+    }
+    else {
+        firstActive = v;
+    }
+    lastActive = v;
+}
+
+/*
+    Grows the tree of v over the residual arcs of v, taking in free neighbours.
+
+    Returns an arc from the source tree to the sink tree, or NONE if the trees do not
+    meet at v.
+*/
+template <class G>
+uint32_t BoykovKolmogorov<G>::Grow(uint32_t v) {
+    bool source = tree[v] == TREE_SOURCE;
+    for (uint32_t a = graph.FirstArc(v); a < graph.LastArc(v); a++) {
+        // the source tree grows along arcs, the sink tree against them
+        if ((source ? graph.residual[a] : graph.residual[graph.Sister(a)]) == 0) {
+            continue;
+        }
+        uint32_t w = graph.Head(a);
+        if (tree[w] == TREE_FREE) {
+            tree[w] = tree[v];
+            parent[w] = graph.Sister(a);
+            stamp[w] = stamp[v];
+            distance[w] = distance[v] + 1;
+            Activate(w);
+        }
+        else if (tree[w] != tree[v]) {
+            return source ? a : graph.Sister(a);
+        }
+        else if (stamp[w] <= stamp[v] && distance[w] > distance[v]) {
+            // w is nearer its terminal through v
+            parent[w] = graph.Sister(a);
+            stamp[w] = stamp[v];
+            distance[w] = distance[v] + 1;
+        }
+    }
+    return NONE;
+}
+
+template <class G>
+void BoykovKolmogorov<G>::Orphan(uint32_t v) {
+    STATS_COUNT("orphans", 1);
+    parent[v] = PARENT_ORPHAN;
+    orphans.push_back(v);
+}
+
+/*
+    Pushes the bottleneck along the path through arc meet, from the source tree to the
+    sink tree, and orphans the vertices below each saturated arc.
+
+    Returns the flow pushed.
+*/
+template <class G>
+uint64_t BoykovKolmogorov<G>::Augment(uint32_t meet) {
+    vector<uint32_t> &residual = graph.residual;
+    uint64_t bottleneck = residual[meet];
+    uint32_t v;
+    for (v = graph.Head(graph.Sister(meet)); parent[v] != PARENT_TERMINAL; v = graph.Head(parent[v])) {
+        bottleneck = std::min<uint64_t>(bottleneck, residual[graph.Sister(parent[v])]);
+    }
+    bottleneck = std::min<uint64_t>(bottleneck, terminal[v]);
+    for (v = graph.Head(meet); parent[v] != PARENT_TERMINAL; v = graph.Head(parent[v])) {
+        bottleneck = std::min<uint64_t>(bottleneck, residual[parent[v]]);
+    }
+    bottleneck = std::min<uint64_t>(bottleneck, -terminal[v]);
+
+    uint32_t amount = static_cast<uint32_t>(bottleneck);
+    residual[meet] -= amount;
+    residual[graph.Sister(meet)] += amount;
+    for (v = graph.Head(graph.Sister(meet)); parent[v] != PARENT_TERMINAL;) {
+        uint32_t up = parent[v], down = graph.Sister(up);
+        residual[down] -= amount;
+        residual[up] += amount;
+        if (residual[down] == 0) {
+            Orphan(v);
+        }
+        v = graph.Head(up);
+    }
+    terminal[v] -= amount;
+    if (terminal[v] == 0) {
+        Orphan(v);
+    }
+    for (v = graph.Head(meet); parent[v] != PARENT_TERMINAL;) {
+        uint32_t down = parent[v];
+        residual[down] -= amount;
+        residual[graph.Sister(down)] += amount;
+        if (residual[down] == 0) {
+            Orphan(v);
+        }
+        v = graph.Head(down);
+    }
+    terminal[v] += amount;
+    if (terminal[v] == 0) {
+        Orphan(v);
+    }
+    return bottleneck;
+}
+
+/*
+    Finds orphan v a new parent in its tree: the neighbour with a residual arc toward v
+    whose own path reaches the terminal and is shortest. Paths found are stamped with the
+    current time, so later searches stop early. Without such a neighbour v is freed, its
+    children become orphans, and its neighbours in the tree become active so that they can
+    grow back into v.
+*/
+template <class G>
+void BoykovKolmogorov<G>::Adopt(uint32_t v) {
+    bool source = tree[v] == TREE_SOURCE;
+    uint32_t best = NONE, shortest = UINT32_MAX;
+    for (uint32_t a = graph.FirstArc(v); a < graph.LastArc(v); a++) {
+        if ((source ? graph.residual[graph.Sister(a)] : graph.residual[a]) == 0) {
+            continue;
+        }
+        uint32_t w = graph.Head(a);
+        if (tree[w] != tree[v]) {
+            continue;
+        }
+        // follow w to its terminal, or to a vertex whose distance is already known
+        uint32_t d = 0, x = w;
+        while (true) {
+            if (stamp[x] == time) {
+                d += distance[x];
+                break;
+            }
+            d++;
+            if (parent[x] == PARENT_TERMINAL) {
+                stamp[x] = time;
+                distance[x] = 1;
+                break;
+            }
+            if (parent[x] == PARENT_ORPHAN) {
+                d = UINT32_MAX;
+                break;
+            }
+            x = graph.Head(parent[x]);
+        }
+        if (d == UINT32_MAX) {
+            continue;
+        }
+        if (d < shortest) {
+            best = a;
+            shortest = d;
+        }
+        for (x = w; stamp[x] != time; x = graph.Head(parent[x])) {
+            stamp[x] = time;
+            distance[x] = d--;
+        }
+    }
+    if (best != NONE) {
+        parent[v] = best;
+        stamp[v] = time;
+        distance[v] = shortest + 1;
+        return;
+    }
+
+    for (uint32_t a = graph.FirstArc(v); a < graph.LastArc(v); a++) {
+        uint32_t w = graph.Head(a);
+        if (tree[w] != tree[v]) {
+            continue;
+        }
+        if ((source ? graph.residual[graph.Sister(a)] : graph.residual[a]) != 0) {
+            Activate(w);
+        }
+        uint32_t up = parent[w];
+        if (up != PARENT_TERMINAL && up != PARENT_ORPHAN && graph.Head(up) == v) {
+            Orphan(w);
+        }
+    }
+    tree[v] = TREE_FREE;
+    parent[v] = NO_PARENT;
+}
+
+/*
+    Max flow from the source to the sink of the graph, leaving the residual capacities
+    in it. Flow from the source straight to the sink through a vertex is taken first.
+*/
+template <class G>
+uint64_t BoykovKolmogorov<G>::MaxFlow() {
+    STATS_PHASE("BoykovKolmogorov");
+    uint32_t nodes = graph.Nodes();
+    terminal.resize(nodes);
+    parent.assign(nodes, NO_PARENT);
+    tree.assign(nodes, TREE_FREE);
+    next.assign(nodes, NONE);
+    stamp.assign(nodes, 0);
+    distance.assign(nodes, 0);
+    firstActive = lastActive = NONE;
+    orphans.clear();
+    time = 0;
+
+    uint64_t flow = 0;
+    for (uint32_t v = 0; v < nodes; v++) {
+        uint32_t in = graph.sourceCapacity[v], out = graph.sinkCapacity[v];
+        flow += std::min(in, out);
+        terminal[v] = static_cast<int64_t>(in) - out;
+        if (terminal[v] != 0) {
+            tree[v] = terminal[v] > 0 ? TREE_SOURCE : TREE_SINK;
+            parent[v] = PARENT_TERMINAL;
+            distance[v] = 1;
+            Activate(v);
+        }
+    }
+
+    uint32_t v = NONE;
+    while (true) {
+        // keep growing from the vertex of the last path, else take the next active one
+        if (v == NONE || tree[v] == TREE_FREE) {
+            v = NONE;
+            while (firstActive != NONE && v == NONE) {
+                v = firstActive;
+                firstActive = (next[v] == v) ? NONE : next[v];
+                if (firstActive == NONE) {
+                    lastActive = NONE;
+                }
+                next[v] = NONE;
+                if (tree[v] == TREE_FREE) {
+                    v = NONE;
+                }
+            }
+            if (v == NONE) {
+                break;
+            }
+        }
+        uint32_t meet = Grow(v);
+        if (meet == NONE) {
+            v = NONE;
+            continue;
+        }
+        time++;
+        STATS_COUNT("augmentingPaths", 1);
+        flow += Augment(meet);
+        for (size_t i = 0; i < orphans.size(); i++) {
+            Adopt(orphans[i]);
+        }
+        orphans.clear();
+    }
+    return flow;
+}
+
+template class BoykovKolmogorov<GridGraph>;
+template class BoykovKolmogorov<TerminalNetwork>;
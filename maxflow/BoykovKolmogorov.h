@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "FlowNetwork.h"
+
+using std::vector;
+
+/*
+    A flow network with the arcs of its source and sink folded into terminal capacities,
+    for the Boykov-Kolmogorov engine. Every arc of the network is a pair of residual arcs
+    stored flat by tail, as in CostNetwork; the source and sink are left without arcs. If
+    undirected, every arc is an edge that can carry its capacity either way.
+
+    SetTerminals resets the residual capacities, so one network can be solved for many
+    pairs of terminals.
+*/
+class TerminalNetwork {
+public:
+    TerminalNetwork(const FlowNetworkView &, bool = false);
+    void SetTerminals(uint32_t, uint32_t);
+    // flow on arcs straight from the source to the sink, which the engine never sees
+    uint64_t DirectFlow() const { return direct; }
+
+    // the interface of the Boykov-Kolmogorov engine
+    uint32_t Nodes() const { return static_cast<uint32_t>(sourceCapacity.size()); }
+    uint32_t FirstArc(uint32_t node) const { return first[node]; }
+    uint32_t LastArc(uint32_t node) const { return first[node + 1]; }
+    uint32_t Head(uint32_t arc) const { return head[arc]; }
+    uint32_t Sister(uint32_t arc) const { return sister[arc]; }
+
+    vector<uint32_t> residual, sourceCapacity, sinkCapacity;
+
+private:
+    vector<uint32_t> first, head, sister, capacity;
+    uint64_t direct;
+};
+
+/*
+    Boykov and Kolmogorov's max flow engine for networks where every vertex may have arcs
+    from the source and to the sink, as in image segmentation. Two search trees grow from
+    the terminals over residual arcs; where they meet there is an augmenting path. After
+    augmenting, the vertices cut off from their tree are adopted by another vertex of the
+    same tree, or freed. Unlike Edmond-Karp the trees are kept between augmentations, which
+    on grids more than makes up for the paths not being shortest.
+
+    G is GridGraph or TerminalNetwork: vertices 0 .. Nodes() - 1, arcs FirstArc(v) ..
+    LastArc(v) - 1 leaving v, the public residual and terminal capacity arrays, and the
+    reverse arc Sister(a) of every arc a.
+*/
+template <class G>
+class BoykovKolmogorov {
+public:
+    BoykovKolmogorov(G &graph) : graph(graph) {}
+    uint64_t MaxFlow();
+    // after MaxFlow: whether node is on the source side of a minimum cut
+    bool SourceSide(uint32_t node) const { return tree[node] == TREE_SOURCE; }
+
+private:
+    enum Tree : uint8_t { TREE_FREE, TREE_SOURCE, TREE_SINK };
+
+    void Activate(uint32_t);
+    uint32_t Grow(uint32_t);
+    uint64_t Augment(uint32_t);
+    void Orphan(uint32_t);
+    void Adopt(uint32_t);
+
+    G &graph;
+    // remaining terminal capacity: from the source if positive, to the sink if negative
+    vector<int64_t> terminal;
+    // arc to the parent in the search tree (from the vertex, in either tree), or a mark
+    vector<uint32_t> parent;
+    vector<uint8_t> tree;
+    // FIFO of active vertices, linked through next
+    vector<uint32_t> next;
+    uint32_t firstActive, lastActive;
+    vector<uint32_t> orphans;
+    // distance to the terminal, valid when stamp is current
+    vector<uint32_t> stamp, distance;
+    uint32_t time;
+};
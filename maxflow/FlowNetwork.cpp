@@ -0,0 +1,181 @@
+/**
+    Bulk construction of flow networks from edge lists
+**/
+
+#include "FlowNetwork.h"
+#include "Stats.h"
+
+static bool ByEndpoints(const FlowEdge &a, const FlowEdge &b) {
+    return a.tail < b.tail || (a.tail == b.tail && a.head < b.head);
+}
+
+/*
+    Stable counting sort of from into to by one digit of the tail (or head): the bits of the
+    endpoint from shift on, under mask. Each thread counts the digits of its own slice of
+    from; the counts, summed bucket by bucket and slice by slice, tell every thread where its
+    edges of each bucket go, so the slices are then scattered concurrently.
+*/
+static void SortByDigit(const vector<FlowEdge> &from, vector<FlowEdge> &to, uint32_t shift, uint32_t mask,
+    bool byTail, uint32_t threads) {
+    size_t size = from.size(), slice = (size + threads - 1) / threads;
+    vector<vector<size_t>> position(threads, vector<size_t>(mask + 1, 0));
+    auto pass = [&](uint32_t t, bool scatter) {
+        vector<size_t> &next = position[t];
+        for (size_t i = t * slice; i < std::min(size, (t + 1) * slice); i++) {
+            uint32_t key = ((byTail ? from[i].tail : from[i].head) >> shift) & mask;
+            if (scatter) {
+                to[next[key]++] = from[i];
+            }
+            else {
+                next[key]++;
+            }
+        }
+    };
+    auto run = [&](bool scatter) {
+        vector<std::thread> workers;
+        for (uint32_t t = 1; t < threads; t++) {
+            workers.push_back(std::thread(pass, t, scatter));
+        }
+        pass(0, scatter);
+        for (vector<std::thread>::iterator it = workers.begin(); it != workers.end(); it++) {
+            it->join();
+        }
+    };
+
+    run(false);
+    size_t offset = 0;
+    for (uint32_t key = 0; key <= mask; key++) {
+        for (uint32_t t = 0; t < threads; t++) {
+            size_t count = position[t][key];
+            position[t][key] = offset;
+            offset += count;
+        }
+    }
+    run(true);
+}
+
+/*
+    Sorts the edges by (tail, head), every endpoint in 0..order, with an LSD radix sort of
+    stable counting passes: by the digits of head, then by those of tail. An endpoint takes
+    as few passes as digits of at most SORT_RADIX_BITS bits allow, so orders below 2^16
+    need two passes and any 32 bit order four. It runs in O(E) per pass, and each thread's
+    counts take O(2^SORT_RADIX_BITS) memory whatever the order.
+
+    param[in]: threads - number of threads to sort with
+*/
+void SortEdges(vector<FlowEdge> &edges, uint32_t order, uint32_t threads) {
+    threads = std::max(threads, 1u);
+    if (edges.size() < PARALLEL_SORT_CUTOFF * threads) {
+        threads = std::max(static_cast<uint32_t>(edges.size() / PARALLEL_SORT_CUTOFF), 1u);
+    }
+    uint32_t bits = 1;
+    while (bits < 32 && (1ull << bits) <= order) {
+        bits++;
+    }
+    uint32_t passes = (bits + SORT_RADIX_BITS - 1) / SORT_RADIX_BITS;
+    uint32_t width = (bits + passes - 1) / passes;
+
+    // 2 * passes passes leave the edges back in edges
+    vector<FlowEdge> buffer(edges.size());
+    for (uint32_t byTail = 0; byTail < 2; byTail++) {
+        for (uint32_t pass = 0; pass < passes; pass++) {
+            bool forward = (byTail * passes + pass) % 2 == 0;
+            SortByDigit(forward ? edges : buffer, forward ? buffer : edges, pass * width, (1u << width) - 1,
+                byTail, threads);
+        }
+    }
+}
+
+/*
+    Builds the flat adjacency of a flow network from all of its edges at once, in
+    O(E + V) however the edges are spread over the vertices.
+
+    Parallel edges are merged into one arc with the sum of their capacities. Of each
+    antiparallel pair u -> v, v -> u with u < v, the arc v -> u is routed through a new
+    vertex x as v -> x -> u, both with the capacity of v -> u, which leaves the flow value
+    unchanged. The new vertices are numbered from order + 1 in the order of their arcs.
+    Self-loops and edges of capacity 0 carry no flow and are dropped, so that no new
+    vertex is left between two arcs that cannot carry any.
+
+    param[in]: order - the edges join vertices 1..order
+    param[in,out]: edges - the edges, left sorted by (tail, head)
+    param[in]: threads - number of threads to sort the edges with
+*/
+FlowNetwork BuildFlowNetwork(uint32_t order, vector<FlowEdge> &edges, uint32_t threads) {
+    STATS_PHASE("BuildFlowNetwork");
+    SortEdges(edges, order, threads);
+
+    // merge parallel edges in place, so that [0, size) holds each arc once, still sorted
+    size_t size = 0;
+    for (size_t i = 0; i < edges.size(); i++) {
+        if (edges[i].tail == edges[i].head || edges[i].capacity == 0) {
+            continue;
+        }
+        if (size > 0 && edges[size - 1].tail == edges[i].tail && edges[size - 1].head == edges[i].head) {
+            edges[size - 1].capacity += edges[i].capacity;
+        }
+        else {
+            edges[size++] = edges[i];
+        }
+    }
+    edges.resize(size);
+
+    vector<size_t> row(order + 2, 0);
+    for (size_t i = 0; i < size; i++) {
+        row[edges[i].tail + 1]++;
+    }
+    for (uint32_t v = 1; v <= order; v++) {
+        row[v + 1] += row[v];
+    }
+
+    // mark the arcs v -> u with u < v whose reversal u -> v is also present
+    vector<uint8_t> split(size, 0);
+    size_t splits = 0;
+    for (size_t i = 0; i < size; i++) {
+        uint32_t u = edges[i].head, v = edges[i].tail;
+        if (u < v) {
+            FlowEdge reversal = { u, v, 0 };
+            split[i] = std::binary_search(edges.begin() + row[u], edges.begin() + row[u + 1], reversal, ByEndpoints);
+            splits += split[i];
+        }
+    }
+
+    FlowNetwork network;
+    network.order = order + static_cast<uint32_t>(splits);
+    network.first.assign(network.order + 2, 0);
+    network.head.reserve(size + splits);
+    network.capacity.reserve(size + splits);
+
+    // new vertices exceed every original one, so each row stays sorted if arcs to them go last
+    uint32_t x = order;
+    for (uint32_t v = 1; v <= order; v++) {
+        network.first[v] = static_cast<uint32_t>(network.head.size());
+        for (size_t i = row[v]; i < row[v + 1]; i++) {
+            if (!split[i]) {
+                network.head.push_back(edges[i].head);
+                network.capacity.push_back(edges[i].capacity);
+            }
+        }
+        for (size_t i = row[v]; i < row[v + 1]; i++) {
+            if (split[i]) {
+                network.head.push_back(++x);
+                network.capacity.push_back(edges[i].capacity);
+            }
+        }
+    }
+    x = order;
+    for (size_t i = 0; i < size; i++) {
+        if (split[i]) {
+            network.first[++x] = static_cast<uint32_t>(network.head.size());
+            network.head.push_back(edges[i].head);
+            network.capacity.push_back(edges[i].capacity);
+        }
+    }
+    network.first[network.order + 1] = static_cast<uint32_t>(network.head.size());
+    return network;
+}
+
+FlowNetworkView View(const FlowNetwork &network) {
+    FlowNetworkView view = { network.order, network.first.data(), network.head.data(), network.capacity.data() };
+    return view;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using std::vector;
+
+// Each thread sorting edges is given at least this many of them
+#define PARALLEL_SORT_CUTOFF 65536
+// Most bits of an endpoint sorted per counting pass of SortEdges
+#define SORT_RADIX_BITS 16
+
+typedef struct FlowEdge {
+    uint32_t tail, head, capacity;
+} FlowEdge;
+
+/*
+    Flat adjacency (CSR) of a flow network on the vertices 1..order: the arcs leaving v are
+    head[first[v]] .. head[first[v + 1] - 1], in increasing order of head, with capacities
+    capacity[first[v]] .. capacity[first[v + 1] - 1].
+
+    There are no parallel, antiparallel or self-loop arcs, which is what Graph expects of
+    the networks given to its engines.
+*/
+typedef struct FlowNetwork {
+    uint32_t order;
+    vector<uint32_t> first, head, capacity;
+} FlowNetwork;
+
+// The arrays of a flat adjacency, wherever they are stored (see FlowNetwork)
+typedef struct FlowNetworkView {
+    uint32_t order;
+    const uint32_t *first, *head, *capacity;
+} FlowNetworkView;
+
+FlowNetworkView View(const FlowNetwork &);
+
+void SortEdges(vector<FlowEdge> &, uint32_t, uint32_t = 1);
+FlowNetwork BuildFlowNetwork(uint32_t, vector<FlowEdge> &, uint32_t = 1);
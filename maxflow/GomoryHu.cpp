@@ -0,0 +1,136 @@
+/**
+    Gomory-Hu cut trees by Gusfield's method
+**/
+
+#include <algorithm>
+#include <thread>
+#include "BoykovKolmogorov.h"
+#include "GomoryHu.h"
+#include "Stats.h"
+
+/*
+    Minimum cut between source and sink of the network copy, by Boykov-Kolmogorov.
+
+    param[out]: value - the capacity of the cut
+    param[out]: side - 1 for the vertices on the source side of the cut, 0 for the rest
+*/
+static void Cut(TerminalNetwork &network, BoykovKolmogorov<TerminalNetwork> &engine, uint32_t source, uint32_t sink,
+    uint64_t &value, vector<uint8_t> &side) {
+    network.SetTerminals(source, sink);
+    value = engine.MaxFlow() + network.DirectFlow();
+    for (uint32_t v = 0; v < side.size(); v++) {
+        // the source itself is left out of the engine's search trees
+        side[v] = v == source || engine.SourceSide(v);
+    }
+}
+
+/*
+    Builds the tree. Every vertex s > 1 in turn is cut from its current parent t, and the
+    tree is updated from the cut. Which t that is depends on the cuts before, so the cuts
+    are found a batch at a time, one per thread, each against the parent its vertex has
+    when the batch starts. They are then taken in order for as long as the parents still
+    hold; the first one that no longer does starts the next batch. The first cut of a
+    batch always holds, and on most networks nearly all of them do.
+
+    Each thread keeps its own copy of the network and engine for every cut it finds.
+
+    param[in]: threads - number of max flows to run at once
+*/
+GomoryHuTree::GomoryHuTree(const FlowNetworkView &network, uint32_t threads) {
+    STATS_PHASE("GomoryHu");
+    uint32_t order = network.order;
+    parent.assign(order + 1, 1);
+    parent[0] = 0;
+    if (order > 0) {
+        parent[1] = 0;
+    }
+    weight.assign(order + 1, 0);
+
+    threads = std::max(1u, std::min(threads, order));
+    vector<TerminalNetwork> copies(threads, TerminalNetwork(network, true));
+    vector<BoykovKolmogorov<TerminalNetwork>> engines;
+    engines.reserve(threads);
+    for (uint32_t j = 0; j < threads; j++) {
+        engines.emplace_back(copies[j]);
+    }
+    vector<uint32_t> against(threads);
+    vector<uint64_t> value(threads);
+    vector<vector<uint8_t>> side(threads, vector<uint8_t>(order + 1));
+
+    for (uint32_t s = 2; s <= order;) {
+        uint32_t batch = std::min(threads, order - s + 1);
+        vector<std::thread> workers;
+        for (uint32_t j = 0; j < batch; j++) {
+            against[j] = parent[s + j];
+        }
+        for (uint32_t j = 1; j < batch; j++) {
+            workers.push_back(std::thread(Cut, std::ref(copies[j]), std::ref(engines[j]), s + j, against[j],
+                std::ref(value[j]), std::ref(side[j])));
+        }
+        Cut(copies[0], engines[0], s, against[0], value[0], side[0]);
+        for (vector<std::thread>::iterator it = workers.begin(); it != workers.end(); it++) {
+            it->join();
+        }
+        STATS_COUNT("maxFlows", batch);
+        uint32_t j = 0;
+        while (j < batch && parent[s + j] == against[j]) {
+            Commit(s + j, against[j], value[j], side[j]);
+            j++;
+        }
+        STATS_COUNT("staleCuts", batch - j);
+        s += j;
+    }
+
+    // depth of every vertex, for the path queries; parents may be numbered after children
+    depth.assign(order + 1, UINT32_MAX);
+    if (order > 0) {
+        depth[1] = 0;
+    }
+    vector<uint32_t> path;
+    for (uint32_t v = 1; v <= order; v++) {
+        uint32_t x = v;
+        while (depth[x] == UINT32_MAX) {
+            path.push_back(x);
+            x = parent[x];
+        }
+        for (; !path.empty(); path.pop_back()) {
+            depth[path.back()] = depth[parent[path.back()]] + 1;
+        }
+    }
+}
+
+/*
+    Updates the tree with a minimum cut between s and its parent t: the other children of t
+    on the side of s move under s, and if t's own parent is on that side, s takes t's place
+    in the tree.
+*/
+void GomoryHuTree::Commit(uint32_t s, uint32_t t, uint64_t value, const vector<uint8_t> &side) {
+    weight[s] = value;
+    for (uint32_t v = 1; v < parent.size(); v++) {
+        if (v != s && side[v] && parent[v] == t) {
+            parent[v] = s;
+        }
+    }
+    if (side[parent[t]]) {
+        parent[s] = parent[t];
+        parent[t] = s;
+        weight[s] = weight[t];
+        weight[t] = value;
+    }
+}
+
+/*
+    Capacity of a minimum cut between distinct vertices u and v: the lightest edge on the
+    tree path between them. Returns UINT64_MAX if u == v.
+*/
+uint64_t GomoryHuTree::MinCut(uint32_t u, uint32_t v) const {
+    uint64_t cut = UINT64_MAX;
+    while (u != v) {
+        if (depth[u] < depth[v]) {
+            std::swap(u, v);
+        }
+        cut = std::min(cut, weight[u]);
+        u = parent[u];
+    }
+    return cut;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "FlowNetwork.h"
+
+using std::vector;
+
+/*
+    Gomory-Hu cut tree of an undirected network, by Gusfield's method: n - 1 max flows on
+    the network itself, with no contractions. The minimum cut between any two vertices
+    is the lightest edge on the tree path between them, and removing that edge splits the
+    vertices as the cut does.
+
+    Each arc of the network is taken as an undirected edge; build it from edges with
+    tail < head, so that no pair of vertices has arcs both ways.
+*/
+class GomoryHuTree {
+public:
+    GomoryHuTree(const FlowNetworkView &, uint32_t = 1);
+    uint64_t MinCut(uint32_t, uint32_t) const;
+    // the tree is rooted at vertex 1, whose parent is 0
+    uint32_t Parent(uint32_t v) const { return parent[v]; }
+    // capacity of the cut between v and its parent
+    uint64_t Weight(uint32_t v) const { return weight[v]; }
+
+private:
+    void Commit(uint32_t, uint32_t, uint64_t, const vector<uint8_t> &);
+
+    vector<uint32_t> parent, depth;
+    vector<uint64_t> weight;
+};
@@ -3,15 +3,37 @@
 **/
 
 #include "Graph.h"
+#include "Stats.h"
 
-Graph::Graph(uint16_t numVerts) :
+Graph::Graph(uint32_t numVerts) :
     order(numVerts)
 {
-    for (uint16_t i = 1; i <= numVerts; i++) {
+    for (uint32_t i = 1; i <= numVerts; i++) {
         vertices[i] = Vertex();
     }
 };
 
+Graph::Graph(const FlowNetwork &network) : Graph(View(network)) {}
+
+/*
+    Builds the graph from a flat adjacency in one sweep. The arcs come sorted by
+    (tail, head), which is the order of capacity, so every insertion lands at its end.
+*/
+Graph::Graph(const FlowNetworkView &network) :
+    order(network.order)
+{
+    STATS_PHASE("Graph");
+    vertices.reserve(order);
+    for (uint32_t v = 1; v <= order; v++) {
+        Vertex &vertex = vertices[v];
+        for (uint32_t k = network.first[v]; k < network.first[v + 1]; k++) {
+            uint32_t u = network.head[k];
+            vertex.AddNeighbor(u);
+            capacity.emplace_hint(capacity.end(), edge(v, u), network.capacity[k]);
+        }
+    }
+}
+
 /* Add additional vertex after construction */
 void Graph::AddVertex() {
     order += 1;
@@ -24,8 +46,8 @@ void Graph::AddVertex() {
 // Avoids antiparallel edges
 // Should be used when constructing the initial flow problem
 */
-void Graph::AddEdgeNoReversal(uint16_t head, uint16_t tail, uint32_t cap = 0) {
-    list<uint16_t>* neighbors = vertices[tail].NeighborsPtr();
+void Graph::AddEdgeNoReversal(uint32_t head, uint32_t tail, uint32_t cap = 0) {
+    list<uint32_t>* neighbors = vertices[tail].NeighborsPtr();
     if (std::find(neighbors->begin(), neighbors->end(), head) != neighbors->end()) {
         AddVertex();
         vertices[head].AddNeighbor(order);
@@ -46,18 +68,19 @@ void Graph::AddEdgeNoReversal(uint16_t head, uint16_t tail, uint32_t cap = 0) {
 }
 
 // Insert an the given edge into the graph with capacity
-void Graph::AddEdge(uint16_t head, uint16_t tail, uint32_t cap = 0) {
+void Graph::AddEdge(uint32_t head, uint32_t tail, uint32_t cap = 0) {
     vertices[head].AddNeighbor(tail);
     capacity[edge(head, tail)] = cap;
 }
 
 // Ford-Fulkerson algorithm augmenting via shortest path
-uint32_t Graph::EdmondKarp(uint16_t source, uint16_t sink) {
+uint32_t Graph::EdmondKarp(uint32_t source, uint32_t sink) {
+    STATS_PHASE("EdmondKarp");
     // Initialize flow to 0
     signed_function f;
-    for (uint16_t v = 1; v <= order; v++) {
-        list<uint16_t> neighbors = vertices[v].Neighbors();
-        list<uint16_t>::iterator it;
+    for (uint32_t v = 1; v <= order; v++) {
+        list<uint32_t> neighbors = vertices[v].Neighbors();
+        list<uint32_t>::iterator it;
         for (it = neighbors.begin(); it != neighbors.end(); it++) {
             f[edge(v, *it)] = 0;
             f[edge(*it, v)] = 0;
@@ -65,13 +88,14 @@ uint32_t Graph::EdmondKarp(uint16_t source, uint16_t sink) {
     }
 
     Graph residual = ResidualNetwork(f);
-    vector<uint16_t> augPath;
+    vector<uint32_t> augPath;
     uint32_t minCap, val = 0;
     std::tie(augPath, minCap) = residual.ShortestPath(source, sink);
 
     while (augPath.size()) {
-        for (uint16_t i = 0; i < augPath.size() - 1; i++) {
-            list<uint16_t> neighs = vertices[augPath[i]].Neighbors();
+        STATS_COUNT("augmentingPaths", 1);
+        for (uint32_t i = 0; i < augPath.size() - 1; i++) {
+            list<uint32_t> neighs = vertices[augPath[i]].Neighbors();
             if (std::find(neighs.begin(), neighs.end(), augPath[i+1]) != neighs.end()) {
                 f[edge(augPath[i], augPath[i + 1])] += minCap;
             }
@@ -94,11 +118,11 @@ Graph Graph::ResidualNetwork(signed_function flow) {
     // set capacities - add an edge iff capacity(u,v) > flow(u,v)
     int32_t f, newcap;
 
-    for (uint16_t v = 1; v <= order; v++) {
-        list<uint16_t> neighbors = vertices[v].Neighbors();
-        list<uint16_t>::iterator it;
+    for (uint32_t v = 1; v <= order; v++) {
+        list<uint32_t> neighbors = vertices[v].Neighbors();
+        list<uint32_t>::iterator it;
         for (it = neighbors.begin(); it != neighbors.end(); it++) {
-            uint16_t u = *it;
+            uint32_t u = *it;
             f = flow[edge(v, u)];
             newcap = capacity[edge(v, u)] - f;
 
@@ -116,16 +140,16 @@ Graph Graph::ResidualNetwork(signed_function flow) {
 }
 
 // Adjust residual capacities along a given path
-void Graph::AugmentResidualNetwork(Graph* g, signed_function& flow, vector<uint16_t> path) {
+void Graph::AugmentResidualNetwork(Graph* g, signed_function& flow, vector<uint32_t> path) {
     uint32_t f, newcap;
     size_t len = path.size() - 1;
-    uint16_t u, v, t;
+    uint32_t u, v, t;
 
-    for (uint16_t i = 0; i < len; i++) {
+    for (uint32_t i = 0; i < len; i++) {
         u = path[i];
         v = path[i + 1];
-        list<uint16_t> neighbors = g->vertices[u].Neighbors();
-        list<uint16_t>::iterator it = std::find(neighbors.begin(), neighbors.end(), v);
+        list<uint32_t> neighbors = g->vertices[u].Neighbors();
+        list<uint32_t>::iterator it = std::find(neighbors.begin(), neighbors.end(), v);
 
         // If u -> v is not in G, switch
         if (it == neighbors.end()) {
@@ -173,28 +197,28 @@ void Graph::AugmentResidualNetwork(Graph* g, signed_function& flow, vector<uint1
     Returns a vector consisting of the shortest start, end-path
     and the bottleneck capacity of that path.
 */
-pair<vector<uint16_t>, uint32_t> Graph::ShortestPath(uint16_t start, uint16_t end) {
-    queue<uint16_t> queue;
-    unordered_map<uint16_t, bool> visited;
-    vector<uint16_t> parents; // change to map
+pair<vector<uint32_t>, uint32_t> Graph::ShortestPath(uint32_t start, uint32_t end) {
+    queue<uint32_t> queue;
+    unordered_map<uint32_t, bool> visited;
+    vector<uint32_t> parents; // change to map
 
     // set visited to false
-    for (uint16_t i = 0; i <= order; i++) {
+    for (uint32_t i = 0; i <= order; i++) {
         visited[i] = false;
         parents.push_back(i);
     }
 
     queue.push(start);
     visited[start] = true;
-    uint16_t currIndex;
+    uint32_t currIndex;
     while (!queue.empty()) {
         currIndex = queue.front();
         queue.pop();
 
-        list<uint16_t> neighbors = vertices[currIndex].Neighbors();
-        list<uint16_t>::iterator it = neighbors.begin();
+        list<uint32_t> neighbors = vertices[currIndex].Neighbors();
+        list<uint32_t>::iterator it = neighbors.begin();
         for (; it != neighbors.end(); it++) {
-            uint16_t u = *it;
+            uint32_t u = *it;
             if (!visited[u]) {
                 queue.push(u);
                 parents[u] = currIndex;
@@ -204,9 +228,9 @@ pair<vector<uint16_t>, uint32_t> Graph::ShortestPath(uint16_t start, uint16_t en
     }
 
     // backtrack from end, return empty path if unreachable
-    vector<uint16_t> path;
+    vector<uint32_t> path;
     currIndex = end;
-    uint32_t minCapacity;
+    uint32_t minCapacity = 0;
     if (visited[end]) {
         path.push_back(end);
         minCapacity = capacity[edge(parents[end], end)];
@@ -219,20 +243,21 @@ pair<vector<uint16_t>, uint32_t> Graph::ShortestPath(uint16_t start, uint16_t en
         std::reverse(path.begin(), path.end());
     }
 
-    return pair<vector<uint16_t>, uint32_t>(path, minCapacity);
+    return pair<vector<uint32_t>, uint32_t>(path, minCapacity);
 }
 
-uint32_t Graph::PushRelabelFlow(uint16_t source, uint16_t sink) {
+uint32_t Graph::PushRelabelFlow(uint32_t source, uint32_t sink) {
+    STATS_PHASE("PushRelabel");
     signed_function f;     // flow
     vector<int> l;  // height labeling
     vector<uint32_t> excess;                // keep track of excess at each vertex
     l.push_back(0), excess.push_back(0);    // skip 1st entry (vertices are 1-indexed)
-    std::list<uint16_t> active;             // list of currently active vertices
+    std::list<uint32_t> active;             // list of currently active vertices
 
     // initialize preflow and valid labelling
-    list<uint16_t>* neighbors;
-    list<uint16_t>::iterator it;
-    for (uint16_t v = 1; v <= order; v++) {
+    list<uint32_t>* neighbors;
+    list<uint32_t>::iterator it;
+    for (uint32_t v = 1; v <= order; v++) {
         neighbors = vertices[v].NeighborsPtr();
         it = neighbors->begin();
         l.push_back(0);
@@ -259,11 +284,11 @@ uint32_t Graph::PushRelabelFlow(uint16_t source, uint16_t sink) {
 
     Graph residual = ResidualNetwork(f);
 
-    uint16_t u;
+    uint32_t u;
     while (!active.empty()) {
         // grab active vertex with maximum height
-        std::list<uint16_t>::iterator it = active.begin();
-        std::list<uint16_t>::iterator loc = it;
+        std::list<uint32_t>::iterator it = active.begin();
+        std::list<uint32_t>::iterator loc = it;
         int m = l[*it];
         for (; it != active.end(); it++) {
             if (l[*it] > m) {
@@ -275,8 +300,8 @@ uint32_t Graph::PushRelabelFlow(uint16_t source, uint16_t sink) {
 
         bool edgeUtoV, edgeVtoU, pushed = false;
         neighbors = vertices[u].NeighborsPtr();
-        list<uint16_t> *vNeighbors;
-        list<uint16_t> *residualNeighbors = residual.vertices[u].NeighborsPtr();
+        list<uint32_t> *vNeighbors;
+        list<uint32_t> *residualNeighbors = residual.vertices[u].NeighborsPtr();
         // PUSH operation
         for (it = residualNeighbors->begin(); it != residualNeighbors->end(); it++) {
             if (l[u] != 1 + l[*it]) { continue; }
@@ -285,6 +310,7 @@ uint32_t Graph::PushRelabelFlow(uint16_t source, uint16_t sink) {
             vNeighbors = residual.vertices[*it].NeighborsPtr();
             edgeVtoU = (std::find(vNeighbors->begin(), vNeighbors->end(), u) != vNeighbors->end());
             pushed = true;
+            STATS_COUNT("pushes", 1);
 
             uint32_t delta;
             if (edgeUtoV) {
@@ -345,11 +371,12 @@ uint32_t Graph::PushRelabelFlow(uint16_t source, uint16_t sink) {
 }
 
 // Modify height labeling so that l[u] = 1 + min_{(u,v) in Gf} l[v]
-void Graph::Relabel(uint16_t u, Graph& residual, vector<int> &l) {
+void Graph::Relabel(uint32_t u, Graph& residual, vector<int> &l) {
+    STATS_COUNT("relabels", 1);
 
     int m = INT32_MAX;
-    list<uint16_t>* neighbors = residual.vertices[u].NeighborsPtr();
-    list<uint16_t>::iterator it = neighbors->begin();
+    list<uint32_t>* neighbors = residual.vertices[u].NeighborsPtr();
+    list<uint32_t>::iterator it = neighbors->begin();
     for (; it != neighbors->end(); it++) {
         m = std::min(m, l[*it]);
     }
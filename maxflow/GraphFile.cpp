@@ -0,0 +1,202 @@
+/**
+    DIMACS max flow input and binary graph files
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "GraphFile.h"
+
+// Parses the next unsigned number of line after *pos, moving *pos past it
+static bool ParseNumber(const char **pos, uint32_t &value) {
+    char *end;
+    unsigned long number = strtoul(*pos, &end, 10);
+    if (end == *pos || number > UINT32_MAX) {
+        return false;
+    }
+    value = static_cast<uint32_t>(number);
+    *pos = end;
+    return true;
+}
+
+/*
+    Reads a DIMACS max flow problem: comment lines "c ...", the problem line
+    "p max <vertices> <arcs>", the terminals "n <id> s" and "n <id> t", and one line
+    "a <tail> <head> <capacity>" per arc, with vertices numbered from 1.
+
+    param[out]: order, source, sink - the number of vertices and the terminals
+    param[out]: edges - the arcs, in input order
+    Returns false if the input is not such a problem, or its source is its sink.
+*/
+bool ReadDimacs(std::istream &in, uint32_t &order, uint32_t &source, uint32_t &sink, vector<FlowEdge> &edges) {
+    std::string line;
+    uint32_t size = 0;
+    bool problem = false;
+    source = sink = 0;
+    edges.clear();
+    while (std::getline(in, line)) {
+        const char *pos = line.c_str() + 1;
+        switch (line.empty() ? 'c' : line[0]) {
+        case 'c':
+        case '\r':
+            break;
+        case 'p': {
+            while (*pos == ' ' || *pos == '\t') {
+                pos++;
+            }
+            if (problem || strncmp(pos, "max", 3)) {
+                return false;
+            }
+            pos += 3;
+            if (!ParseNumber(&pos, order) || !ParseNumber(&pos, size)) {
+                return false;
+            }
+            problem = true;
+            edges.reserve(size);
+            break;
+        }
+        case 'n': {
+            uint32_t id;
+            if (!problem || !ParseNumber(&pos, id) || id == 0 || id > order) {
+                return false;
+            }
+            while (*pos == ' ' || *pos == '\t') {
+                pos++;
+            }
+            if (*pos == 's') {
+                source = id;
+            }
+            else if (*pos == 't') {
+                sink = id;
+            }
+            else {
+                return false;
+            }
+            break;
+        }
+        case 'a': {
+            FlowEdge e;
+            if (!problem || !ParseNumber(&pos, e.tail) || !ParseNumber(&pos, e.head) || !ParseNumber(&pos, e.capacity) ||
+                e.tail == 0 || e.tail > order || e.head == 0 || e.head > order) {
+                return false;
+            }
+            edges.push_back(e);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return problem && source != 0 && sink != 0 && source != sink && edges.size() == size;
+}
+
+/*
+    Writes network, with its terminals, as a binary graph file (see GraphFileHeader).
+    Returns false if the file could not be written.
+*/
+bool WriteGraphFile(const char *path, const FlowNetwork &network, uint32_t source, uint32_t sink) {
+    GraphFileHeader header;
+    memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+    header.order = network.order;
+    header.source = source;
+    header.sink = sink;
+    header.reserved = 0;
+    header.arcs = network.head.size();
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(network.first.data(), sizeof(uint32_t), network.first.size(), file) == network.first.size() &&
+        fwrite(network.head.data(), sizeof(uint32_t), network.head.size(), file) == network.head.size() &&
+        fwrite(network.capacity.data(), sizeof(uint32_t), network.capacity.size(), file) == network.capacity.size();
+    return fclose(file) == 0 && written;
+}
+
+MappedGraphFile::~MappedGraphFile() {
+    Close();
+}
+
+void MappedGraphFile::Close() {
+    if (data != NULL) {
+#ifdef _WIN32
+        free(data);
+#else
+        munmap(data, length);
+#endif
+        data = NULL;
+        length = 0;
+    }
+}
+
+/*
+    Maps the binary graph file at path. Only the header, the terminals (distinct vertices)
+    and the array sizes are checked; the arrays are trusted to be what WriteGraphFile
+    wrote. Without mmap (on Windows) the file is read into memory instead.
+
+    Returns false if the file cannot be mapped or is not a graph file.
+*/
+bool MappedGraphFile::Open(const char *path) {
+    Close();
+#ifdef _WIN32
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size < static_cast<long>(sizeof(GraphFileHeader)) || (data = malloc(size)) == NULL ||
+        fread(data, 1, size, file) != static_cast<size_t>(size)) {
+        fclose(file);
+        free(data);
+        data = NULL;
+        return false;
+    }
+    fclose(file);
+    length = static_cast<size_t>(size);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(GraphFileHeader)) {
+        close(fd);
+        return false;
+    }
+    length = static_cast<size_t>(status.st_size);
+    data = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    // the mapping keeps the file open
+    close(fd);
+    if (data == MAP_FAILED) {
+        data = NULL;
+        length = 0;
+        return false;
+    }
+#endif
+
+    memcpy(&header, data, sizeof(header));
+    const uint32_t *arrays = reinterpret_cast<const uint32_t *>(static_cast<const char *>(data) + sizeof(header));
+    uint64_t words = static_cast<uint64_t>(header.order) + 2 + 2 * header.arcs;
+    if (memcmp(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic)) ||
+        header.source == 0 || header.source > header.order || header.sink == 0 || header.sink > header.order ||
+        header.source == header.sink ||
+        length != sizeof(header) + words * sizeof(uint32_t) || arrays[header.order + 1] != header.arcs) {
+        Close();
+        return false;
+    }
+    view.order = header.order;
+    view.first = arrays;
+    view.head = arrays + header.order + 2;
+    view.capacity = view.head + header.arcs;
+    return true;
+}
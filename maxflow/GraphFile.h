@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <istream>
+#include <vector>
+#include "FlowNetwork.h"
+
+using std::vector;
+
+// First bytes of a binary graph file, naming the format and its version
+#define GRAPH_FILE_MAGIC "FLOWCSR1"
+
+/*
+    Header of a binary graph file. It is followed by the arrays of a FlowNetwork as native
+    uint32_t: first[order + 2], head[arcs], capacity[arcs]. The header is a multiple of
+    4 bytes, so the arrays can be used in place once the file is mapped.
+*/
+typedef struct GraphFileHeader {
+    char magic[8];
+    uint32_t order, source, sink, reserved;
+    uint64_t arcs;
+} GraphFileHeader;
+
+bool ReadDimacs(std::istream &, uint32_t &, uint32_t &, uint32_t &, vector<FlowEdge> &);
+bool WriteGraphFile(const char *, const FlowNetwork &, uint32_t, uint32_t);
+
+/*
+    A binary graph file mapped into memory read-only. The view points into the mapping,
+    so nothing is parsed or copied on load and pages are read as the solver touches them.
+    Solvers that need their own representation (Graph, TerminalNetwork) still build it
+    from the view.
+*/
+class MappedGraphFile {
+public:
+    MappedGraphFile() : data(NULL), length(0) {}
+    ~MappedGraphFile();
+    bool Open(const char *);
+    const FlowNetworkView &View() const { return view; }
+    uint32_t Source() const { return header.source; }
+    uint32_t Sink() const { return header.sink; }
+
+private:
+    MappedGraphFile(const MappedGraphFile &);
+    MappedGraphFile &operator=(const MappedGraphFile &);
+    void Close();
+
+    void *data;
+    size_t length;
+    GraphFileHeader header;
+    FlowNetworkView view;
+};
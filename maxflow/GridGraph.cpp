@@ -0,0 +1,48 @@
+/**
+    Implicit 4- and 8-connected image grids
+**/
+
+#include "GridGraph.h"
+
+/*
+    An empty width by height grid, 8-connected if diagonal, else 4-connected.
+*/
+GridGraph::GridGraph(uint32_t width, uint32_t height, bool diagonal)
+    : width(width), height(height), stride(width + 2), shift(diagonal ? 3 : 2), mask(diagonal ? 7 : 3) {
+    uint32_t nodes = stride * (height + 2);
+    residual.assign(static_cast<size_t>(nodes) << shift, 0);
+    sourceCapacity.assign(nodes, 0);
+    sinkCapacity.assign(nodes, 0);
+    // unsigned arithmetic wraps, so adding these moves back as well as forward
+    offset[GRID_RIGHT] = 1;
+    offset[GRID_LEFT] = static_cast<uint32_t>(-1);
+    offset[GRID_DOWN] = stride;
+    offset[GRID_UP] = static_cast<uint32_t>(-static_cast<int64_t>(stride));
+    offset[GRID_DOWN_RIGHT] = stride + 1;
+    offset[GRID_UP_LEFT] = static_cast<uint32_t>(-static_cast<int64_t>(stride + 1));
+    offset[GRID_DOWN_LEFT] = stride - 1;
+    offset[GRID_UP_RIGHT] = static_cast<uint32_t>(-static_cast<int64_t>(stride - 1));
+}
+
+/*
+    Sets the capacities of the arcs from the source to pixel (x, y) and from it to the sink.
+*/
+void GridGraph::SetTerminals(uint32_t x, uint32_t y, uint32_t source, uint32_t sink) {
+    uint32_t node = Node(x, y);
+    sourceCapacity[node] = source;
+    sinkCapacity[node] = sink;
+}
+
+/*
+    Sets the capacity of the arc from pixel (x, y) to its neighbour in direction. Arcs
+    leaving the grid, and diagonal arcs of a 4-connected grid, are ignored.
+*/
+void GridGraph::SetEdge(uint32_t x, uint32_t y, GridDirection direction, uint32_t capacity) {
+    static const int dx[GRID_DIRECTIONS] = { 1, -1, 0, 0, 1, -1, -1, 1 };
+    static const int dy[GRID_DIRECTIONS] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+    int64_t nx = static_cast<int64_t>(x) + dx[direction], ny = static_cast<int64_t>(y) + dy[direction];
+    if (static_cast<uint32_t>(direction) > mask || nx < 0 || ny < 0 || nx >= width || ny >= height) {
+        return;
+    }
+    residual[FirstArc(Node(x, y)) + direction] = capacity;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+// Directions from a pixel; the opposite of direction d is d ^ 1
+enum GridDirection {
+    GRID_RIGHT, GRID_LEFT, GRID_DOWN, GRID_UP,
+    GRID_DOWN_RIGHT, GRID_UP_LEFT, GRID_DOWN_LEFT, GRID_UP_RIGHT
+};
+// 4-connected grids use the first four directions
+#define GRID_DIRECTIONS 8
+
+/*
+    A 4- or 8-connected image grid as a flow network: every pixel is a vertex with an arc
+    from the source and an arc to the sink (the terminal capacities), and an arc to each
+    neighbouring pixel. Nothing but the capacities is stored; the neighbour of a pixel in
+    a direction is found by arithmetic on its index.
+
+    The grid is padded by a border of pixels with no capacity, so every real pixel has a
+    neighbour in every direction. Node(x, y) is the index of pixel (x, y), and arc
+    (node << shift) + d goes from node in direction d.
+
+    Solving consumes the capacities: afterwards residual holds the residual capacities.
+*/
+class GridGraph {
+public:
+    GridGraph(uint32_t, uint32_t, bool);
+
+    uint32_t Width() const { return width; }
+    uint32_t Height() const { return height; }
+    uint32_t Directions() const { return 1u << shift; }
+    uint32_t Node(uint32_t x, uint32_t y) const { return (y + 1) * stride + x + 1; }
+    void SetTerminals(uint32_t, uint32_t, uint32_t, uint32_t);
+    void SetEdge(uint32_t, uint32_t, GridDirection, uint32_t);
+
+    // the interface of the Boykov-Kolmogorov engine
+    uint32_t Nodes() const { return static_cast<uint32_t>(sourceCapacity.size()); }
+    uint32_t FirstArc(uint32_t node) const { return node << shift; }
+    uint32_t LastArc(uint32_t node) const { return (node + 1) << shift; }
+    uint32_t Head(uint32_t arc) const { return (arc >> shift) + offset[arc & mask]; }
+    uint32_t Sister(uint32_t arc) const { return (Head(arc) << shift) | ((arc & mask) ^ 1); }
+
+    vector<uint32_t> residual, sourceCapacity, sinkCapacity;
+
+private:
+    uint32_t width, height, stride, shift, mask;
+    // index difference to the neighbour in each direction
+    uint32_t offset[GRID_DIRECTIONS];
+};
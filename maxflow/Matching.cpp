@@ -0,0 +1,171 @@
+/**
+    Maximum bipartite matching for unit-capacity flow networks
+**/
+
+#include <algorithm>
+#include "Matching.h"
+#include "Stats.h"
+
+// No layer yet
+#define NO_LAYER UINT32_MAX
+
+/*
+    Checks whether the network is a bipartite matching instance: source feeds a set of left
+    vertices and a disjoint set of right vertices drains to sink, all by arcs of capacity 1,
+    and every other arc goes from a left vertex to a right one. As a left vertex takes in
+    at most 1, any positive capacity of those (merged parallel edges) acts as 1. Its max
+    flow is then the size of a maximum matching between the left and right vertices.
+
+    param[out]: left - the left vertices, if it is
+*/
+bool IsUnitBipartite(const FlowNetworkView &network, uint32_t source, uint32_t sink, vector<uint32_t> &left) {
+    if (source == sink || source == 0 || sink == 0 || source > network.order || sink > network.order) {
+        return false;
+    }
+    enum Side { SIDE_NONE, SIDE_LEFT, SIDE_RIGHT, SIDE_TERMINAL };
+    vector<uint8_t> side(network.order + 1, SIDE_NONE);
+    side[source] = side[sink] = SIDE_TERMINAL;
+    left.clear();
+    for (uint32_t k = network.first[source]; k < network.first[source + 1]; k++) {
+        if (network.capacity[k] != 1 || side[network.head[k]] != SIDE_NONE) {
+            return false;
+        }
+        side[network.head[k]] = SIDE_LEFT;
+        left.push_back(network.head[k]);
+    }
+    for (uint32_t v = 1; v <= network.order; v++) {
+        for (uint32_t k = network.first[v]; k < network.first[v + 1]; k++) {
+            if (network.head[k] == sink) {
+                if (network.capacity[k] != 1 || side[v] == SIDE_LEFT || side[v] == SIDE_TERMINAL) {
+                    return false;
+                }
+                side[v] = SIDE_RIGHT;
+            }
+        }
+    }
+    for (uint32_t v = 1; v <= network.order; v++) {
+        if (v == source) {
+            continue;
+        }
+        for (uint32_t k = network.first[v]; k < network.first[v + 1]; k++) {
+            uint32_t w = network.head[k];
+            if (w != sink && (network.capacity[k] == 0 || side[v] != SIDE_LEFT || side[w] != SIDE_RIGHT)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+    Hopcroft and Karp's maximum matching in O(E sqrt(V)). Each phase finds the length of a
+    shortest augmenting path by breadth first search from the free left vertices, layering
+    the left vertices, then augments along a maximal set of vertex-disjoint shortest paths
+    by depth first search through the layers. There are O(sqrt(V)) phases.
+
+    The arcs of network from the left vertices are the edges of the bipartite graph; the
+    arcs of source and sink are ignored.
+
+    param[in]: left - the left vertices
+*/
+Matching HopcroftKarp(const FlowNetworkView &network, const vector<uint32_t> &left) {
+    STATS_PHASE("HopcroftKarp");
+    const uint32_t *first = network.first, *head = network.head;
+    vector<uint32_t> mate(network.order + 1, UNMATCHED), layer(network.order + 1, NO_LAYER);
+    vector<uint32_t> current(network.order + 1), queue, stack, via;
+    uint32_t size = 0;
+
+    // greedy start: match each left vertex to its first free neighbour
+    for (vector<uint32_t>::const_iterator u = left.begin(); u != left.end(); u++) {
+        for (uint32_t k = first[*u]; k < first[*u + 1]; k++) {
+            if (mate[head[k]] == UNMATCHED) {
+                mate[*u] = head[k];
+                mate[head[k]] = *u;
+                size++;
+                break;
+            }
+        }
+    }
+
+    while (true) {
+        // layer the left vertices by alternating path length from a free one
+        queue.clear();
+        for (vector<uint32_t>::const_iterator u = left.begin(); u != left.end(); u++) {
+            layer[*u] = (mate[*u] == UNMATCHED) ? 0 : NO_LAYER;
+            if (mate[*u] == UNMATCHED) {
+                queue.push_back(*u);
+            }
+        }
+        uint32_t free = NO_LAYER;
+        for (size_t i = 0; i < queue.size(); i++) {
+            uint32_t u = queue[i];
+            if (layer[u] >= free) {
+                break;
+            }
+            for (uint32_t k = first[u]; k < first[u + 1]; k++) {
+                uint32_t w = mate[head[k]];
+                if (w == UNMATCHED) {
+                    free = std::min(free, layer[u] + 1);
+                }
+                else if (layer[w] == NO_LAYER) {
+                    layer[w] = layer[u] + 1;
+                    queue.push_back(w);
+                }
+            }
+        }
+        if (free == NO_LAYER) {
+            break;
+        }
+        STATS_COUNT("matchingPhases", 1);
+
+        // vertex-disjoint shortest augmenting paths; a left vertex that leads nowhere leaves its layer
+        for (vector<uint32_t>::const_iterator u = left.begin(); u != left.end(); u++) {
+            current[*u] = first[*u];
+        }
+        for (vector<uint32_t>::const_iterator u = left.begin(); u != left.end(); u++) {
+            if (mate[*u] != UNMATCHED) {
+                continue;
+            }
+            stack.assign(1, *u);
+            via.clear();
+            while (!stack.empty()) {
+                uint32_t x = stack.back();
+                if (current[x] == first[x + 1]) {
+                    layer[x] = NO_LAYER;
+                    stack.pop_back();
+                    if (!via.empty()) {
+                        via.pop_back();
+                    }
+                    continue;
+                }
+                uint32_t v = head[current[x]++], w = mate[v];
+                if (w == UNMATCHED && layer[x] + 1 == free) {
+                    // flip the path: every left vertex on the stack takes the right vertex after it
+                    via.push_back(v);
+                    for (size_t i = 0; i < stack.size(); i++) {
+                        mate[stack[i]] = via[i];
+                        mate[via[i]] = stack[i];
+                    }
+                    size++;
+                    STATS_COUNT("augmentingPaths", 1);
+                    break;
+                }
+                if (w != UNMATCHED && layer[w] == layer[x] + 1) {
+                    stack.push_back(w);
+                    via.push_back(v);
+                }
+            }
+        }
+    }
+
+    Matching matching;
+    matching.size = size;
+    vector<uint32_t> sorted(left);
+    std::sort(sorted.begin(), sorted.end());
+    for (vector<uint32_t>::iterator u = sorted.begin(); u != sorted.end(); u++) {
+        if (mate[*u] != UNMATCHED) {
+            matching.pairs.push_back(std::make_pair(*u, mate[*u]));
+        }
+    }
+    return matching;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "FlowNetwork.h"
+
+using std::pair;
+using std::vector;
+
+// Vertex 0 is not used, so it marks a free vertex
+#define UNMATCHED 0
+
+typedef struct Matching {
+    uint32_t size;
+    // (left, right) for every matched left vertex, by increasing left
+    vector<pair<uint32_t, uint32_t>> pairs;
+} Matching;
+
+bool IsUnitBipartite(const FlowNetworkView &, uint32_t, uint32_t, vector<uint32_t> &);
+Matching HopcroftKarp(const FlowNetworkView &, const vector<uint32_t> &);
@@ -0,0 +1,383 @@
+/**
+    Minimum cost flows by successive shortest paths, by cost scaling and by the network simplex method
+**/
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+#include "MinCostFlow.h"
+#include "NetworkSimplex.h"
+#include "Stats.h"
+
+const char *const minCostAlgorithmNames[MIN_COST_ALGORITHM_COUNT] = { "ssp", "scaling", "simplex" };
+
+// No level or distance yet
+#define NO_LEVEL UINT32_MAX
+#define UNREACHED INT64_MAX
+
+/*
+    Lays out the two residual arcs of every edge, grouped by tail with a counting sort.
+
+    param[in]: order - the edges join vertices 1..order
+*/
+CostNetwork::CostNetwork(uint32_t order, const vector<CostEdge> &edges) :
+    order(order)
+{
+    size_t arcs = 2 * edges.size();
+    first.assign(order + 2, 0);
+    for (vector<CostEdge>::const_iterator e = edges.begin(); e != edges.end(); e++) {
+        first[e->tail + 1]++;
+        first[e->head + 1]++;
+    }
+    for (uint32_t v = 1; v <= order; v++) {
+        first[v + 1] += first[v];
+    }
+    vector<uint32_t> next(first.begin(), first.end() - 1);
+    head.resize(arcs);
+    reverse.resize(arcs);
+    cost.resize(arcs);
+    forward.resize(edges.size());
+    capacity.resize(edges.size());
+    for (size_t i = 0; i < edges.size(); i++) {
+        uint32_t k = next[edges[i].tail]++, r = next[edges[i].head]++;
+        head[k] = edges[i].head;
+        head[r] = edges[i].tail;
+        reverse[k] = r;
+        reverse[r] = k;
+        cost[k] = edges[i].cost;
+        cost[r] = -static_cast<int64_t>(edges[i].cost);
+        forward[i] = k;
+        capacity[i] = edges[i].capacity;
+    }
+    Reset();
+}
+
+// Sets the flow to 0
+void CostNetwork::Reset() {
+    residual.assign(head.size(), 0);
+    for (size_t i = 0; i < forward.size(); i++) {
+        residual[forward[i]] = capacity[i];
+    }
+    potential.assign(order + 1, 0);
+}
+
+/*
+    Sets the potentials to the costs of cheapest paths over residual arcs from a virtual
+    vertex joined to every vertex at cost 0 (Bellman-Ford, queue based), which makes every
+    reduced cost non-negative.
+
+    Returns false if the residual network has a cycle of negative cost.
+*/
+bool CostNetwork::ShortestPathPotentials() {
+    vector<int64_t> distance(order + 1, 0);
+    vector<uint32_t> passes(order + 1, 0);
+    vector<uint8_t> queued(order + 1, 1);
+    std::queue<uint32_t> queue;
+    for (uint32_t v = 1; v <= order; v++) {
+        queue.push(v);
+    }
+    while (!queue.empty()) {
+        uint32_t v = queue.front();
+        queue.pop();
+        queued[v] = 0;
+        // a vertex improved more than order times lies behind a negative cycle
+        if (++passes[v] > order + 1) {
+            return false;
+        }
+        for (uint32_t k = first[v]; k < first[v + 1]; k++) {
+            uint32_t w = head[k];
+            if (residual[k] > 0 && distance[v] + cost[k] < distance[w]) {
+                distance[w] = distance[v] + cost[k];
+                if (!queued[w]) {
+                    queued[w] = 1;
+                    queue.push(w);
+                }
+            }
+        }
+    }
+    potential = distance;
+    return true;
+}
+
+/*
+    Successive shortest paths: augments along a cheapest source-sink path until the
+    demand is met or the sink is cut off. Dijkstra finds each path on reduced costs
+    cost(v, w) + potential(v) - potential(w), which the potentials (Johnson's reweighting,
+    updated by the distances of every search) keep non-negative, and stops at the sink.
+
+    Negative costs are allowed. If the network has a cycle of negative cost, paths alone
+    cannot find the cheapest flow, and it is found by CostScaling instead.
+*/
+MinCostFlowResult CostNetwork::SuccessiveShortestPaths(uint32_t source, uint32_t sink, uint64_t demand) {
+    STATS_PHASE("SuccessiveShortestPaths");
+    Reset();
+    bool negative = false;
+    for (vector<int64_t>::iterator c = cost.begin(); c != cost.end() && !negative; c++) {
+        negative = *c < 0 && residual[c - cost.begin()] > 0;
+    }
+    if (negative && !ShortestPathPotentials()) {
+        return CostScaling(source, sink, demand);
+    }
+
+    typedef std::pair<int64_t, uint32_t> Label;
+    vector<int64_t> distance(order + 1);
+    vector<uint32_t> parent(order + 1);
+    uint64_t flow = 0;
+    while (flow < demand) {
+        STATS_COUNT("shortestPaths", 1);
+        std::fill(distance.begin(), distance.end(), UNREACHED);
+        std::priority_queue<Label, vector<Label>, std::greater<Label>> heap;
+        distance[source] = 0;
+        heap.push(Label(0, source));
+        while (!heap.empty()) {
+            Label top = heap.top();
+            heap.pop();
+            uint32_t v = top.second;
+            if (top.first > distance[v]) {
+                continue;
+            }
+            // the rest of the vertices cannot be on a cheapest path to sink
+            if (v == sink) {
+                break;
+            }
+            for (uint32_t k = first[v]; k < first[v + 1]; k++) {
+                uint32_t w = head[k];
+                int64_t d = distance[v] + cost[k] + potential[v] - potential[w];
+                if (residual[k] > 0 && d < distance[w]) {
+                    distance[w] = d;
+                    parent[w] = k;
+                    heap.push(Label(d, w));
+                }
+            }
+        }
+        if (distance[sink] == UNREACHED) {
+            break;
+        }
+        // capping at the distance of sink keeps every reduced cost non-negative
+        for (uint32_t v = 1; v <= order; v++) {
+            potential[v] += std::min(distance[v], distance[sink]);
+        }
+
+        uint64_t delta = demand - flow;
+        for (uint32_t v = sink; v != source; v = head[reverse[parent[v]]]) {
+            delta = std::min(delta, static_cast<uint64_t>(residual[parent[v]]));
+        }
+        for (uint32_t v = sink; v != source; v = head[reverse[parent[v]]]) {
+            residual[parent[v]] -= static_cast<uint32_t>(delta);
+            residual[reverse[parent[v]]] += static_cast<uint32_t>(delta);
+        }
+        flow += delta;
+    }
+    return Result(flow);
+}
+
+/*
+    Dinic's blocking flows, from the current flow, until limit units leave source or
+    the sink is cut off. Costs are ignored. Returns the flow added.
+*/
+uint64_t CostNetwork::MaxFlow(uint32_t source, uint32_t sink, uint64_t limit) {
+    uint64_t flow = 0;
+    vector<uint32_t> level(order + 1), current(order + 1), path;
+    while (flow < limit) {
+        // levels by breadth first search on residual arcs
+        std::fill(level.begin(), level.end(), NO_LEVEL);
+        std::queue<uint32_t> queue;
+        level[source] = 0;
+        queue.push(source);
+        while (!queue.empty()) {
+            uint32_t v = queue.front();
+            queue.pop();
+            for (uint32_t k = first[v]; k < first[v + 1]; k++) {
+                if (residual[k] > 0 && level[head[k]] == NO_LEVEL) {
+                    level[head[k]] = level[v] + 1;
+                    queue.push(head[k]);
+                }
+            }
+        }
+        if (level[sink] == NO_LEVEL) {
+            break;
+        }
+
+        // blocking flow by depth first search along increasing levels, keeping the path as arcs
+        std::copy(first.begin(), first.end() - 1, current.begin());
+        path.clear();
+        uint32_t v = source;
+        while (flow < limit) {
+            if (v == sink) {
+                uint64_t delta = limit - flow;
+                for (vector<uint32_t>::iterator k = path.begin(); k != path.end(); k++) {
+                    delta = std::min(delta, static_cast<uint64_t>(residual[*k]));
+                }
+                size_t saturated = path.size();
+                for (size_t i = 0; i < path.size(); i++) {
+                    residual[path[i]] -= static_cast<uint32_t>(delta);
+                    residual[reverse[path[i]]] += static_cast<uint32_t>(delta);
+                    if (residual[path[i]] == 0 && saturated == path.size()) {
+                        saturated = i;
+                    }
+                }
+                flow += delta;
+                // continue from the tail of the first saturated arc
+                path.resize(saturated);
+                v = path.empty() ? source : head[path.back()];
+                continue;
+            }
+            uint32_t &k = current[v];
+            while (k < first[v + 1] && !(residual[k] > 0 && level[head[k]] == level[v] + 1)) {
+                k++;
+            }
+            if (k < first[v + 1]) {
+                path.push_back(k);
+                v = head[k];
+            }
+            else if (v == source) {
+                break;
+            }
+            else {
+                // dead end: no blocking path goes through v
+                level[v] = NO_LEVEL;
+                path.pop_back();
+                v = path.empty() ? source : head[path.back()];
+            }
+        }
+    }
+    return flow;
+}
+
+/*
+    Turns an epsilon'-optimal flow into an eps-optimal one, where every residual arc has
+    reduced cost at least -eps: arcs of negative reduced cost are saturated, and the excess
+    this leaves is pushed along admissible arcs (residual, negative reduced cost), lowering
+    the potential of a vertex by at least eps whenever it has none.
+
+    param[in]: scale - factor of every cost, see CostScaling
+*/
+void CostNetwork::Refine(int64_t eps, int64_t scale) {
+    STATS_COUNT("refines", 1);
+    vector<int64_t> excess(order + 1, 0);
+    for (uint32_t v = 1; v <= order; v++) {
+        for (uint32_t k = first[v]; k < first[v + 1]; k++) {
+            if (residual[k] > 0 && scale * cost[k] + potential[v] - potential[head[k]] < 0) {
+                excess[v] -= residual[k];
+                excess[head[k]] += residual[k];
+                residual[reverse[k]] += residual[k];
+                residual[k] = 0;
+            }
+        }
+    }
+
+    std::queue<uint32_t> active;
+    vector<uint32_t> current(first.begin(), first.end() - 1);
+    for (uint32_t v = 1; v <= order; v++) {
+        if (excess[v] > 0) {
+            active.push(v);
+        }
+    }
+    while (!active.empty()) {
+        uint32_t v = active.front();
+        active.pop();
+        while (excess[v] > 0) {
+            if (current[v] == first[v + 1]) {
+                // relabel: the least decrease that makes an arc admissible, and eps more
+                int64_t highest = INT64_MIN;
+                for (uint32_t k = first[v]; k < first[v + 1]; k++) {
+                    if (residual[k] > 0) {
+                        highest = std::max(highest, potential[head[k]] - scale * cost[k]);
+                    }
+                }
+                potential[v] = highest - eps;
+                current[v] = first[v];
+                continue;
+            }
+            uint32_t k = current[v], w = head[k];
+            if (residual[k] > 0 && scale * cost[k] + potential[v] - potential[w] < 0) {
+                uint32_t delta = static_cast<uint32_t>(std::min(excess[v], static_cast<int64_t>(residual[k])));
+                residual[k] -= delta;
+                residual[reverse[k]] += delta;
+                excess[v] -= delta;
+                if (excess[w] <= 0 && excess[w] + delta > 0) {
+                    active.push(w);
+                }
+                excess[w] += delta;
+            }
+            else {
+                current[v]++;
+            }
+        }
+    }
+}
+
+/*
+    Goldberg and Tarjan's cost scaling. A maximum flow (up to demand) is found first,
+    ignoring costs; its cost is then lowered, without changing its value, by refining it
+    to eps-optimality for eps falling by COST_SCALING_FACTOR each time. Costs are
+    multiplied by order + 1, so once the flow is 1-optimal it is optimal for the integer
+    costs. Cycles of negative cost are allowed.
+
+    The running time depends on log of the largest cost, not on the flow value, which
+    suits large instances with large capacities.
+*/
+MinCostFlowResult CostNetwork::CostScaling(uint32_t source, uint32_t sink, uint64_t demand) {
+    STATS_PHASE("CostScaling");
+    Reset();
+    uint64_t flow = MaxFlow(source, sink, demand);
+    int64_t scale = static_cast<int64_t>(order) + 1, eps = 0;
+    for (vector<int64_t>::iterator c = cost.begin(); c != cost.end(); c++) {
+        eps = std::max(eps, scale * (*c < 0 ? -*c : *c));
+    }
+    while (eps > 1) {
+        eps = std::max(eps / COST_SCALING_FACTOR, static_cast<int64_t>(1));
+        Refine(eps, scale);
+    }
+    return Result(flow);
+}
+
+/*
+    The flow value is found first with Dinic, ignoring costs, as in CostScaling; the network
+    simplex (see NetworkSimplex) then finds the cheapest flow of that value as a flow with
+    supplies at source and sink.
+*/
+MinCostFlowResult CostNetwork::NetworkSimplexFlow(uint32_t source, uint32_t sink, uint64_t demand) {
+    Reset();
+    uint64_t flow = MaxFlow(source, sink, demand);
+    vector<CostEdge> edges(forward.size());
+    for (size_t i = 0; i < forward.size(); i++) {
+        CostEdge e = { head[reverse[forward[i]]], head[forward[i]], capacity[i], static_cast<int32_t>(cost[forward[i]]) };
+        edges[i] = e;
+    }
+    vector<int64_t> supply(order + 1, 0);
+    supply[source] += static_cast<int64_t>(flow);
+    supply[sink] -= static_cast<int64_t>(flow);
+
+    // always feasible: the max flow itself meets the supplies
+    NetworkSimplex simplex(order, edges);
+    simplex.Solve(supply);
+    for (size_t i = 0; i < forward.size(); i++) {
+        residual[forward[i]] = capacity[i] - simplex.Flow(i);
+        residual[reverse[forward[i]]] = simplex.Flow(i);
+    }
+    return Result(flow);
+}
+
+MinCostFlowResult CostNetwork::Solve(MinCostAlgorithm algorithm, uint32_t source, uint32_t sink, uint64_t demand) {
+    if (algorithm == MIN_COST_SCALING) {
+        return CostScaling(source, sink, demand);
+    }
+    if (algorithm == MIN_COST_NETWORK_SIMPLEX) {
+        return NetworkSimplexFlow(source, sink, demand);
+    }
+    return SuccessiveShortestPaths(source, sink, demand);
+}
+
+MinCostFlowResult CostNetwork::Result(uint64_t flow) const {
+    MinCostFlowResult result;
+    result.flow = flow;
+    result.cost = 0;
+    result.edgeFlow.resize(forward.size());
+    for (size_t i = 0; i < forward.size(); i++) {
+        result.edgeFlow[i] = residual[reverse[forward[i]]];
+        result.cost += static_cast<int64_t>(result.edgeFlow[i]) * cost[forward[i]];
+    }
+    return result;
+}
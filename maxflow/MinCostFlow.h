@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+// Cost scaling divides epsilon by this between refinements
+#define COST_SCALING_FACTOR 16
+
+enum MinCostAlgorithm { MIN_COST_SSP, MIN_COST_SCALING, MIN_COST_NETWORK_SIMPLEX };
+#define MIN_COST_ALGORITHM_COUNT 3
+// command line names of the algorithms, indexed by MinCostAlgorithm
+extern const char *const minCostAlgorithmNames[MIN_COST_ALGORITHM_COUNT];
+
+typedef struct CostEdge {
+    uint32_t tail, head, capacity;
+    int32_t cost;
+} CostEdge;
+
+typedef struct MinCostFlowResult {
+    uint64_t flow;
+    int64_t cost;
+    // flow on each edge, in the order the edges were given
+    vector<uint32_t> edgeFlow;
+} MinCostFlowResult;
+
+/*
+    Residual network of a flow network with costs, for minimum cost flows from a source to
+    a sink. Every edge is a pair of residual arcs, forward with the remaining capacity and
+    cost c, and reverse with the flow and cost -c. The arcs are stored flat, grouped by
+    tail, with the index of each arc's partner. Parallel and antiparallel edges are kept
+    apart, as they may differ in cost.
+
+    All three solvers find a flow of value min(demand, max flow) of least cost, and can be
+    run again on the same network.
+*/
+class CostNetwork {
+public:
+    CostNetwork(uint32_t, const vector<CostEdge> &);
+    MinCostFlowResult SuccessiveShortestPaths(uint32_t, uint32_t, uint64_t = UINT64_MAX);
+    MinCostFlowResult CostScaling(uint32_t, uint32_t, uint64_t = UINT64_MAX);
+    MinCostFlowResult NetworkSimplexFlow(uint32_t, uint32_t, uint64_t = UINT64_MAX);
+    MinCostFlowResult Solve(MinCostAlgorithm, uint32_t, uint32_t, uint64_t = UINT64_MAX);
+
+private:
+    void Reset();
+    bool ShortestPathPotentials();
+    uint64_t MaxFlow(uint32_t, uint32_t, uint64_t);
+    void Refine(int64_t, int64_t);
+    MinCostFlowResult Result(uint64_t) const;
+
+    uint32_t order;
+    // residual arcs leaving v are first[v] .. first[v + 1] - 1; reverse[k] is the partner of arc k
+    vector<uint32_t> first, head, reverse, residual;
+    vector<int64_t> cost;
+    // the forward arc and capacity of each edge
+    vector<uint32_t> forward, capacity;
+    vector<int64_t> potential;
+};
@@ -0,0 +1,278 @@
+/**
+    Minimum cost flows by the primal network simplex method
+**/
+
+#include <algorithm>
+#include <cmath>
+#include "NetworkSimplex.h"
+#include "Stats.h"
+
+// Capacity of the artificial arcs
+#define UNCAPACITATED INT64_MAX
+// No leaving vertex: the entering arc goes from one bound to the other
+#define NONE UINT32_MAX
+
+/*
+    param[in]: order - the edges join vertices 1..order
+*/
+NetworkSimplex::NetworkSimplex(uint32_t order, const vector<CostEdge> &edges) :
+    order(order), edges(static_cast<uint32_t>(edges.size())), nextArc(0)
+{
+    uint32_t arcs = this->edges + order;
+    source.resize(arcs);
+    target.resize(arcs);
+    cost.resize(arcs);
+    capacity.resize(arcs);
+    for (uint32_t i = 0; i < this->edges; i++) {
+        source[i] = edges[i].tail;
+        target[i] = edges[i].head;
+        cost[i] = edges[i].cost;
+        capacity[i] = edges[i].capacity;
+    }
+    blockSize = std::max(static_cast<uint32_t>(BLOCK_SIZE_FACTOR * std::sqrt(static_cast<double>(this->edges))),
+        static_cast<uint32_t>(MIN_BLOCK_SIZE));
+    position.resize(order + 1);
+}
+
+/*
+    The starting basis: every vertex a child of the root, over an artificial arc that
+    carries its supply (pointing up for supply 0, which keeps the tree strongly feasible),
+    and every edge empty. The artificial arcs cost more than any path of edges, so they
+    are driven out of the tree whenever the supplies can be met.
+*/
+void NetworkSimplex::Initialize(const vector<int64_t> &supply) {
+    int64_t highest = 0;
+    for (uint32_t i = 0; i < edges; i++) {
+        highest = std::max(highest, cost[i] < 0 ? -cost[i] : cost[i]);
+    }
+    int64_t artificialCost = (highest + 1) * (static_cast<int64_t>(order) + 1);
+
+    flow.assign(source.size(), 0);
+    state.assign(source.size(), ARC_LOWER);
+    parent.assign(order + 1, 0);
+    pred.assign(order + 1, NONE);
+    depth.assign(order + 1, 1);
+    thread.resize(order + 1);
+    revThread.resize(order + 1);
+    potential.assign(order + 1, 0);
+    depth[0] = 0;
+    for (uint32_t v = 1; v <= order; v++) {
+        uint32_t a = edges + v - 1;
+        if (supply[v] >= 0) {
+            source[a] = v;
+            target[a] = 0;
+            flow[a] = supply[v];
+            potential[v] = -artificialCost;
+        }
+        else {
+            source[a] = 0;
+            target[a] = v;
+            flow[a] = -supply[v];
+            potential[v] = artificialCost;
+        }
+        cost[a] = artificialCost;
+        capacity[a] = UNCAPACITATED;
+        state[a] = ARC_TREE;
+        pred[v] = a;
+        thread[v - 1] = v;
+        revThread[v] = v - 1;
+    }
+    thread[order] = 0;
+    revThread[0] = order;
+}
+
+/*
+    Block search over the edges (the artificial arcs never come back into the tree): the
+    arc of most negative state * reduced cost among the first block that has one.
+
+    Returns false if no arc violates optimality.
+*/
+bool NetworkSimplex::FindEnteringArc(uint32_t &entering) {
+    int64_t best = 0;
+    uint32_t count = blockSize;
+    for (uint32_t i = 0; i < edges; i++) {
+        uint32_t a = nextArc;
+        nextArc = (nextArc + 1 == edges) ? 0 : nextArc + 1;
+        int64_t violation = state[a] * (cost[a] + potential[source[a]] - potential[target[a]]);
+        if (violation < best) {
+            best = violation;
+            entering = a;
+        }
+        if (--count == 0) {
+            if (best < 0) {
+                return true;
+            }
+            count = blockSize;
+        }
+    }
+    return best < 0;
+}
+
+// Where the tree paths from u and v to the root meet
+uint32_t NetworkSimplex::FindJoin(uint32_t u, uint32_t v) const {
+    while (u != v) {
+        if (depth[u] >= depth[v]) {
+            u = parent[u];
+        }
+        else {
+            v = parent[v];
+        }
+    }
+    return u;
+}
+
+/*
+    Moves the subtree under uOut, which the leaving arc pred[uOut] held, to hang from vIn
+    by the entering arc, rerooted at uIn: the path from uIn up to uOut turns around, the
+    subtree's thread is rebuilt in preorder from uIn and spliced in after vIn, and its
+    depths and potentials are updated. Takes time in the size of the subtree.
+*/
+void NetworkSimplex::UpdateTree(uint32_t in, uint32_t uIn, uint32_t vIn, uint32_t uOut) {
+    int64_t shift = (source[in] == uIn ? potential[vIn] - cost[in] : potential[vIn] + cost[in]) - potential[uIn];
+
+    // the subtree in thread order, cut out of the thread
+    subtree.clear();
+    uint32_t v = uOut;
+    do {
+        position[v] = static_cast<uint32_t>(subtree.size());
+        subtree.push_back(v);
+        v = thread[v];
+    } while (depth[v] > depth[uOut]);
+    thread[revThread[uOut]] = v;
+    revThread[v] = revThread[uOut];
+
+    // end[i]: where the subtree of path[i] ends in subtree; each contains the one before
+    path.clear();
+    end.clear();
+    uint32_t stop = position[uIn] + 1;
+    for (uint32_t u = uIn;; u = parent[u]) {
+        while (stop < subtree.size() && depth[subtree[stop]] > depth[u]) {
+            stop++;
+        }
+        path.push_back(u);
+        end.push_back(stop);
+        if (u == uOut) {
+            break;
+        }
+    }
+
+    // preorder from uIn: its own subtree, then each path vertex with what is left of its subtree
+    moved.assign(subtree.begin() + position[uIn], subtree.begin() + end[0]);
+    for (size_t i = 1; i < path.size(); i++) {
+        moved.insert(moved.end(), subtree.begin() + position[path[i]], subtree.begin() + position[path[i - 1]]);
+        moved.insert(moved.end(), subtree.begin() + end[i - 1], subtree.begin() + end[i]);
+    }
+
+    // turn the path around
+    uint32_t child = uIn, newParent = vIn, arc = in;
+    for (size_t i = 0; i < path.size(); i++) {
+        uint32_t oldArc = pred[child];
+        parent[child] = newParent;
+        pred[child] = arc;
+        newParent = child;
+        arc = oldArc;
+        child = i + 1 < path.size() ? path[i + 1] : 0;
+    }
+
+    uint32_t previous = vIn, next = thread[vIn];
+    for (vector<uint32_t>::iterator it = moved.begin(); it != moved.end(); it++) {
+        thread[previous] = *it;
+        revThread[*it] = previous;
+        previous = *it;
+        depth[*it] = depth[parent[*it]] + 1;
+        potential[*it] += shift;
+    }
+    thread[previous] = next;
+    revThread[next] = previous;
+}
+
+/*
+    Finds a minimum cost flow that meets the supplies. Can be run again with other supplies.
+
+    param[in]: supply - supply[v] for the vertices v = 1..order; supply[0] is not used
+
+    Returns false if the supplies do not sum to 0 or cannot be met within the capacities.
+*/
+bool NetworkSimplex::Solve(const vector<int64_t> &supply) {
+    STATS_PHASE("NetworkSimplex");
+    int64_t total = 0;
+    for (uint32_t v = 1; v <= order; v++) {
+        total += supply[v];
+    }
+    if (total != 0) {
+        return false;
+    }
+    Initialize(supply);
+
+    uint32_t in;
+    while (FindEnteringArc(in)) {
+        STATS_COUNT("pivots", 1);
+        // the cycle sends flow from first over the entering arc to second, then up to join and down to first
+        uint32_t first = source[in], second = target[in];
+        if (state[in] == ARC_UPPER) {
+            std::swap(first, second);
+        }
+        uint32_t join = FindJoin(first, second);
+
+        // the leaving arc blocks the least flow; ties go to the last one on the cycle after join
+        int64_t delta = capacity[in];
+        uint32_t uOut = NONE;
+        bool firstSide = false;
+        for (uint32_t u = first; u != join; u = parent[u]) {
+            uint32_t a = pred[u];
+            int64_t room = source[a] == u ? flow[a] : capacity[a] - flow[a];
+            if (room < delta) {
+                delta = room;
+                uOut = u;
+                firstSide = true;
+            }
+        }
+        for (uint32_t u = second; u != join; u = parent[u]) {
+            uint32_t a = pred[u];
+            int64_t room = source[a] == u ? capacity[a] - flow[a] : flow[a];
+            if (room <= delta) {
+                delta = room;
+                uOut = u;
+                firstSide = false;
+            }
+        }
+
+        if (delta > 0) {
+            flow[in] += state[in] * delta;
+            for (uint32_t u = first; u != join; u = parent[u]) {
+                flow[pred[u]] += source[pred[u]] == u ? -delta : delta;
+            }
+            for (uint32_t u = second; u != join; u = parent[u]) {
+                flow[pred[u]] += source[pred[u]] == u ? delta : -delta;
+            }
+        }
+        else {
+            STATS_COUNT("degeneratePivots", 1);
+        }
+
+        if (uOut == NONE) {
+            state[in] = -state[in];
+        }
+        else {
+            uint32_t out = pred[uOut];
+            state[out] = flow[out] == 0 ? ARC_LOWER : ARC_UPPER;
+            state[in] = ARC_TREE;
+            UpdateTree(in, firstSide ? first : second, firstSide ? second : first, uOut);
+        }
+    }
+
+    for (uint32_t a = edges; a < source.size(); a++) {
+        if (flow[a] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int64_t NetworkSimplex::Cost() const {
+    int64_t total = 0;
+    for (uint32_t i = 0; i < edges; i++) {
+        total += flow[i] * cost[i];
+    }
+    return total;
+}
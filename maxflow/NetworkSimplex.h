@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "MinCostFlow.h"
+
+using std::vector;
+
+// Arcs in a block of the entering arc search are this times the square root of the number of edges
+#define BLOCK_SIZE_FACTOR 1.0
+// Fewest arcs in a block
+#define MIN_BLOCK_SIZE 10
+
+// Where a non-tree arc's flow sits, with the sign of the change the arc can enter with
+enum ArcState { ARC_UPPER = -1, ARC_TREE = 0, ARC_LOWER = 1 };
+
+/*
+    Primal network simplex for minimum cost flows with supplies: every vertex v sends
+    supply[v] more units than it receives (a negative supply is a demand), within the
+    edge capacities, at least cost. Transportation problems, circulations (all supplies
+    0, with negative costs) and source-sink flows of a given value are all of this form.
+
+    The basis is a spanning tree over the vertices and an artificial root 0, which starts
+    joined to every vertex by an artificial arc of prohibitive cost. The tree is kept as
+    each vertex's parent, tree arc and depth, and a thread through the vertices in
+    preorder, so that the subtree under a vertex is the run of deeper vertices after it
+    on the thread. A pivot only renumbers the subtree that moves. Entering arcs are picked
+    by block search: the arcs are scanned a block at a time from where the last search
+    stopped, and the most violating arc of the first block with any is taken. Leaving arcs
+    keep the tree strongly feasible, which rules out cycling.
+*/
+class NetworkSimplex {
+public:
+    NetworkSimplex(uint32_t, const vector<CostEdge> &);
+    bool Solve(const vector<int64_t> &);
+    // flow on edge i, in the order the edges were given
+    uint32_t Flow(size_t i) const { return static_cast<uint32_t>(flow[i]); }
+    int64_t Cost() const;
+    // cost + potential(tail) - potential(head) is 0 on tree arcs and the optimality condition elsewhere
+    int64_t Potential(uint32_t v) const { return potential[v]; }
+
+private:
+    void Initialize(const vector<int64_t> &);
+    bool FindEnteringArc(uint32_t &);
+    uint32_t FindJoin(uint32_t, uint32_t) const;
+    void UpdateTree(uint32_t, uint32_t, uint32_t, uint32_t);
+
+    uint32_t order, edges, blockSize, nextArc;
+    // edges 0..edges-1 are the given ones, and edges + v - 1 is the artificial arc between v and 0
+    vector<uint32_t> source, target;
+    vector<int64_t> cost, capacity, flow;
+    vector<int8_t> state;
+    // the tree: parent of each vertex, the arc to it, depth, and thread (preorder successor) both ways
+    vector<uint32_t> parent, pred, depth, thread, revThread;
+    vector<int64_t> potential;
+    // scratch for UpdateTree
+    vector<uint32_t> subtree, moved, position, path, end;
+};
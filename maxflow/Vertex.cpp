@@ -6,26 +6,26 @@
 
 Vertex::Vertex() {}
 
-list<uint16_t> Vertex::Neighbors() {
+list<uint32_t> Vertex::Neighbors() {
     return neighbors;
 }
 
-list<uint16_t>* Vertex::NeighborsPtr() {
+list<uint32_t>* Vertex::NeighborsPtr() {
     return &neighbors;
 }
 
-void Vertex::AddNeighbor(uint16_t idx) {
+void Vertex::AddNeighbor(uint32_t idx) {
     neighbors.push_back(idx);
 }
 
-list<uint16_t>::iterator Vertex::FindNeighbor(uint16_t idx) {
+list<uint32_t>::iterator Vertex::FindNeighbor(uint32_t idx) {
     return std::find(neighbors.begin(), neighbors.end(), idx);
 }
 
-list<uint16_t>::iterator Vertex::EndNeighbor() {
+list<uint32_t>::iterator Vertex::EndNeighbor() {
     return neighbors.end();
 }
 
-void Vertex::RemoveNeighbor(list<uint16_t>::iterator it) {
+void Vertex::RemoveNeighbor(list<uint32_t>::iterator it) {
     neighbors.erase(it);
 }
\ No newline at end of file
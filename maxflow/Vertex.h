@@ -9,14 +9,14 @@ class Vertex {
 public:
     Vertex();
 
-    void AddNeighbor(uint16_t);
-    list<uint16_t>::iterator FindNeighbor(uint16_t idx);
-    list<uint16_t>::iterator EndNeighbor();
-    void RemoveNeighbor(list<uint16_t>::iterator);
-    list<uint16_t> Neighbors();
-    list<uint16_t> *NeighborsPtr();
+    void AddNeighbor(uint32_t);
+    list<uint32_t>::iterator FindNeighbor(uint32_t idx);
+    list<uint32_t>::iterator EndNeighbor();
+    void RemoveNeighbor(list<uint32_t>::iterator);
+    list<uint32_t> Neighbors();
+    list<uint32_t> *NeighborsPtr();
 
 private:
-    list<uint16_t> neighbors; 
+    list<uint32_t> neighbors; 
 };
 
@@ -3,47 +3,246 @@
 **/
 
 #include <iostream>
+#include <stdlib.h>
 #include <string.h>
+#include "BoykovKolmogorov.h"
+#include "GomoryHu.h"
 #include "Graph.h"
+#include "GraphFile.h"
+#include "Matching.h"
+#include "MinCostFlow.h"
+#include "Stats.h"
 #include "Vertex.h"
 
 int problemCount;
 
 // todo add mechanism to switch between two heuristics
 
-uint32_t ReadFlowNetwork(bool runPushRelabel) {
-    uint16_t order, size, source, sink;
+typedef struct Options {
+    bool runPushRelabel, runBoykovKolmogorov, detectMatching, printMatching;
+    uint32_t threads;
+} Options;
+
+/*
+    Prints the max flow value of a network. Unit-capacity bipartite networks are solved as
+    matchings by Hopcroft-Karp (and the matching is printed too if asked for), the rest by
+    Edmond-Karp, push-relabel or Boykov-Kolmogorov. Hopcroft-Karp reads the network in
+    place; Boykov-Kolmogorov builds flat residual arrays from it in one pass, and Edmond-Karp
+    and push-relabel copy it into the maps of a Graph.
+*/
+void MaxFlow(const FlowNetworkView &network, uint32_t source, uint32_t sink, const Options &options) {
+    vector<uint32_t> left;
+    if (options.detectMatching && IsUnitBipartite(network, source, sink, left)) {
+        Matching matching = HopcroftKarp(network, left);
+        std::cout << matching.size << std::endl;
+        if (options.printMatching) {
+            for (vector<pair<uint32_t, uint32_t>>::iterator it = matching.pairs.begin(); it != matching.pairs.end(); it++) {
+                std::cout << it->first << " " << it->second << std::endl;
+            }
+        }
+        return;
+    }
+    if (options.runBoykovKolmogorov) {
+        TerminalNetwork terminals(network);
+        terminals.SetTerminals(source, sink);
+        BoykovKolmogorov<TerminalNetwork> engine(terminals);
+        std::cout << engine.MaxFlow() + terminals.DirectFlow() << std::endl;
+        return;
+    }
+    Graph g(network);
+    if (options.runPushRelabel) {
+        std::cout << g.PushRelabelFlow(source, sink) << std::endl;
+    }
+    else {
+        std::cout << g.EdmondKarp(source, sink) << std::endl;
+    }
+}
+
+// Reads one flow network and prints its max flow value
+void ReadFlowNetwork(const Options &options) {
+    uint32_t order, size, source, sink;
 
     std::cin >> order;
     std::cin >> size;
     std::cin >> source;
     std::cin >> sink;
 
-    Graph g(order);
-    uint16_t v, u;
-    uint32_t c;
-    for (int i = 1; i <= size; i++) {
-        std::cin >> v;
-        std::cin >> u;
-        std::cin >> c;
+    // read every edge first, so that the graph is built in one pass over the sorted list
+    vector<FlowEdge> edges(size);
+    for (uint32_t i = 0; i < size; i++) {
+        std::cin >> edges[i].tail;
+        std::cin >> edges[i].head;
+        std::cin >> edges[i].capacity;
+    }
+    FlowNetwork network = BuildFlowNetwork(order, edges, options.threads);
+    MaxFlow(View(network), source, sink, options);
+}
+
+/*
+    Reads one network whose edges are undirected, and prints the capacity of a minimum cut
+    between every pair of vertices, a row per vertex (0 for a vertex with itself). The
+    source and sink are read but not used.
+*/
+void ReadUndirectedNetwork(const Options &options) {
+    uint32_t order, size, source, sink;
+
+    std::cin >> order;
+    std::cin >> size;
+    std::cin >> source;
+    std::cin >> sink;
 
-        g.AddEdgeNoReversal(v, u, c);
+    vector<FlowEdge> edges(size);
+    for (uint32_t i = 0; i < size; i++) {
+        std::cin >> edges[i].tail;
+        std::cin >> edges[i].head;
+        std::cin >> edges[i].capacity;
+        // one direction per pair, so that edges both ways are merged rather than split
+        if (edges[i].tail > edges[i].head) {
+            std::swap(edges[i].tail, edges[i].head);
+        }
     }
-    
-    if (runPushRelabel) {
-        return g.PushRelabelFlow(source, sink);
+    FlowNetwork network = BuildFlowNetwork(order, edges, options.threads);
+    GomoryHuTree tree(View(network), options.threads);
+    for (uint32_t u = 1; u <= order; u++) {
+        for (uint32_t v = 1; v <= order; v++) {
+            std::cout << (v > 1 ? " " : "") << (u == v ? 0 : tree.MinCut(u, v));
+        }
+        std::cout << std::endl;
     }
-    else {
-        return g.EdmondKarp(source, sink);
+}
+
+/*
+    Reads one flow network whose edges have a cost as a fourth number, and prints the
+    value and cost of its minimum cost maximum flow, then the flow on every edge.
+*/
+void ReadCostNetwork(MinCostAlgorithm algorithm) {
+    uint32_t order, size, source, sink;
+
+    std::cin >> order;
+    std::cin >> size;
+    std::cin >> source;
+    std::cin >> sink;
+
+    vector<CostEdge> edges(size);
+    for (uint32_t i = 0; i < size; i++) {
+        std::cin >> edges[i].tail;
+        std::cin >> edges[i].head;
+        std::cin >> edges[i].capacity;
+        std::cin >> edges[i].cost;
+    }
+    MinCostFlowResult result = CostNetwork(order, edges).Solve(algorithm, source, sink);
+    std::cout << result.flow << " " << result.cost << std::endl;
+    for (uint32_t i = 0; i < size; i++) {
+        std::cout << (i ? " " : "") << result.edgeFlow[i];
     }
+    std::cout << std::endl;
 }
 
 int main(int argc, char *argv[])
 {
+    // -p: push-relabel instead of Edmond-Karp
+    // -b: Boykov-Kolmogorov instead of Edmond-Karp
+    // -e: no Hopcroft-Karp for bipartite matching instances, always Edmond-Karp or push-relabel
+    // -a: print the matching of bipartite matching instances, a left and right vertex per line
+    // -t <threads>: threads for sorting the edges of each network, and max flows run at once by -u
+    // -d: the input is a single DIMACS max flow problem (see ReadDimacs)
+    // -w <file>: with -d, also save the network as a binary graph file
+    // -g <file>: solve the network of a binary graph file instead of reading the input; the
+    //     file is mapped, not parsed, but -b builds its residual arrays from it and Edmond-Karp
+    //     and push-relabel copy it into a Graph (only matching instances run on the mapping)
+    // -m <algorithm>: edges have costs; find minimum cost maximum flows (ssp, scaling, simplex)
+    // -u: edges are undirected; print all-pairs minimum cuts from a Gomory-Hu tree
+    Options options = { false, false, true, false, 1 };
+    bool dimacs = false, minCost = false, allPairs = false;
+    MinCostAlgorithm algorithm = MIN_COST_SSP;
+    const char *writePath = NULL, *graphPath = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-p")) {
+            options.runPushRelabel = true;
+        }
+        else if (!strcmp(argv[i], "-b")) {
+            options.runBoykovKolmogorov = true;
+        }
+        else if (!strcmp(argv[i], "-e")) {
+            options.detectMatching = false;
+        }
+        else if (!strcmp(argv[i], "-a")) {
+            options.printMatching = true;
+        }
+        else if (!strcmp(argv[i], "-u")) {
+            allPairs = true;
+        }
+        else if (!strcmp(argv[i], "-d")) {
+            dimacs = true;
+        }
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            options.threads = std::max(atoi(argv[++i]), 1);
+        }
+        else if (!strcmp(argv[i], "-w") && i + 1 < argc) {
+            writePath = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-g") && i + 1 < argc) {
+            graphPath = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-m") && i + 1 < argc) {
+            const char *name = argv[++i];
+            int k = 0;
+            while (k < MIN_COST_ALGORITHM_COUNT && strcmp(name, minCostAlgorithmNames[k])) {
+                k++;
+            }
+            if (k == MIN_COST_ALGORITHM_COUNT) {
+                std::cerr << "unknown min cost flow algorithm " << name << std::endl;
+                return 1;
+            }
+            algorithm = static_cast<MinCostAlgorithm>(k);
+            minCost = true;
+        }
+    }
+
+    if (graphPath != NULL) {
+        MappedGraphFile file;
+        if (!file.Open(graphPath)) {
+            std::cerr << "cannot load graph file " << graphPath << std::endl;
+            return 1;
+        }
+        STATS_BEGIN();
+        MaxFlow(file.View(), file.Source(), file.Sink(), options);
+        STATS_END("maxflow", 0, 1);
+        return 0;
+    }
+
+    if (dimacs) {
+        uint32_t order, source, sink;
+        vector<FlowEdge> edges;
+        STATS_BEGIN();
+        if (!ReadDimacs(std::cin, order, source, sink, edges)) {
+            std::cerr << "invalid DIMACS max flow problem" << std::endl;
+            return 1;
+        }
+        FlowNetwork network = BuildFlowNetwork(order, edges, options.threads);
+        if (writePath != NULL && !WriteGraphFile(writePath, network, source, sink)) {
+            std::cerr << "cannot write graph file " << writePath << std::endl;
+            return 1;
+        }
+        MaxFlow(View(network), source, sink, options);
+        STATS_END("maxflow", 0, 1);
+        return 0;
+    }
+
     std::cin >> problemCount;
 
     for (int i = 0; i < problemCount; i++) {
-        std::cout << ReadFlowNetwork(argc > 1 && !strcmp(argv[1], "-p")) << std::endl;
+        STATS_BEGIN();
+        if (minCost) {
+            ReadCostNetwork(algorithm);
+        }
+        else if (allPairs) {
+            ReadUndirectedNetwork(options);
+        }
+        else {
+            ReadFlowNetwork(options);
+        }
+        STATS_END("maxflow", i, 1);
     }
 
     return 0;
@@ -0,0 +1,196 @@
+/**
+    Solver statistics: counters, phase timers, allocations and CPU counters as JSON
+**/
+
+#ifdef STATS
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#if defined(STATS_PERF) && defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "Stats.h"
+
+// Most distinct counters and phases; names past these share the last slot
+#define STATS_MAX_COUNTERS 64
+#define STATS_MAX_PHASES 32
+// No CPU counter
+#define NO_PERF_COUNTER (-1)
+
+static StatsCounter counters[STATS_MAX_COUNTERS];
+static StatsPhase phases[STATS_MAX_PHASES];
+static uint32_t counterCount = 0, phaseCount = 0;
+static std::mutex registry;
+
+static std::atomic<uint64_t> allocations(0), allocatedBytes(0);
+static uint64_t startAllocations, startBytes;
+static std::chrono::steady_clock::time_point start;
+
+// Count every heap allocation made through operator new
+void *operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    void *p = std::malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+    std::free(p);
+}
+
+StatsCounter *FindStatsCounter(const char *name) {
+    std::lock_guard<std::mutex> lock(registry);
+    for (uint32_t i = 0; i < counterCount; i++) {
+        if (!strcmp(counters[i].name, name)) {
+            return &counters[i];
+        }
+    }
+    if (counterCount == STATS_MAX_COUNTERS) {
+        counters[STATS_MAX_COUNTERS - 1].name = "other";
+        return &counters[STATS_MAX_COUNTERS - 1];
+    }
+    counters[counterCount].name = name;
+    return &counters[counterCount++];
+}
+
+StatsPhase *FindStatsPhase(const char *name) {
+    std::lock_guard<std::mutex> lock(registry);
+    for (uint32_t i = 0; i < phaseCount; i++) {
+        if (!strcmp(phases[i].name, name)) {
+            return &phases[i];
+        }
+    }
+    if (phaseCount == STATS_MAX_PHASES) {
+        phases[STATS_MAX_PHASES - 1].name = "other";
+        return &phases[STATS_MAX_PHASES - 1];
+    }
+    phases[phaseCount].name = name;
+    return &phases[phaseCount++];
+}
+
+#if defined(STATS_PERF) && defined(__linux__)
+static int perfCycles = NO_PERF_COUNTER, perfCacheMisses = NO_PERF_COUNTER;
+static uint64_t startCycles, startCacheMisses;
+
+/*
+    Opens a hardware counter of user-mode events for this process, inherited by the
+    threads it starts from now on. Returns NO_PERF_COUNTER if the kernel refuses.
+*/
+static int OpenPerfCounter(uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    return fd < 0 ? NO_PERF_COUNTER : static_cast<int>(fd);
+}
+
+static uint64_t ReadPerfCounter(int fd) {
+    uint64_t value = 0;
+    if (fd == NO_PERF_COUNTER || read(fd, &value, sizeof(value)) != sizeof(value)) {
+        return 0;
+    }
+    return value;
+}
+#endif
+
+// Appends "name":value, with null for a counter that could not be read
+static void AppendPerf(std::string &json, const char *name, bool available, uint64_t value) {
+    json += std::string("\"") + name + "\":" + (available ? std::to_string(value) : "null") + ",";
+}
+
+/*
+    Starts an instance: clears every counter and phase, and notes the time, the
+    allocations so far and the CPU counters.
+*/
+void StatsBegin() {
+    std::lock_guard<std::mutex> lock(registry);
+    for (uint32_t i = 0; i < counterCount; i++) {
+        counters[i].value = 0;
+    }
+    for (uint32_t i = 0; i < phaseCount; i++) {
+        phases[i].nanoseconds = 0;
+        phases[i].calls = 0;
+    }
+#if defined(STATS_PERF) && defined(__linux__)
+    static bool opened = false;
+    if (!opened) {
+        perfCycles = OpenPerfCounter(PERF_COUNT_HW_CPU_CYCLES);
+        perfCacheMisses = OpenPerfCounter(PERF_COUNT_HW_CACHE_MISSES);
+        opened = true;
+    }
+    startCycles = ReadPerfCounter(perfCycles);
+    startCacheMisses = ReadPerfCounter(perfCacheMisses);
+#endif
+    startAllocations = allocations.load();
+    startBytes = allocatedBytes.load();
+    start = std::chrono::steady_clock::now();
+}
+
+/*
+    Ends an instance and prints what it counted as one line of JSON on stderr.
+
+    param[in]: instance - index of the instance in the input, or of the first of a batch
+    param[in]: instances - number of instances counted together
+*/
+void StatsEnd(const char *program, uint32_t instance, uint32_t instances) {
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t allocated = allocations.load() - startAllocations, bytes = allocatedBytes.load() - startBytes;
+    char number[32];
+    std::string json = std::string("{\"program\":\"") + program + "\",\"instance\":" + std::to_string(instance) +
+        ",\"instances\":" + std::to_string(instances);
+    snprintf(number, sizeof(number), "%.9g", seconds);
+    json += std::string(",\"seconds\":") + number + ",\"allocations\":" + std::to_string(allocated) +
+        ",\"allocatedBytes\":" + std::to_string(bytes) + ",";
+#if defined(STATS_PERF) && defined(__linux__)
+    AppendPerf(json, "cycles", perfCycles != NO_PERF_COUNTER, ReadPerfCounter(perfCycles) - startCycles);
+    AppendPerf(json, "cacheMisses", perfCacheMisses != NO_PERF_COUNTER,
+        ReadPerfCounter(perfCacheMisses) - startCacheMisses);
+#else
+    AppendPerf(json, "cycles", false, 0);
+    AppendPerf(json, "cacheMisses", false, 0);
+#endif
+
+    std::lock_guard<std::mutex> lock(registry);
+    json += "\"phases\":{";
+    for (uint32_t i = 0; i < phaseCount; i++) {
+        snprintf(number, sizeof(number), "%.9g", phases[i].nanoseconds.load() * 1e-9);
+        json += std::string(i ? "," : "") + "\"" + phases[i].name + "\":{\"seconds\":" + number +
+            ",\"calls\":" + std::to_string(phases[i].calls.load()) + "}";
+    }
+    json += "},\"counters\":{";
+    for (uint32_t i = 0; i < counterCount; i++) {
+        json += std::string(i ? "," : "") + "\"" + counters[i].name + "\":" + std::to_string(counters[i].value.load());
+    }
+    json += "}}\n";
+    fputs(json.c_str(), stderr);
+}
+#endif